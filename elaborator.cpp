@@ -1,19 +1,49 @@
 #include "elaborator.h"
+#include "systemrdl_flat.h"
+#include "systemrdl_memory.h"
+#include "systemrdl_path.h"
+#include "systemrdl_trace.h"
 #include <algorithm>
+#include <atomic>
 #include <climits>
+#include <cstdlib>
+#include <future>
 #include <map>
 #include <set>
 #include <sstream>
+#include <thread>
 
 namespace systemrdl {
 
+namespace {
+
+// Instance path for trace spans; only evaluated while tracing is enabled
+std::string trace_instance_path(const ElaboratedNode *parent, const std::string &inst_name)
+{
+    return parent ? parent->get_hierarchical_path() + "." + inst_name : inst_name;
+}
+
+// Properties SystemRDL does not allow in dynamic assignments: they fix the layout or the
+// addressing of a component, which is already computed when the assignment is applied
+bool is_non_dynamic_property(const std::string &name)
+{
+    static const std::set<std::string> properties = {
+        "addressing", "alignment", "bigendian", "errextbus", "fieldwidth", "littleendian",
+        "lsb0", "mementries", "memwidth", "msb0", "regwidth", "rsvdset", "rsvdsetX", "shared",
+        "sharedextbus", "signalwidth"};
+    return properties.count(name) > 0;
+}
+
+} // namespace
+
 // ElaboratedNode implementation
 std::string ElaboratedNode::get_hierarchical_path() const
 {
-    if (parent == nullptr) {
-        return inst_name;
-    }
-    return parent->get_hierarchical_path() + "." + inst_name;
+    return join_path(
+        this,
+        static_cast<const ElaboratedNode *>(nullptr),
+        [](const ElaboratedNode *node) -> const std::string & { return node->inst_name; },
+        [](const ElaboratedNode *node) -> const ElaboratedNode * { return node->parent; });
 }
 
 void ElaboratedNode::add_child(std::unique_ptr<ElaboratedNode> child)
@@ -91,6 +121,18 @@ void ElaboratedReg::accept_visitor(ElaboratedNodeVisitor &visitor)
     visitor.visit(*this);
 }
 
+uint64_t ElaboratedReg::reset_low64() const
+{
+    if (register_reset_hex.size() <= 2) {
+        return 0;
+    }
+    std::string digits = register_reset_hex.substr(2);
+    if (digits.size() > 16) {
+        digits = digits.substr(digits.size() - 16);
+    }
+    return std::strtoull(digits.c_str(), nullptr, 16);
+}
+
 ElaboratedField *ElaboratedReg::find_field_by_name(const std::string &name) const
 {
     for (const auto &child : children) {
@@ -154,59 +196,162 @@ SystemRDLElaborator::~SystemRDLElaborator() = default;
 std::unique_ptr<ElaboratedAddrmap> SystemRDLElaborator::elaborate(
     SystemRDLParser::RootContext *ast_root)
 {
+    trace::Span span("elaborate", "elaborate");
+
     errors_.clear();
+    error_index_by_location_.clear();
+    error_index_by_message_.clear();
+    suppressed_errors_ = 0;
+    aborted_           = false;
     component_definitions_.clear();
     enum_definitions_.clear();
     struct_definitions_.clear();
+    pending_enum_defs_.clear();
+    pending_struct_defs_.clear();
+    definition_stats_ = DefinitionStats{};
+    library_lookups_.clear();
+    library_trees_.clear();
+    current_parameter_values_.clear();
+    streamed_leaves_.clear();
+    deferred_bodies_.clear();
+    failed_bodies_.clear();
+    previous_instance_ = nullptr;
+    pending_assignments_.clear();
+    assignment_scopes_.clear();
+    path_segment_ids_.clear();
+    child_indexes_.clear();
+    streamed_nodes_   = 0;
+    nodes_elaborated_ = 0;
+    limit_checks_     = 0;
+    next_progress_    = options_.progress_interval;
+    start_time_       = std::chrono::steady_clock::now();
+
+    try {
+        auto elaborated = elaborate_root(ast_root);
+        if (elaborated && span.active()) {
+            span.add_arg("top", elaborated->inst_name);
+        }
+        return elaborated;
+    } catch (const ElaborationAborted &) {
+        aborted_ = true;
+        return nullptr;
+    }
+}
 
+std::unique_ptr<ElaboratedAddrmap> SystemRDLElaborator::elaborate_root(
+    SystemRDLParser::RootContext *ast_root)
+{
     if (!ast_root) {
-        report_error("AST root is null");
+        report_error("AST root is null", nullptr, "internal");
         return nullptr;
     }
 
-    // First pass: collect enum and struct definitions
-    collect_enum_and_struct_definitions(ast_root);
+    {
+        trace::Span collect_span("collect_definitions", "elaborate");
+
+        // Included files first, so the main file can refer to and redefine their contents
+        for (auto library : library_roots_) {
+            collect_enum_and_struct_definitions(library);
+            collect_component_definitions(library);
+        }
+
+        // First pass: collect enum and struct definitions
+        collect_enum_and_struct_definitions(ast_root);
+
+        // Second pass: collect all named component definitions (recursive)
+        collect_component_definitions(ast_root);
+    }
+
+    // Third pass: find top-level addrmap definition and elaborate; the main file is searched
+    // before the included ones
+    auto named_def = find_top_addrmap(ast_root);
+    for (auto it = library_roots_.rbegin(); !named_def && it != library_roots_.rend(); ++it) {
+        named_def = find_top_addrmap(*it);
+    }
+    if (!named_def && !options_.top.empty() && load_library_definition(options_.top)) {
+        // A selected top may come from a precompiled library
+        for (const auto &library : options_.definition_libraries) {
+            if (auto tree = library->find_definition(options_.top)) {
+                named_def = find_top_addrmap(tree);
+                break;
+            }
+        }
+    }
+
+    if (named_def) {
+        auto elaborated              = std::make_unique<ElaboratedAddrmap>();
+        elaborated->inst_name        = named_def->ID()->getText();
+        elaborated->type_name        = "addrmap";
+        elaborated->absolute_address = 0;
 
-    // Second pass: collect all named component definitions (recursive)
-    collect_component_definitions(ast_root);
+        // Process addrmap content
+        if (auto body = named_def->component_body()) {
+            elaborate_component_body(body, elaborated.get());
+        }
+
+        // Validate instance addresses after elaboration is complete; in
+        // streaming mode nested containers were validated as they completed
+        if (options_.stream_sink) {
+            validate_container_addresses(elaborated.get());
+        } else {
+            trace::Span validate_span("validate_instance_addresses", "validate");
+            validate_instance_addresses(elaborated.get());
+        }
+
+        return elaborated;
+    }
+
+    if (!options_.top.empty()) {
+        report_error(
+            "Top-level addrmap '" + options_.top + "' not found", nullptr, "no-top-addrmap");
+        return nullptr;
+    }
+    report_error("No top-level addrmap found", nullptr, "no-top-addrmap");
+    return nullptr;
+}
 
-    // Third pass: find top-level addrmap definition and elaborate
+SystemRDLParser::Component_named_defContext *SystemRDLElaborator::find_top_addrmap(
+    SystemRDLParser::RootContext *ast_root) const
+{
     for (auto root_elem : ast_root->root_elem()) {
         if (auto comp_def = root_elem->component_def()) {
             if (auto named_def = comp_def->component_named_def()) {
                 if (auto addrmap_def = named_def->component_type()->component_type_primary()) {
-                    if (addrmap_def->getText() == "addrmap") {
-                        // Found addrmap definition, start elaboration
-                        auto elaborated              = std::make_unique<ElaboratedAddrmap>();
-                        elaborated->inst_name        = named_def->ID()->getText();
-                        elaborated->type_name        = "addrmap";
-                        elaborated->absolute_address = 0;
-
-                        // Process addrmap content
-                        if (auto body = named_def->component_body()) {
-                            elaborate_component_body(body, elaborated.get());
-                        }
-
-                        // Validate instance addresses after elaboration is complete
-                        validate_instance_addresses(elaborated.get());
-
-                        return elaborated;
+                    bool selected = options_.top.empty()
+                                    || named_def->ID()->getText() == options_.top;
+                    if (addrmap_def->getText() == "addrmap" && selected) {
+                        return named_def;
                     }
                 }
             }
         }
     }
-
-    report_error("No top-level addrmap found");
     return nullptr;
 }
 
 void SystemRDLElaborator::elaborate_component_body(
     SystemRDLParser::Component_bodyContext *body_ctx, ElaboratedNode *parent)
 {
-    Address current_address = 0;
+    Address                        current_address = 0;
+    std::vector<DynamicAssignment> dynamic_assignments;
+    ElaboratedNode                *enclosing_previous = previous_instance_;
+    previous_instance_                                = nullptr;
+
+    // Streaming mode: collect the assignments before the instances, whose registers are
+    // released as they are attached (see apply_enclosing_assignments)
+    const bool streaming = options_.stream_sink != nullptr;
+    if (streaming) {
+        for (auto body_elem : body_ctx->component_body_elem()) {
+            if (auto dynamic_prop = body_elem->dynamic_property_assignment()) {
+                elaborate_dynamic_property_assignment(dynamic_prop, dynamic_assignments);
+            }
+        }
+        assignment_scopes_.push_back({parent, &dynamic_assignments});
+    }
 
     for (auto body_elem : body_ctx->component_body_elem()) {
+        check_limits(parent);
+
         if (auto comp_def = body_elem->component_def()) {
             // Process component definitions and instantiation
             elaborate_component_definition(comp_def, parent, current_address);
@@ -218,9 +363,135 @@ void SystemRDLElaborator::elaborate_component_body(
             elaborate_local_property_assignment(local_prop, parent);
         } else if (auto dynamic_prop = body_elem->dynamic_property_assignment()) {
             // Process dynamic property assignment
-            elaborate_dynamic_property_assignment(dynamic_prop, parent);
+            if (!streaming) {
+                elaborate_dynamic_property_assignment(dynamic_prop, dynamic_assignments);
+            }
         }
     }
+
+    // What reached a streamed register was applied on attach; the rest targets this body's
+    // containers, or nothing
+    if (streaming) {
+        assignment_scopes_.pop_back();
+        dynamic_assignments.erase(
+            std::remove_if(
+                dynamic_assignments.begin(),
+                dynamic_assignments.end(),
+                [](const DynamicAssignment &assignment) { return assignment.streamed; }),
+            dynamic_assignments.end());
+    }
+    apply_dynamic_assignments(parent, dynamic_assignments);
+    previous_instance_ = enclosing_previous;
+}
+
+void SystemRDLElaborator::elaborate_instance_body(
+    SystemRDLParser::Component_bodyContext *body_ctx,
+    ElaboratedNode                         *node,
+    ElaboratedNode                         *parent,
+    bool                                    layout_known)
+{
+    // Streamed registers are released before their container is attached, so link it now for
+    // the sink to see complete hierarchical paths
+    if (options_.stream_sink) {
+        node->parent = parent;
+    }
+
+    // Only defer when the instance's own address does not depend on its size; a later sibling
+    // placed after it elaborates the body first (see settle_size)
+    bool container = dynamic_cast<ElaboratedAddrmap *>(node)
+                     || dynamic_cast<ElaboratedRegfile *>(node);
+    if (options_.lazy && !options_.stream_sink && layout_known && container) {
+        deferred_bodies_[node] = {body_ctx, current_parameter_values_};
+        return;
+    }
+
+    elaborate_component_body(body_ctx, node);
+}
+
+// Elaborate the deferred register files under a node and update the sizes that depend on them;
+// true if the node's size may have changed. Address maps have a fixed size and are left deferred.
+bool SystemRDLElaborator::settle_size(ElaboratedNode *node)
+{
+    if (!dynamic_cast<ElaboratedRegfile *>(node)) {
+        return false;
+    }
+    bool changed = deferred_bodies_.count(node) > 0;
+    if (changed) {
+        materialize(node);
+    }
+    for (const auto &child : node->children) {
+        changed = settle_size(child.get()) || changed;
+    }
+    if (changed) {
+        calculate_node_size(node);
+    }
+    return changed;
+}
+
+bool SystemRDLElaborator::materialize(ElaboratedNode *node)
+{
+    // A body that failed once keeps failing, aborted or not
+    if (failed_bodies_.count(node)) {
+        return false;
+    }
+    auto it = deferred_bodies_.find(node);
+    if (it == deferred_bodies_.end()) {
+        return true;
+    }
+
+    trace::Span span("materialize", "elaborate");
+    if (span.active()) {
+        span.add_arg("path", node->get_hierarchical_path());
+    }
+
+    DeferredBody deferred = std::move(it->second);
+    deferred_bodies_.erase(it);
+
+    // Restore the parameter context of the instantiation
+    auto saved_parameters     = std::move(current_parameter_values_);
+    current_parameter_values_ = std::move(deferred.parameters);
+
+    const size_t errors_before = errors_.size();
+    bool         aborted       = false;
+    try {
+        elaborate_component_body(deferred.body, node);
+
+        // Assignments of enclosing bodies come after the node's own ones
+        auto pending = pending_assignments_.find(node);
+        if (pending != pending_assignments_.end()) {
+            auto assignments = std::move(pending->second);
+            pending_assignments_.erase(pending);
+            apply_dynamic_assignments(node, assignments);
+        }
+
+        // A register file's extent covers its nested register files, so they cannot stay deferred
+        if (dynamic_cast<ElaboratedRegfile *>(node)) {
+            for (const auto &child : node->children) {
+                settle_size(child.get());
+            }
+        }
+        calculate_node_size(node);
+        validate_instance_addresses(node);
+
+        // The real size is known now, so check the node against its siblings again
+        if (node->parent) {
+            std::vector<PendingError> pending;
+            check_instance_address_overlaps(node->parent, pending);
+            for (const auto &error : pending) {
+                report_error(error.message, error.ctx, error.code);
+            }
+        }
+    } catch (const ElaborationAborted &) {
+        aborted_ = true;
+        aborted  = true;
+    }
+
+    current_parameter_values_ = std::move(saved_parameters);
+    if (errors_.size() != errors_before || aborted) {
+        failed_bodies_.insert(node);
+        return false;
+    }
+    return true;
 }
 
 void SystemRDLElaborator::elaborate_component_definition(
@@ -254,7 +525,13 @@ void SystemRDLElaborator::elaborate_component_instance(
     if (!array_suffixes.empty()) {
         elaborate_array_instance(def_ctx, inst_ctx, parent, current_address, comp_type);
     } else {
-        // Single instance
+        // Single instance; fields are too fine-grained to be worth a span each
+        trace::Span span("elaborate_component_instance", "elaborate", comp_type != "field");
+        if (span.active()) {
+            span.add_arg("path", trace_instance_path(parent, inst_name));
+            span.add_arg("type", comp_type);
+        }
+
         auto node = create_elaborated_node(comp_type);
         if (!node)
             return;
@@ -264,10 +541,7 @@ void SystemRDLElaborator::elaborate_component_instance(
         node->source_ctx = inst_ctx; // Save source context for error reporting
 
         // Calculate address
-        Address instance_address = current_address;
-        if (auto fixed_addr = inst_ctx->inst_addr_fixed()) {
-            instance_address = evaluate_address_expression(fixed_addr->expr());
-        }
+        Address instance_address = instance_base_address(inst_ctx, current_address);
 
         node->absolute_address = parent->absolute_address + instance_address;
 
@@ -280,17 +554,22 @@ void SystemRDLElaborator::elaborate_component_instance(
 
         // Process component body
         if (auto body = def_ctx->component_body()) {
-            elaborate_component_body(body, node.get());
+            elaborate_instance_body(
+                body, node.get(), parent, inst_ctx->inst_addr_fixed() != nullptr);
         }
 
         // Calculate size
         calculate_node_size(node.get());
 
         // Save size, because node is about to be moved
-        Size node_size = node->size;
+        Size            node_size = node->size;
+        ElaboratedNode *placed    = node.get();
 
-        parent->add_child(std::move(node));
+        attach_child(parent, std::move(node));
         current_address = instance_address + node_size;
+        if (!deferred_bodies_.empty()) {
+            previous_instance_ = placed;
+        }
     }
 }
 
@@ -303,6 +582,8 @@ void SystemRDLElaborator::elaborate_array_instance(
 {
     std::string base_name = inst_ctx->ID()->getText();
 
+    trace::Span span("elaborate_array_instance", "elaborate");
+
     // Parse array dimensions
     auto                array_suffixes = inst_ctx->array_suffix();
     std::vector<size_t> dimensions;
@@ -319,10 +600,7 @@ void SystemRDLElaborator::elaborate_array_instance(
     }
 
     // Calculate base address
-    Address base_address = current_address;
-    if (auto fixed_addr = inst_ctx->inst_addr_fixed()) {
-        base_address = evaluate_address_expression(fixed_addr->expr());
-    }
+    Address base_address = instance_base_address(inst_ctx, current_address);
 
     // Calculate stride
     Address stride = 4; // Default 4-byte alignment
@@ -330,8 +608,18 @@ void SystemRDLElaborator::elaborate_array_instance(
         stride = evaluate_address_expression(stride_addr->expr());
     }
 
+    if (span.active()) {
+        span.add_arg("path", trace_instance_path(parent, base_name));
+        span.add_arg("count", std::to_string(dimensions[0]));
+    }
+
+    // A mistyped array size must not allocate millions of nodes before a limit is noticed
+    check_array_limit(dimensions[0], inst_ctx);
+
     // Generate array instances
     for (size_t i = 0; i < dimensions[0]; ++i) {
+        check_limits(parent);
+
         auto node = create_elaborated_node(comp_type);
         if (!node)
             continue;
@@ -352,11 +640,11 @@ void SystemRDLElaborator::elaborate_array_instance(
 
         // Process component body
         if (auto body = def_ctx->component_body()) {
-            elaborate_component_body(body, node.get());
+            elaborate_instance_body(body, node.get(), parent, true);
         }
 
         calculate_node_size(node.get());
-        parent->add_child(std::move(node));
+        attach_child(parent, std::move(node));
     }
 
     current_address = base_address + dimensions[0] * stride;
@@ -364,6 +652,8 @@ void SystemRDLElaborator::elaborate_array_instance(
 
 std::unique_ptr<ElaboratedNode> SystemRDLElaborator::create_elaborated_node(const std::string &type)
 {
+    nodes_elaborated_++;
+
     if (type == "addrmap") {
         return std::make_unique<ElaboratedAddrmap>();
     } else if (type == "regfile") {
@@ -376,7 +666,7 @@ std::unique_ptr<ElaboratedNode> SystemRDLElaborator::create_elaborated_node(cons
         return std::make_unique<ElaboratedMem>();
     }
 
-    report_error("Unknown component type: " + type);
+    report_error("Unknown component type: " + type, nullptr, "unknown-component-type");
     return nullptr;
 }
 
@@ -388,6 +678,37 @@ std::string SystemRDLElaborator::get_component_type(SystemRDLParser::Component_t
     return "unknown";
 }
 
+Address SystemRDLElaborator::instance_base_address(
+    SystemRDLParser::Component_instContext *inst_ctx, Address current_address)
+{
+    ElaboratedNode *previous = previous_instance_;
+    previous_instance_       = nullptr;
+
+    if (auto fixed_addr = inst_ctx->inst_addr_fixed()) {
+        return evaluate_address_expression(fixed_addr->expr());
+    }
+
+    // Lazy mode: the previous instance may still have its placeholder size
+    if (previous && settle_size(previous)) {
+        current_address = previous->absolute_address - previous->parent->absolute_address
+                          + previous->size;
+    }
+
+    // Without @ the instance follows the previous one, raised to the %= alignment
+    if (auto align_addr = inst_ctx->inst_addr_align()) {
+        Address alignment = evaluate_address_expression(align_addr->expr());
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            report_error(
+                "Instance alignment must be a power of two: " + align_addr->expr()->getText(),
+                align_addr,
+                "invalid-alignment");
+            return current_address;
+        }
+        return (current_address + alignment - 1) & ~(alignment - 1);
+    }
+    return current_address;
+}
+
 Address SystemRDLElaborator::evaluate_address_expression(SystemRDLParser::ExprContext *expr_ctx)
 {
     // Use enhanced expression evaluator
@@ -448,6 +769,12 @@ void SystemRDLElaborator::calculate_node_size(ElaboratedNode *node)
                 max_addr = child_end;
             }
         }
+        auto streamed = streamed_leaves_.find(regfile_node);
+        if (streamed != streamed_leaves_.end()) {
+            for (const auto &leaf : streamed->second) {
+                max_addr = std::max(max_addr, leaf.address + leaf.size);
+            }
+        }
         regfile_node->size = max_addr - regfile_node->absolute_address;
         if (regfile_node->size == 0) {
             regfile_node->size = 4; // Minimum size
@@ -583,39 +910,295 @@ void SystemRDLElaborator::validate_register_reset_value(ElaboratedReg *reg_node)
     // Check if any field reset values exceed their bit width
     for (const auto &child : reg_node->children) {
         if (auto field = dynamic_cast<ElaboratedField *>(child.get())) {
-            // Skip reserved fields (auto-generated)
-            auto reserved_prop = field->get_property("reserved");
-            if (reserved_prop && reserved_prop->type == PropertyValue::BOOLEAN
-                && reserved_prop->bool_val) {
-                continue;
-            }
+            validate_field_reset_value(field, field->source_ctx);
+        }
+    }
+}
 
-            // Calculate maximum value for field width
-            size_t field_width = field->msb - field->lsb + 1;
-            if (field_width < 64) { // Avoid overflow for very large fields
-                uint64_t max_field_value = (1ULL << field_width) - 1;
-                if (field->reset_value > max_field_value) {
-                    report_error(
-                        "Field '" + field->inst_name + "' reset value "
-                            + std::to_string(field->reset_value) + " exceeds maximum value "
-                            + std::to_string(max_field_value) + " for "
-                            + std::to_string(field_width) + "-bit field",
-                        field->source_ctx);
-                }
-            }
+// Check that a field's reset value fits its width; the error is reported at ctx
+void SystemRDLElaborator::validate_field_reset_value(
+    ElaboratedField *field, antlr4::ParserRuleContext *ctx)
+{
+    // Skip reserved fields (auto-generated)
+    auto reserved_prop = field->get_property("reserved");
+    if (reserved_prop && reserved_prop->type == PropertyValue::BOOLEAN
+        && reserved_prop->bool_val) {
+        return;
+    }
+
+    // Calculate maximum value for field width
+    size_t field_width = field->msb - field->lsb + 1;
+    if (field_width < 64) { // Avoid overflow for very large fields
+        uint64_t max_field_value = (1ULL << field_width) - 1;
+        if (field->reset_value > max_field_value) {
+            report_error(
+                "Field '" + field->inst_name + "' reset value "
+                    + std::to_string(field->reset_value) + " exceeds maximum value "
+                    + std::to_string(max_field_value) + " for " + std::to_string(field_width)
+                    + "-bit field",
+                ctx,
+                "reset-value-overflow");
         }
     }
 }
 
-void SystemRDLElaborator::report_error(const std::string &message, antlr4::ParserRuleContext *ctx)
+void SystemRDLElaborator::report_error(
+    const std::string &message, antlr4::ParserRuleContext *ctx, const char *code)
 {
     ElaborationError error;
     error.message = message;
+    error.code    = code;
     if (ctx) {
         error.line   = ctx->getStart()->getLine();
         error.column = ctx->getStart()->getCharPositionInLine();
+        auto source  = ctx->getStart()->getTokenSource();
+        if (source && source->getSourceName() != antlr4::IntStream::UNKNOWN_SOURCE_NAME) {
+            error.file = source->getSourceName();
+        }
     }
+
+    // Cascading errors tend to hit the same source location many times; count them instead.
+    // Different checks failing at one location are reported separately.
+    const size_t next_index = errors_.size();
+    size_t       index;
+    if (ctx) {
+        ErrorLocation location{error.file, error.line, error.column, error.code};
+        index = error_index_by_location_.emplace(std::move(location), next_index).first->second;
+    } else {
+        index = error_index_by_message_.emplace(message, next_index).first->second;
+    }
+
+    if (index != next_index) {
+        errors_[index].count++;
+        suppressed_errors_++;
+        return;
+    }
+
     errors_.push_back(error);
+
+    if (options_.fail_fast || (options_.max_errors > 0 && errors_.size() >= options_.max_errors)) {
+        throw ElaborationAborted{};
+    }
+}
+
+void SystemRDLElaborator::abort_elaboration(
+    const std::string &message, antlr4::ParserRuleContext *ctx, const char *code)
+{
+    report_error(message, ctx, code);
+    throw ElaborationAborted{};
+}
+
+void SystemRDLElaborator::check_limits(const ElaboratedNode *parent)
+{
+    // Cheap checks run every time
+    if (options_.cancel_token.is_cancelled()) {
+        abort_elaboration("Elaboration cancelled", nullptr, "cancelled");
+    }
+    if (options_.max_nodes > 0 && nodes_elaborated_ > options_.max_nodes) {
+        abort_elaboration(
+            "Elaboration exceeded the limit of " + std::to_string(options_.max_nodes) + " nodes",
+            nullptr,
+            "node-limit");
+    }
+
+    // Reading the clock and the resident set size is comparatively expensive
+    constexpr size_t slow_check_interval = 256;
+    if (++limit_checks_ % slow_check_interval != 0) {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time_);
+    if (options_.timeout.count() > 0 && elapsed > options_.timeout) {
+        abort_elaboration(
+            "Elaboration timed out after " + std::to_string(options_.timeout.count()) + " ms",
+            nullptr,
+            "timeout");
+    }
+
+    if (options_.max_memory_bytes > 0) {
+        uint64_t rss = memory::current_rss_bytes();
+        if (rss > options_.max_memory_bytes) {
+            abort_elaboration(
+                "Elaboration exceeded the memory limit: " + std::to_string(rss) + " > "
+                    + std::to_string(options_.max_memory_bytes) + " bytes resident",
+                nullptr,
+                "memory-limit");
+        }
+    }
+
+    if (options_.progress_callback && options_.progress_interval > 0
+        && nodes_elaborated_ >= next_progress_) {
+        next_progress_ = nodes_elaborated_ + options_.progress_interval;
+
+        ElaborationProgress progress;
+        progress.nodes_elaborated = nodes_elaborated_;
+        progress.current_path     = parent ? parent->get_hierarchical_path() : "";
+        progress.elapsed          = elapsed;
+        options_.progress_callback(progress);
+    }
+}
+
+void SystemRDLElaborator::check_array_limit(
+    size_t elements, SystemRDLParser::Component_instContext *inst_ctx)
+{
+    if (options_.max_nodes == 0) {
+        return;
+    }
+
+    size_t remaining = options_.max_nodes > nodes_elaborated_
+                           ? options_.max_nodes - nodes_elaborated_
+                           : 0;
+    if (elements > remaining) {
+        abort_elaboration(
+            "Array '" + inst_ctx->ID()->getText() + "' has " + std::to_string(elements)
+                + " elements, exceeding the limit of " + std::to_string(options_.max_nodes)
+                + " nodes",
+            inst_ctx,
+            "node-limit");
+    }
+}
+
+// LazyElaboratedModel implementation
+LazyElaboratedModel::LazyElaboratedModel(SystemRDLElaborator::Options options)
+{
+    options.lazy = true;
+    elaborator_.set_options(options);
+}
+
+bool LazyElaboratedModel::open(
+    SystemRDLParser::RootContext               *ast_root,
+    std::vector<SystemRDLParser::RootContext *> library_roots)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    elaborator_.set_library_roots(std::move(library_roots));
+    root_ = elaborator_.elaborate(ast_root);
+    return root_ && !elaborator_.has_errors();
+}
+
+ElaboratedAddrmap *LazyElaboratedModel::root() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return root_.get();
+}
+
+bool LazyElaboratedModel::materialize(ElaboratedNode *node)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return materialize_locked(node) != nullptr;
+}
+
+bool LazyElaboratedModel::is_materialized(const ElaboratedNode *node) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !elaborator_.is_deferred(node);
+}
+
+std::vector<SystemRDLElaborator::ElaborationError> LazyElaboratedModel::get_errors() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return elaborator_.get_errors();
+}
+
+ElaboratedNode *LazyElaboratedModel::materialize_locked(ElaboratedNode *node)
+{
+    if (!node || !elaborator_.materialize(node)) {
+        return nullptr;
+    }
+    return node;
+}
+
+Address LazyElaboratedModel::span_end(ElaboratedNode *node)
+{
+    Address end = node->absolute_address + node->size;
+    if (!materialize_locked(node) || dynamic_cast<ElaboratedReg *>(node)
+        || dynamic_cast<ElaboratedMem *>(node)) {
+        return end;
+    }
+
+    // Addrmaps keep a placeholder size, so follow the last child down; siblings never overlap,
+    // so the child starting last also ends last
+    ElaboratedNode *last = nullptr;
+    for (const auto &child : node->children) {
+        if (dynamic_cast<ElaboratedField *>(child.get())) {
+            continue;
+        }
+        if (!last || child->absolute_address >= last->absolute_address) {
+            last = child.get();
+        }
+    }
+    return last ? std::max(end, span_end(last)) : end;
+}
+
+ElaboratedNode *LazyElaboratedModel::find_by_path(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!root_) {
+        return nullptr;
+    }
+
+    std::stringstream stream(path);
+    std::string       name;
+    if (!std::getline(stream, name, '.') || name != root_->inst_name) {
+        return nullptr;
+    }
+
+    // Only the nodes along the path are materialized
+    ElaboratedNode *node = root_.get();
+    while (std::getline(stream, name, '.')) {
+        if (!materialize_locked(node)) {
+            return nullptr;
+        }
+
+        ElaboratedNode *next = nullptr;
+        for (const auto &child : node->children) {
+            if (child->inst_name == name) {
+                next = child.get();
+                break;
+            }
+        }
+        if (!next) {
+            return nullptr;
+        }
+        node = next;
+    }
+    return materialize_locked(node);
+}
+
+ElaboratedNode *LazyElaboratedModel::find_by_address(Address address)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!root_) {
+        return nullptr;
+    }
+
+    ElaboratedNode *node = root_.get();
+    while (true) {
+        if (!materialize_locked(node)) {
+            return nullptr;
+        }
+
+        // Sizes of deferred siblings are placeholders, so pick the closest instance starting
+        // at or below the address and check containment once it is materialized
+        ElaboratedNode *candidate = nullptr;
+        for (const auto &child : node->children) {
+            if (dynamic_cast<ElaboratedField *>(child.get()) || child->absolute_address > address) {
+                continue;
+            }
+            if (!candidate || child->absolute_address >= candidate->absolute_address) {
+                candidate = child.get();
+            }
+        }
+
+        if (!candidate || !materialize_locked(candidate) || address >= span_end(candidate)) {
+            return node;
+        }
+        if (candidate->children.empty() || dynamic_cast<ElaboratedReg *>(candidate)
+            || dynamic_cast<ElaboratedMem *>(candidate)) {
+            return candidate;
+        }
+        node = candidate;
+    }
 }
 
 // ElaboratedModelTraverser implementation
@@ -663,61 +1246,25 @@ void ElaboratedModelTraverser::visit(ElaboratedMem &node)
 std::vector<AddressMapGenerator::AddressEntry> AddressMapGenerator::generate_address_map(
     ElaboratedAddrmap &root)
 {
-    address_map_.clear();
-    traverse(root);
-
-    // Sort by address
-    std::sort(
-        address_map_.begin(), address_map_.end(), [](const AddressEntry &a, const AddressEntry &b) {
-            return a.address < b.address;
-        });
-
-    return address_map_;
-}
-
-void AddressMapGenerator::visit(ElaboratedRegfile &node)
-{
-    AddressEntry entry;
-    entry.address = node.absolute_address;
-    entry.size    = node.size;
-    entry.name    = node.inst_name;
-    entry.path    = node.get_hierarchical_path();
-    entry.type    = node.get_node_type();
-
-    address_map_.push_back(entry);
-
-    // Continue traversing child nodes
-    ElaboratedModelTraverser::visit(node);
-}
-
-void AddressMapGenerator::visit(ElaboratedReg &node)
-{
-    AddressEntry entry;
-    entry.address = node.absolute_address;
-    entry.size    = node.size;
-    entry.name    = node.inst_name;
-    entry.path    = node.get_hierarchical_path();
-    entry.type    = node.get_node_type();
-
-    address_map_.push_back(entry);
-
-    // Continue traversing child nodes
-    ElaboratedModelTraverser::visit(node);
-}
-
-void AddressMapGenerator::visit(ElaboratedMem &node)
-{
-    AddressEntry entry;
-    entry.address = node.absolute_address;
-    entry.size    = node.size;
-    entry.name    = node.inst_name;
-    entry.path    = node.get_hierarchical_path();
-    entry.type    = node.get_node_type();
+    FlatModel flat(root);
 
-    address_map_.push_back(entry);
+    auto rows = flat.sorted_by_address(flat.filter([&flat](uint32_t row) {
+        auto kind = flat.kind()[row];
+        return kind == FlatModel::REGFILE || kind == FlatModel::REG || kind == FlatModel::MEM;
+    }));
 
-    // Continue traversing child nodes
-    ElaboratedModelTraverser::visit(node);
+    std::vector<AddressEntry> address_map;
+    address_map.reserve(rows.size());
+    for (auto row : rows) {
+        AddressEntry entry;
+        entry.address = flat.address()[row];
+        entry.size    = flat.size_column()[row];
+        entry.name    = flat.name_of(row);
+        entry.path    = flat.path(row);
+        entry.type    = FlatModel::kind_name(flat.kind()[row]);
+        address_map.push_back(std::move(entry));
+    }
+    return address_map;
 }
 
 // New method implementation
@@ -760,18 +1307,43 @@ void SystemRDLElaborator::register_component_definition(
 {
     std::string comp_name = named_def->ID()->getText();
     std::string comp_type = get_component_type(named_def->component_type());
+    if (collecting_library_ && component_definitions_.count(comp_name)) {
+        return;
+    }
 
+    // Only index the definition; parameters are parsed if an instance needs it
     ComponentDefinition def;
     def.name    = comp_name;
     def.type    = comp_type;
     def.def_ctx = named_def;
 
-    // Parse parameter definitions
-    if (auto param_def = named_def->param_def()) {
-        def.parameters = parse_parameter_definitions(param_def);
+    component_definitions_[comp_name] = def;
+    definition_stats_.indexed++;
+}
+
+const SystemRDLElaborator::ComponentDefinition *SystemRDLElaborator::find_component_definition(
+    const std::string &name)
+{
+    auto it = component_definitions_.find(name);
+    if (it == component_definitions_.end()) {
+        if (!load_library_definition(name)) {
+            return nullptr;
+        }
+        it = component_definitions_.find(name);
+        if (it == component_definitions_.end()) {
+            return nullptr;
+        }
     }
 
-    component_definitions_[comp_name] = def;
+    ComponentDefinition &def = it->second;
+    if (!def.analysed) {
+        def.analysed = true;
+        definition_stats_.analysed++;
+        if (auto param_def = def.def_ctx->param_def()) {
+            def.parameters = parse_parameter_definitions(param_def);
+        }
+    }
+    return &def;
 }
 
 void SystemRDLElaborator::elaborate_explicit_component_inst(
@@ -782,13 +1354,30 @@ void SystemRDLElaborator::elaborate_explicit_component_inst(
     std::string type_name = explicit_inst->ID()->getText();
 
     // Find named component definition
-    auto it = component_definitions_.find(type_name);
-    if (it == component_definitions_.end()) {
-        report_error("Undefined component type: " + type_name, explicit_inst);
+    const ComponentDefinition *definition = find_component_definition(type_name);
+    auto                       linked     = options_.linked_blocks.find(type_name);
+    bool                       has_params = explicit_inst->component_insts()->param_inst();
+    if (linked != options_.linked_blocks.end() && !(definition && has_params)) {
+        // A linked model replaces the definition, except where parameters need a new elaboration
+        if (has_params) {
+            report_error(
+                "Parameters cannot be applied to linked block: " + type_name,
+                explicit_inst,
+                "linked-block");
+            return;
+        }
+        for (auto inst : explicit_inst->component_insts()->component_inst()) {
+            elaborate_linked_block_instance(
+                type_name, linked->second, inst, parent, current_address);
+        }
+        return;
+    }
+    if (!definition) {
+        report_error("Undefined component type: " + type_name, explicit_inst, "undefined-component");
         return;
     }
 
-    const ComponentDefinition &comp_def = it->second;
+    const ComponentDefinition &comp_def = *definition;
 
     // Process parameter instantiation
     std::vector<ParameterAssignment> param_assignments;
@@ -809,20 +1398,70 @@ void SystemRDLElaborator::elaborate_explicit_component_inst(
     clear_parameter_context();
 }
 
+void SystemRDLElaborator::elaborate_linked_block_instance(
+    const std::string                      &type_name,
+    Size                                    block_size,
+    SystemRDLParser::Component_instContext *inst_ctx,
+    ElaboratedNode                         *parent,
+    Address                                &current_address)
+{
+    std::string base_name = inst_ctx->ID()->getText();
+
+    Address base_address = instance_base_address(inst_ctx, current_address);
+
+    // Elements of a linked block array are packed unless a stride is given
+    size_t  count  = 1;
+    Address stride = block_size;
+    auto    suffix = inst_ctx->array_suffix();
+    if (!suffix.empty() && suffix[0]->expr()) {
+        count = evaluate_integer_expression(suffix[0]->expr());
+        check_array_limit(count, inst_ctx);
+    }
+    if (auto stride_addr = inst_ctx->inst_addr_stride()) {
+        stride = evaluate_address_expression(stride_addr->expr());
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        check_limits(parent);
+
+        auto node              = create_elaborated_node("addrmap");
+        node->inst_name        = suffix.empty() ? base_name
+                                                : base_name + "[" + std::to_string(i) + "]";
+        node->type_name        = "addrmap";
+        node->source_ctx       = inst_ctx;
+        node->absolute_address = parent->absolute_address + base_address + i * stride;
+        node->size             = block_size;
+        node->set_property("linked_block", PropertyValue(type_name));
+        if (!suffix.empty()) {
+            node->array_dimensions = {count};
+            node->array_indices    = {i};
+        }
+        attach_child(parent, std::move(node));
+    }
+
+    current_address = base_address + (count > 0 ? (count - 1) * stride + block_size : 0);
+}
+
 void SystemRDLElaborator::elaborate_named_component_instance(
     const std::string                      &type_name,
     SystemRDLParser::Component_instContext *inst_ctx,
     ElaboratedNode                         *parent,
     Address                                &current_address)
 {
+    trace::Span span("elaborate_named_component_instance", "elaborate");
+    if (span.active()) {
+        span.add_arg("path", trace_instance_path(parent, inst_ctx->ID()->getText()));
+        span.add_arg("type", type_name);
+    }
+
     // Find component definition
-    auto it = component_definitions_.find(type_name);
-    if (it == component_definitions_.end()) {
-        report_error("Undefined component type: " + type_name, inst_ctx);
+    const ComponentDefinition *definition = find_component_definition(type_name);
+    if (!definition) {
+        report_error("Undefined component type: " + type_name, inst_ctx, "undefined-component");
         return;
     }
 
-    const ComponentDefinition &comp_def  = it->second;
+    const ComponentDefinition &comp_def  = *definition;
     std::string                inst_name = inst_ctx->ID()->getText();
 
     // Check if it's an array
@@ -840,26 +1479,30 @@ void SystemRDLElaborator::elaborate_named_component_instance(
         node->source_ctx = inst_ctx; // Save source context for error reporting
 
         // Calculate address
-        Address instance_address = current_address;
-        if (auto fixed_addr = inst_ctx->inst_addr_fixed()) {
-            instance_address = evaluate_address_expression(fixed_addr->expr());
-        }
+        Address instance_address = instance_base_address(inst_ctx, current_address);
 
         node->absolute_address = parent->absolute_address + instance_address;
 
-        // Process component body (from named definition)
-        if (auto body = comp_def.def_ctx->component_body()) {
-            elaborate_component_body(body, node.get());
+        // Process component body (from named definition), unless a worker elaborates it
+        if (options_.external_blocks.count(type_name)) {
+            node->set_property("linked_block", PropertyValue(type_name));
+        } else if (auto body = comp_def.def_ctx->component_body()) {
+            elaborate_instance_body(
+                body, node.get(), parent, inst_ctx->inst_addr_fixed() != nullptr);
         }
 
         // Calculate size
         calculate_node_size(node.get());
 
         // Save size, because node is about to be moved
-        Size node_size = node->size;
+        Size            node_size = node->size;
+        ElaboratedNode *placed    = node.get();
 
-        parent->add_child(std::move(node));
+        attach_child(parent, std::move(node));
         current_address = instance_address + node_size;
+        if (!deferred_bodies_.empty()) {
+            previous_instance_ = placed;
+        }
     }
 }
 
@@ -870,15 +1513,17 @@ void SystemRDLElaborator::elaborate_named_array_instance(
     Address                                &current_address)
 {
     // Find component definition
-    auto it = component_definitions_.find(type_name);
-    if (it == component_definitions_.end()) {
-        report_error("Undefined component type: " + type_name, inst_ctx);
+    const ComponentDefinition *definition = find_component_definition(type_name);
+    if (!definition) {
+        report_error("Undefined component type: " + type_name, inst_ctx, "undefined-component");
         return;
     }
 
-    const ComponentDefinition &comp_def  = it->second;
+    const ComponentDefinition &comp_def  = *definition;
     std::string                base_name = inst_ctx->ID()->getText();
 
+    trace::Span span("elaborate_named_array_instance", "elaborate");
+
     // Parse array dimensions
     auto                array_suffixes = inst_ctx->array_suffix();
     std::vector<size_t> dimensions;
@@ -895,10 +1540,7 @@ void SystemRDLElaborator::elaborate_named_array_instance(
     }
 
     // Calculate base address
-    Address base_address = current_address;
-    if (auto fixed_addr = inst_ctx->inst_addr_fixed()) {
-        base_address = evaluate_address_expression(fixed_addr->expr());
-    }
+    Address base_address = instance_base_address(inst_ctx, current_address);
 
     // Calculate stride
     Address stride = 4; // Default 4-byte alignment
@@ -906,8 +1548,18 @@ void SystemRDLElaborator::elaborate_named_array_instance(
         stride = evaluate_address_expression(stride_addr->expr());
     }
 
+    if (span.active()) {
+        span.add_arg("path", trace_instance_path(parent, base_name));
+        span.add_arg("count", std::to_string(dimensions[0]));
+    }
+
+    // A mistyped array size must not allocate millions of nodes before a limit is noticed
+    check_array_limit(dimensions[0], inst_ctx);
+
     // Generate array instances
     for (size_t i = 0; i < dimensions[0]; ++i) {
+        check_limits(parent);
+
         auto node = create_elaborated_node(comp_def.type);
         if (!node)
             continue;
@@ -919,13 +1571,15 @@ void SystemRDLElaborator::elaborate_named_array_instance(
         node->array_dimensions = dimensions;
         node->array_indices    = {i};
 
-        // Process component body (from named definition)
-        if (auto body = comp_def.def_ctx->component_body()) {
-            elaborate_component_body(body, node.get());
+        // Process component body (from named definition), unless a worker elaborates it
+        if (options_.external_blocks.count(type_name)) {
+            node->set_property("linked_block", PropertyValue(type_name));
+        } else if (auto body = comp_def.def_ctx->component_body()) {
+            elaborate_instance_body(body, node.get(), parent, true);
         }
 
         calculate_node_size(node.get());
-        parent->add_child(std::move(node));
+        attach_child(parent, std::move(node));
     }
 
     current_address = base_address + dimensions[0] * stride;
@@ -947,34 +1601,7 @@ void SystemRDLElaborator::elaborate_local_property_assignment(
 
         // Get property value
         if (auto rhs = normal_prop->prop_assignment_rhs()) {
-            PropertyValue value = evaluate_property_value(rhs);
-            parent->set_property(prop_name, value);
-
-            // Special handling for regwidth property
-            if (prop_name == "regwidth" && value.type == PropertyValue::INTEGER) {
-                if (auto reg_node = dynamic_cast<ElaboratedReg *>(parent)) {
-                    reg_node->register_width = static_cast<uint32_t>(value.int_val);
-                }
-            }
-            // Special handling for encode attribute
-            else if (prop_name == "encode" && value.type == PropertyValue::STRING) {
-                // Check if it's an enum type
-                auto enum_def = find_enum_definition(value.string_val);
-                if (enum_def) {
-                    // Store enum information
-                    parent->set_property("encode_type", PropertyValue(std::string("enum")));
-                    parent->set_property("encode_name", value);
-
-                    // Store enum value mapping
-                    std::string enum_values = "";
-                    for (const auto &entry : enum_def->entries) {
-                        if (!enum_values.empty())
-                            enum_values += ",";
-                        enum_values += entry.name + "=" + std::to_string(entry.value);
-                    }
-                    parent->set_property("encode_values", PropertyValue(enum_values));
-                }
-            }
+            apply_property(parent, prop_name, evaluate_property_value(rhs));
         } else {
             // No value assigned, set to true (for boolean attributes)
             parent->set_property(prop_name, PropertyValue(true));
@@ -986,16 +1613,33 @@ void SystemRDLElaborator::elaborate_local_property_assignment(
             // Get enum name
             enum_name = id->getText();
         }
+        apply_property(parent, "encode", PropertyValue(enum_name));
+    }
+    // TODO: Handle prop_mod_assign
+}
 
-        // Set encode attribute
-        parent->set_property("encode", PropertyValue(enum_name));
+void SystemRDLElaborator::apply_property(
+    ElaboratedNode *node, const std::string &name, const PropertyValue &value)
+{
+    if (options_.discarded_properties.count(name)) {
+        return;
+    }
+    node->set_property(name, value);
 
-        // Find enum definition
-        auto enum_def = find_enum_definition(enum_name);
+    // Special handling for regwidth property
+    if (name == "regwidth" && value.type == PropertyValue::INTEGER) {
+        if (auto reg_node = dynamic_cast<ElaboratedReg *>(node)) {
+            reg_node->register_width = static_cast<uint32_t>(value.int_val);
+        }
+    }
+    // Special handling for encode attribute
+    else if (name == "encode" && value.type == PropertyValue::STRING) {
+        // Check if it's an enum type
+        auto enum_def = find_enum_definition(value.string_val);
         if (enum_def) {
             // Store enum information
-            parent->set_property("encode_type", PropertyValue(std::string("enum")));
-            parent->set_property("encode_name", PropertyValue(enum_name));
+            node->set_property("encode_type", PropertyValue(std::string("enum")));
+            node->set_property("encode_name", value);
 
             // Store enum value mapping
             std::string enum_values = "";
@@ -1004,18 +1648,211 @@ void SystemRDLElaborator::elaborate_local_property_assignment(
                     enum_values += ",";
                 enum_values += entry.name + "=" + std::to_string(entry.value);
             }
-            parent->set_property("encode_values", PropertyValue(enum_values));
+            node->set_property("encode_values", PropertyValue(enum_values));
         }
     }
-    // TODO: Handle prop_mod_assign
 }
 
 void SystemRDLElaborator::elaborate_dynamic_property_assignment(
-    SystemRDLParser::Dynamic_property_assignmentContext *dynamic_prop, ElaboratedNode *parent)
+    SystemRDLParser::Dynamic_property_assignmentContext *dynamic_prop,
+    std::vector<DynamicAssignment>                      &assignments)
+{
+    // Dynamic property assignment: instance_ref -> property = value. The value is evaluated
+    // now, in the parameter context of the body, and applied when the body is complete.
+    DynamicAssignment assignment;
+    assignment.ctx = dynamic_prop;
+
+    for (auto element : dynamic_prop->instance_ref()->instance_ref_element()) {
+        PathSegment segment;
+        segment.name  = intern_path_segment(element->ID()->getText());
+        auto suffixes = element->array_suffix();
+        if (suffixes.size() > 1) {
+            report_error(
+                "Multi-dimensional array reference '" + element->getText()
+                    + "' in dynamic property assignment is not supported",
+                dynamic_prop,
+                "unsupported-dynamic-assignment");
+            return;
+        }
+        if (!suffixes.empty()) {
+            segment.indexed = true;
+            segment.index   = evaluate_integer_expression(suffixes[0]->expr());
+        }
+        assignment.path.push_back(segment);
+    }
+
+    if (auto normal_prop = dynamic_prop->normal_prop_assign()) {
+        if (auto prop_keyword = normal_prop->prop_keyword()) {
+            assignment.property = prop_keyword->getText();
+        } else if (auto id = normal_prop->ID()) {
+            assignment.property = id->getText();
+        }
+        if (auto rhs = normal_prop->prop_assignment_rhs()) {
+            assignment.value = evaluate_property_value(rhs);
+        } else {
+            assignment.value = PropertyValue(true);
+        }
+    } else if (auto encode_prop = dynamic_prop->encode_prop_assign()) {
+        assignment.property = "encode";
+        assignment.value    = PropertyValue(encode_prop->ID()->getText());
+    }
+
+    if (is_non_dynamic_property(assignment.property)) {
+        report_error(
+            "Property '" + assignment.property + "' cannot be assigned dynamically",
+            dynamic_prop,
+            "non-dynamic-property");
+        return;
+    }
+
+    assignments.push_back(std::move(assignment));
+}
+
+uint32_t SystemRDLElaborator::intern_path_segment(const std::string &name)
+{
+    auto it = path_segment_ids_.emplace(name, static_cast<uint32_t>(path_segment_ids_.size()));
+    return it.first->second;
+}
+
+const SystemRDLElaborator::ChildIndex &SystemRDLElaborator::child_index(const ElaboratedNode *node)
 {
-    // Dynamic property assignment: instance_ref -> property = value
-    // This requires finding the target instance, temporarily skipping complex implementation
-    // TODO: Implement dynamic property assignment
+    auto it = child_indexes_.find(node);
+    if (it != child_indexes_.end()) {
+        return it->second;
+    }
+
+    ChildIndex index;
+    for (const auto &child : node->children) {
+        const std::string &name = child->inst_name;
+        index[intern_path_segment(name.substr(0, name.find('[')))].push_back(child.get());
+    }
+    return child_indexes_.emplace(node, std::move(index)).first->second;
+}
+
+void SystemRDLElaborator::apply_dynamic_assignments(
+    ElaboratedNode *scope, const std::vector<DynamicAssignment> &assignments)
+{
+    if (assignments.empty()) {
+        return;
+    }
+
+    trace::Span span("apply_dynamic_assignments", "elaborate");
+    if (span.active()) {
+        span.add_arg("path", scope->get_hierarchical_path());
+        span.add_arg("count", std::to_string(assignments.size()));
+    }
+
+    // Children are only indexed for this pass: later passes may see nodes added or released
+    for (const auto &assignment : assignments) {
+        apply_dynamic_assignment(scope, assignment, 0);
+    }
+    child_indexes_.clear();
+}
+
+void SystemRDLElaborator::apply_dynamic_assignment(
+    ElaboratedNode *node, const DynamicAssignment &assignment, size_t depth)
+{
+    if (depth == assignment.path.size()) {
+        apply_property(node, assignment.property, assignment.value);
+
+        // A reset override changes the value the register reports
+        auto field = dynamic_cast<ElaboratedField *>(node);
+        if (field && assignment.property == "reset"
+            && assignment.value.type == PropertyValue::INTEGER) {
+            field->reset_value = static_cast<uint64_t>(assignment.value.int_val);
+            validate_field_reset_value(field, assignment.ctx);
+            if (auto reg_node = dynamic_cast<ElaboratedReg *>(field->parent)) {
+                calculate_register_reset_value(reg_node);
+            }
+        }
+        return;
+    }
+
+    // The rest of the path lies in a body that is not elaborated yet
+    if (deferred_bodies_.count(node)) {
+        DynamicAssignment pending = assignment;
+        pending.path.erase(pending.path.begin(), pending.path.begin() + depth);
+        pending_assignments_[node].push_back(std::move(pending));
+        return;
+    }
+
+    const PathSegment &segment = assignment.path[depth];
+    const auto        &index   = child_index(node);
+    auto               it      = index.find(segment.name);
+    if (it != index.end() && !segment.indexed) {
+        // Every element of an array, or the single instance
+        for (auto child : it->second) {
+            apply_dynamic_assignment(child, assignment, depth + 1);
+        }
+        return;
+    }
+    if (it != index.end()) {
+        const auto &elements = it->second;
+        auto        element  = segment.index < elements.size() ? elements[segment.index] : nullptr;
+        if (!element || element->array_indices.empty()
+            || element->array_indices[0] != segment.index) {
+            element = nullptr;
+            for (auto candidate : elements) {
+                if (!candidate->array_indices.empty()
+                    && candidate->array_indices[0] == segment.index) {
+                    element = candidate;
+                    break;
+                }
+            }
+        }
+        if (element) {
+            apply_dynamic_assignment(element, assignment, depth + 1);
+            return;
+        }
+    }
+
+    report_error(
+        "Instance '" + assignment.ctx->instance_ref()->getText()
+            + "' of dynamic property assignment not found in '" + node->get_hierarchical_path()
+            + "'",
+        assignment.ctx,
+        "unknown-instance");
+}
+
+// Streaming mode: apply the assignments of the enclosing bodies that reach a register or
+// memory about to be released, innermost body first as if each body had completed
+void SystemRDLElaborator::apply_enclosing_assignments(ElaboratedNode *leaf)
+{
+    bool                          applied = false;
+    std::vector<ElaboratedNode *> chain; // From the leaf up to the child of the scope
+    for (auto frame = assignment_scopes_.rbegin(); frame != assignment_scopes_.rend(); ++frame) {
+        chain.clear();
+        for (auto node = leaf; node && node != frame->scope; node = node->parent) {
+            chain.push_back(node);
+        }
+        if (chain.empty() || chain.back()->parent != frame->scope) {
+            continue;
+        }
+
+        for (auto &assignment : *frame->assignments) {
+            if (assignment.path.size() < chain.size()) {
+                continue;
+            }
+            bool matches = true;
+            for (size_t depth = 0; depth < chain.size() && matches; depth++) {
+                const ElaboratedNode *node    = chain[chain.size() - 1 - depth];
+                const PathSegment    &segment = assignment.path[depth];
+                const std::string    &name    = node->inst_name;
+                matches = intern_path_segment(name.substr(0, name.find('['))) == segment.name
+                          && (!segment.indexed
+                              || (!node->array_indices.empty()
+                                  && node->array_indices[0] == segment.index));
+            }
+            if (matches) {
+                assignment.streamed = true;
+                apply_dynamic_assignment(leaf, assignment, chain.size());
+                applied = true;
+            }
+        }
+    }
+    if (applied) {
+        child_indexes_.clear();
+    }
 }
 
 PropertyValue SystemRDLElaborator::evaluate_property_value(
@@ -1278,7 +2115,8 @@ void SystemRDLElaborator::elaborate_field_bit_range(
                 report_error(
                     "Invalid bit range: MSB (" + std::to_string(msb) + ") is less than LSB ("
                         + std::to_string(lsb) + ")",
-                    inst_ctx);
+                    inst_ctx,
+                    "invalid-bit-range");
             }
 
             // Set bit range attribute
@@ -1452,7 +2290,7 @@ void SystemRDLElaborator::apply_parameter_assignments(
         if (param_exists) {
             current_parameter_values_[assignment.name] = assignment.value;
         } else {
-            report_error("Unknown parameter: " + assignment.name);
+            report_error("Unknown parameter: " + assignment.name, nullptr, "unknown-parameter");
         }
     }
 
@@ -1460,7 +2298,8 @@ void SystemRDLElaborator::apply_parameter_assignments(
     for (const auto &param_def : param_defs) {
         if (!param_def.has_default
             && current_parameter_values_.find(param_def.name) == current_parameter_values_.end()) {
-            report_error("Missing required parameter: " + param_def.name);
+            report_error(
+                "Missing required parameter: " + param_def.name, nullptr, "missing-parameter");
         }
     }
 }
@@ -1727,9 +2566,9 @@ void SystemRDLElaborator::collect_enum_and_struct_definitions(SystemRDLParser::R
     // Collect top-level definitions
     for (auto root_elem : ast_root->root_elem()) {
         if (auto enum_def = root_elem->enum_def()) {
-            register_enum_definition(enum_def);
+            index_enum_definition(enum_def);
         } else if (auto struct_def = root_elem->struct_def()) {
-            register_struct_definition(struct_def);
+            index_struct_definition(struct_def);
         } else if (auto comp_def = root_elem->component_def()) {
             if (auto named_def = comp_def->component_named_def()) {
                 // Recursively collect internal definitions
@@ -1746,9 +2585,9 @@ void SystemRDLElaborator::collect_enum_and_struct_definitions_from_body(
 {
     for (auto body_elem : body_ctx->component_body_elem()) {
         if (auto enum_def = body_elem->enum_def()) {
-            register_enum_definition(enum_def);
+            index_enum_definition(enum_def);
         } else if (auto struct_def = body_elem->struct_def()) {
-            register_struct_definition(struct_def);
+            index_struct_definition(struct_def);
         } else if (auto comp_def = body_elem->component_def()) {
             if (auto named_def = comp_def->component_named_def()) {
                 // Recursively collect internal definitions
@@ -1826,18 +2665,98 @@ void SystemRDLElaborator::register_struct_definition(SystemRDLParser::Struct_def
     struct_definitions_[struct_name] = def;
 }
 
+void SystemRDLElaborator::index_enum_definition(SystemRDLParser::Enum_defContext *enum_def)
+{
+    std::string enum_name = enum_def->ID()->getText();
+    if (collecting_library_
+        && (enum_definitions_.count(enum_name) || pending_enum_defs_.count(enum_name))) {
+        return;
+    }
+    enum_definitions_.erase(enum_name); // A later definition replaces an earlier one
+    pending_enum_defs_[enum_name] = enum_def;
+    definition_stats_.indexed++;
+}
+
+void SystemRDLElaborator::index_struct_definition(SystemRDLParser::Struct_defContext *struct_def)
+{
+    auto ids = struct_def->ID();
+    if (ids.empty())
+        return;
+
+    std::string struct_name = ids[0]->getText();
+    if (collecting_library_
+        && (struct_definitions_.count(struct_name) || pending_struct_defs_.count(struct_name))) {
+        return;
+    }
+    struct_definitions_.erase(struct_name);
+    pending_struct_defs_[struct_name] = struct_def;
+    definition_stats_.indexed++;
+}
+
 EnumDefinition *SystemRDLElaborator::find_enum_definition(const std::string &name)
 {
+    if (!pending_enum_defs_.count(name) && !enum_definitions_.count(name)) {
+        load_library_definition(name);
+    }
+
+    // Enum values are evaluated the first time the enum is referenced
+    auto pending = pending_enum_defs_.find(name);
+    if (pending != pending_enum_defs_.end()) {
+        auto enum_def = pending->second;
+        pending_enum_defs_.erase(pending);
+        register_enum_definition(enum_def);
+        definition_stats_.analysed++;
+    }
+
     auto it = enum_definitions_.find(name);
     return (it != enum_definitions_.end()) ? &it->second : nullptr;
 }
 
 StructDefinition *SystemRDLElaborator::find_struct_definition(const std::string &name)
 {
+    if (!pending_struct_defs_.count(name) && !struct_definitions_.count(name)) {
+        load_library_definition(name);
+    }
+
+    auto pending = pending_struct_defs_.find(name);
+    if (pending != pending_struct_defs_.end()) {
+        auto struct_def = pending->second;
+        pending_struct_defs_.erase(pending);
+        register_struct_definition(struct_def);
+        definition_stats_.analysed++;
+    }
+
     auto it = struct_definitions_.find(name);
     return (it != struct_definitions_.end()) ? &it->second : nullptr;
 }
 
+bool SystemRDLElaborator::load_library_definition(const std::string &name)
+{
+    if (options_.definition_libraries.empty() || !library_lookups_.insert(name).second) {
+        return false;
+    }
+
+    for (const auto &library : options_.definition_libraries) {
+        auto tree = library->find_definition(name);
+        if (!tree) {
+            continue;
+        }
+        if (library_trees_.insert(tree).second) {
+            trace::Span span("load_library_definition", "elaborate");
+            if (span.active()) {
+                span.add_arg("name", name);
+            }
+
+            collecting_library_ = true;
+            collect_enum_and_struct_definitions(tree);
+            collect_component_definitions(tree);
+            collecting_library_ = false;
+        }
+        return true;
+    }
+    return false;
+}
+
 // Field validation implementation
 void SystemRDLElaborator::validate_register_fields(ElaboratedReg *reg_node)
 {
@@ -1944,7 +2863,7 @@ void SystemRDLElaborator::report_field_overlap_error(
     std::ostringstream oss;
     oss << "Field overlap detected: '" << field1_name << "' and '" << field2_name
         << "' both use bits [" << overlap_end << ":" << overlap_start << "]";
-    report_error(oss.str(), ctx);
+    report_error(oss.str(), ctx, "field-overlap");
 }
 
 void SystemRDLElaborator::report_field_boundary_error(
@@ -1957,7 +2876,7 @@ void SystemRDLElaborator::report_field_boundary_error(
     oss << "Field '" << field_name << "' bit position " << field_msb
         << " exceeds register width of " << reg_width << " bits (valid range: 0-" << (reg_width - 1)
         << ")";
-    report_error(oss.str(), ctx);
+    report_error(oss.str(), ctx, "field-boundary");
 }
 
 // Gap detection and reserved field generation implementation
@@ -2166,7 +3085,8 @@ void SystemRDLElaborator::assign_automatic_field_positions(ElaboratedReg *reg_no
                         + "' would exceed register width. Field needs " + std::to_string(field_width)
                         + " bits but only " + std::to_string(reg_node->register_width - current_bit)
                         + " bits available from position " + std::to_string(current_bit),
-                    field->source_ctx);
+                    field->source_ctx,
+                    "field-boundary");
                 continue;
             }
 
@@ -2218,30 +3138,136 @@ size_t SystemRDLElaborator::calculate_next_available_bit(ElaboratedReg *reg_node
 }
 
 // Instance address validation implementation
-void SystemRDLElaborator::validate_instance_addresses(ElaboratedNode *parent)
+void SystemRDLElaborator::validate_instance_addresses(ElaboratedNode *root)
 {
-    if (!parent)
+    if (!root)
         return;
 
-    // Check address overlaps among child instances
-    check_instance_address_overlaps(parent);
+    // Every addrmap/regfile is an independent address space, so the spaces are checked
+    // concurrently. Errors are reported afterwards in pre-order, matching a sequential walk.
+    std::vector<ElaboratedNode *> spaces;
+    collect_address_spaces(root, spaces);
+
+    size_t total_children = 0;
+    for (auto *space : spaces) {
+        total_children += space->children.size();
+    }
+
+    // Below this many instances thread start-up costs more than it saves
+    constexpr size_t parallel_threshold = 4096;
+
+    size_t workers = options_.validation_threads > 0 ? options_.validation_threads
+                                                     : std::thread::hardware_concurrency();
+    workers        = std::min(workers, spaces.size());
 
-    // Recursively validate address spaces in child containers
+    std::vector<std::vector<PendingError>> pending(spaces.size());
+    if (workers <= 1 || total_children < parallel_threshold) {
+        for (size_t i = 0; i < spaces.size(); ++i) {
+            check_instance_address_overlaps(spaces[i], pending[i]);
+        }
+    } else {
+        std::atomic<size_t> next_space{0};
+        auto                worker = [&]() {
+            trace::Span span("check_address_spaces", "validate");
+            size_t      checked = 0;
+            for (size_t i = next_space++; i < spaces.size(); i = next_space++) {
+                check_instance_address_overlaps(spaces[i], pending[i]);
+                checked++;
+            }
+            span.add_arg("spaces", std::to_string(checked));
+        };
+
+        std::vector<std::future<void>> helpers;
+        for (size_t w = 1; w < workers; ++w) {
+            helpers.push_back(std::async(std::launch::async, worker));
+        }
+        worker();
+        for (auto &helper : helpers) {
+            helper.get();
+        }
+    }
+
+    for (const auto &space_errors : pending) {
+        for (const auto &error : space_errors) {
+            report_error(error.message, error.ctx, error.code);
+        }
+    }
+}
+
+void SystemRDLElaborator::attach_child(
+    ElaboratedNode *parent, std::unique_ptr<ElaboratedNode> node)
+{
+    if (!options_.stream_sink) {
+        parent->add_child(std::move(node));
+        return;
+    }
+
+    // Registers inside a memory belong to the memory and are streamed with it
+    bool leaf = (dynamic_cast<ElaboratedReg *>(node.get())
+                 || dynamic_cast<ElaboratedMem *>(node.get()))
+                && !dynamic_cast<ElaboratedMem *>(parent);
+    if (!leaf) {
+        if (dynamic_cast<ElaboratedAddrmap *>(node.get())
+            || dynamic_cast<ElaboratedRegfile *>(node.get())) {
+            validate_container_addresses(node.get());
+        }
+        parent->add_child(std::move(node));
+        return;
+    }
+
+    // Linked to the parent without being owned, so hierarchical paths work in the sink
+    node->parent = parent;
+    apply_enclosing_assignments(node.get());
+    node->accept_visitor(*options_.stream_sink);
+    streamed_nodes_++;
+
+    // Keep only what address validation needs; the node itself is released here
+    streamed_leaves_[parent].push_back(
+        {std::move(node->inst_name), node->absolute_address, node->size, node->source_ctx});
+}
+
+// Streaming mode: validate one complete container, then drop its released leaves
+void SystemRDLElaborator::validate_container_addresses(ElaboratedNode *container)
+{
+    std::vector<PendingError> pending;
+    check_instance_address_overlaps(container, pending);
+    streamed_leaves_.erase(container);
+
+    for (const auto &error : pending) {
+        report_error(error.message, error.ctx, error.code);
+    }
+}
+
+void SystemRDLElaborator::collect_address_spaces(
+    ElaboratedNode *parent, std::vector<ElaboratedNode *> &spaces)
+{
+    spaces.push_back(parent);
+
+    // Recursively collect address spaces in child containers
     for (const auto &child : parent->children) {
         if (dynamic_cast<ElaboratedAddrmap *>(child.get())
             || dynamic_cast<ElaboratedRegfile *>(child.get())) {
-            validate_instance_addresses(child.get());
+            collect_address_spaces(child.get(), spaces);
         }
     }
 }
 
-void SystemRDLElaborator::check_instance_address_overlaps(ElaboratedNode *parent)
+// Runs on validation worker threads: must only read the model and write pending_errors
+void SystemRDLElaborator::check_instance_address_overlaps(
+    ElaboratedNode *parent, std::vector<PendingError> &pending_errors)
 {
     if (!parent)
         return;
 
-    // Collect addressable child instances
-    std::vector<ElaboratedNode *> addressable_children;
+    // Address ranges of the addressable child instances
+    struct Range
+    {
+        const std::string         *name;
+        Address                    address;
+        Size                       size;
+        antlr4::ParserRuleContext *ctx;
+    };
+    std::vector<Range> addressable_children;
 
     for (const auto &child : parent->children) {
         // Only check addressable components (regs, regfiles, memories)
@@ -2249,48 +3275,50 @@ void SystemRDLElaborator::check_instance_address_overlaps(ElaboratedNode *parent
         if (dynamic_cast<ElaboratedReg *>(child.get())
             || dynamic_cast<ElaboratedRegfile *>(child.get())
             || dynamic_cast<ElaboratedMem *>(child.get())) {
-            addressable_children.push_back(child.get());
+            addressable_children.push_back(
+                {&child->inst_name, child->absolute_address, child->size, child->source_ctx});
+        }
+    }
+
+    // Registers and memories already handed to the stream sink
+    auto streamed = streamed_leaves_.find(parent);
+    if (streamed != streamed_leaves_.end()) {
+        for (const auto &leaf : streamed->second) {
+            addressable_children.push_back({&leaf.name, leaf.address, leaf.size, leaf.ctx});
         }
     }
 
     // Check for overlaps between all instance pairs
     for (size_t i = 0; i < addressable_children.size(); ++i) {
+        const Range &first = addressable_children[i];
         for (size_t j = i + 1; j < addressable_children.size(); ++j) {
-            if (instances_overlap(addressable_children[i], addressable_children[j])) {
-                // Calculate address ranges for error reporting
-                Address addr1_start = addressable_children[i]->absolute_address;
-                Address addr1_end   = addr1_start + addressable_children[i]->size - 1;
-                Address addr2_start = addressable_children[j]->absolute_address;
-                Address addr2_end   = addr2_start + addressable_children[j]->size - 1;
-
+            const Range &second = addressable_children[j];
+            if (ranges_overlap(first.address, first.size, second.address, second.size)) {
                 report_instance_overlap_error(
-                    addressable_children[i]->inst_name,
-                    addressable_children[j]->inst_name,
-                    addr1_start,
-                    addr1_end,
-                    addr2_start,
-                    addr2_end,
-                    addressable_children[i]->source_ctx);
+                    pending_errors,
+                    *first.name,
+                    *second.name,
+                    first.address,
+                    first.address + first.size - 1,
+                    second.address,
+                    second.address + second.size - 1,
+                    first.ctx);
             }
         }
     }
 }
 
-bool SystemRDLElaborator::instances_overlap(
-    const ElaboratedNode *instance1, const ElaboratedNode *instance2)
+bool SystemRDLElaborator::ranges_overlap(Address start1, Size size1, Address start2, Size size2)
 {
-    if (!instance1 || !instance2)
-        return false;
-
     // Skip instances with invalid addresses or sizes
-    if (instance1->size == 0 || instance2->size == 0)
+    if (size1 == 0 || size2 == 0)
         return false;
 
     // Calculate address ranges
-    Address addr1_start = instance1->absolute_address;
-    Address addr1_end   = addr1_start + instance1->size - 1;
-    Address addr2_start = instance2->absolute_address;
-    Address addr2_end   = addr2_start + instance2->size - 1;
+    Address addr1_start = start1;
+    Address addr1_end   = addr1_start + size1 - 1;
+    Address addr2_start = start2;
+    Address addr2_end   = addr2_start + size2 - 1;
 
     // Two ranges overlap if: max(start1, start2) <= min(end1, end2)
     Address max_start = std::max(addr1_start, addr2_start);
@@ -2300,6 +3328,7 @@ bool SystemRDLElaborator::instances_overlap(
 }
 
 void SystemRDLElaborator::report_instance_overlap_error(
+    std::vector<PendingError> &pending_errors,
     const std::string         &instance1_name,
     const std::string         &instance2_name,
     Address                    addr1_start,
@@ -2313,7 +3342,7 @@ void SystemRDLElaborator::report_instance_overlap_error(
         << std::hex << std::uppercase << addr1_start << "-0x" << addr1_end << " overlaps with '"
         << instance2_name << "' at address range 0x" << addr2_start << "-0x" << addr2_end;
 
-    report_error(oss.str(), ctx);
+    pending_errors.push_back({oss.str(), ctx, "address-overlap"});
 }
 
 } // namespace systemrdl
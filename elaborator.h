@@ -1,10 +1,17 @@
 #pragma once
 
 #include "SystemRDLParser.h"
+#include "systemrdl_progress.h"
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace systemrdl {
@@ -177,6 +184,9 @@ public:
     uint32_t    register_width = 32; // Register bit width
     std::string register_reset_hex;  // Register reset value in 0x format
 
+    // Low 64 bits of register_reset_hex, 0 if it is unset
+    uint64_t reset_low64() const;
+
     // Find fields
     ElaboratedField *find_field_by_name(const std::string &name) const;
     ElaboratedField *find_field_by_bit_range(size_t msb, size_t lsb) const;
@@ -231,6 +241,19 @@ public:
     virtual void visit(ElaboratedMem &node)     = 0;
 };
 
+// Source of definitions that are not in the elaborated file, e.g. a precompiled component
+// library (see systemrdl_library.h). Providers can be shared between elaborators running on
+// different threads, so find_definition() must be thread-safe.
+class DefinitionProvider
+{
+public:
+    virtual ~DefinitionProvider() = default;
+
+    // Parse tree holding the definition with this name (top-level or nested), or nullptr. The
+    // tree stays valid as long as the provider.
+    virtual SystemRDLParser::RootContext *find_definition(const std::string &name) const = 0;
+};
+
 // Main elaborator class
 class SystemRDLElaborator
 {
@@ -238,22 +261,188 @@ public:
     SystemRDLElaborator();
     ~SystemRDLElaborator();
 
+    // Elaboration options
+    struct Options
+    {
+        size_t max_errors         = 0;     // Abort after this many distinct errors (0 = unlimited)
+        bool   fail_fast          = false; // Abort on the first error
+        size_t validation_threads = 0;     // Address validation workers (0 = hardware concurrency)
+
+        // Resource limits; exceeding one aborts elaboration with an error (0 = no limit)
+        CancellationToken         cancel_token;
+        std::chrono::milliseconds timeout{0};         // Wall-clock limit for elaborate()
+        size_t                    max_nodes        = 0; // Elaborated component instances
+        uint64_t                  max_memory_bytes = 0; // Process resident set size
+
+        // Called every progress_interval elaborated nodes
+        std::function<void(const ElaborationProgress &)> progress_callback;
+        size_t                                           progress_interval = 10000;
+
+        // Streaming mode: each register and memory is passed to the sink (via accept_visitor)
+        // as soon as it is complete, then released. The returned model keeps only addrmaps
+        // and regfiles; until a container completes, its released registers are kept as name,
+        // address range and source location. Dynamic assignments of the enclosing bodies are
+        // applied before a register reaches the sink. Address overlaps are validated per
+        // container when it completes; check has_errors() before committing what the sink
+        // received.
+        ElaboratedNodeVisitor *stream_sink = nullptr;
+
+        // Name of the top-level addrmap definition to elaborate (empty = first one found)
+        std::string top;
+
+        // Lazy mode: bodies of addrmap/regfile instances whose address does not depend on
+        // their size (fixed address or array element) are elaborated by materialize(), or
+        // earlier for a register file whose size places a later sibling.
+        // Ignored in streaming mode. See LazyElaboratedModel for a thread-safe wrapper.
+        bool lazy = false;
+
+        // Searched in order for component, enum and struct names the source does not define
+        std::vector<std::shared_ptr<const DefinitionProvider>> definition_libraries;
+
+        // Addrmaps elaborated separately, by definition name and size (see systemrdl_link.h).
+        // Their instances become empty addrmaps of that size with the property "linked_block"
+        // set to the name; the linker fills them in after elaboration. A linked block takes
+        // precedence over a definition of the same name unless the instance sets parameters.
+        std::unordered_map<std::string, Size> linked_blocks;
+
+        // Fan-out (systemrdl_fanout.h): addrmap definitions elaborated by worker processes.
+        // Their instances are placed exactly as if the definition were elaborated here, but
+        // the body is skipped and the property "linked_block" set for the linker.
+        std::unordered_set<std::string> external_blocks;
+
+        // Properties assigned in the source but not stored on the elaborated nodes, for
+        // consumers that never read them. Only documentation properties such as "desc" and
+        // "name" are safe to discard; elaboration itself reads the others.
+        std::unordered_set<std::string> discarded_properties;
+    };
+
+    void           set_options(const Options &options) { options_ = options; }
+    const Options &get_options() const { return options_; }
+
     // Main interface
     std::unique_ptr<ElaboratedAddrmap> elaborate(SystemRDLParser::RootContext *ast_root);
 
-    // Error handling
+    // Parse trees of `include'd files, in include order (see systemrdl_include.h). Their
+    // definitions are visible to the root passed to elaborate(), which may redefine them.
+    // The trees must outlive elaboration (and materialize() in lazy mode).
+    void set_library_roots(std::vector<SystemRDLParser::RootContext *> roots)
+    {
+        library_roots_ = std::move(roots);
+    }
+
+    // Error handling. Errors are deduplicated per source location (per message when the
+    // location is unknown); repeated reports only increment the count of the first one.
     struct ElaborationError
     {
         std::string message;
+        std::string file;       // Source name of the offending token, empty if unknown
         size_t      line   = 0;
         size_t      column = 0;
+        size_t      count  = 1;             // Number of times this error was reported
+        std::string code   = "elaboration"; // Stable diagnostic identifier, e.g. "field-overlap"
     };
 
     const std::vector<ElaborationError> &get_errors() const { return errors_; }
     bool                                 has_errors() const { return !errors_.empty(); }
 
+    // Reports folded into an existing error entry
+    size_t get_suppressed_error_count() const { return suppressed_errors_; }
+
+    // True if elaboration stopped early (error limit, cancellation or a resource limit)
+    bool was_aborted() const { return aborted_; }
+
+    // Component instances created by the last elaborate() call
+    size_t get_elaborated_node_count() const { return nodes_elaborated_; }
+
+    // Definitions found in the source vs. analysed because the selected top reaches them
+    struct DefinitionStats
+    {
+        size_t indexed  = 0;
+        size_t analysed = 0;
+    };
+    const DefinitionStats &get_definition_stats() const { return definition_stats_; }
+
+    // Registers and memories passed to Options::stream_sink by the last elaborate() call
+    size_t get_streamed_node_count() const { return streamed_nodes_; }
+
+    // Lazy mode: true while the body of a node returned by elaborate() is still deferred
+    bool is_deferred(const ElaboratedNode *node) const
+    {
+        return deferred_bodies_.find(node) != deferred_bodies_.end();
+    }
+
+    // Lazy mode: elaborate the deferred body of a node (no-op for other nodes), then validate
+    // its address space. Returns false if this reported errors or aborted elaboration, on this
+    // and every later call for the node. The parse tree passed to elaborate() must still be
+    // alive.
+    bool materialize(ElaboratedNode *node);
+
 private:
-    std::vector<ElaborationError> errors_;
+    // Thrown by report_error() to unwind when the error limit is reached
+    struct ElaborationAborted
+    {};
+
+    // Cancellation and resource limits, checked per body element and array element
+    void check_limits(const ElaboratedNode *parent);
+    void check_array_limit(size_t elements, SystemRDLParser::Component_instContext *inst_ctx);
+    [[noreturn]] void abort_elaboration(
+        const std::string &message, antlr4::ParserRuleContext *ctx, const char *code);
+
+    // Error found by a validation worker; reported on the calling thread in a fixed order
+    struct PendingError
+    {
+        std::string                message;
+        antlr4::ParserRuleContext *ctx;
+        const char                *code;
+    };
+
+    Options                                     options_;
+    std::vector<SystemRDLParser::RootContext *> library_roots_;
+    std::vector<ElaborationError>               errors_;
+    size_t                                      suppressed_errors_ = 0;
+    bool                                        aborted_           = false;
+
+    // Limit bookkeeping; the clock, memory and progress are only sampled every few checks
+    size_t                                nodes_elaborated_ = 0;
+    size_t                                limit_checks_     = 0;
+    size_t                                next_progress_    = 0;
+    std::chrono::steady_clock::time_point start_time_;
+
+    // Streaming mode: released leaves are kept as name, address range and source location only,
+    // per parent container, until the container's address space has been validated
+    struct StreamedLeaf
+    {
+        std::string                name;
+        Address                    address;
+        Size                       size;
+        antlr4::ParserRuleContext *ctx;
+    };
+    std::unordered_map<const ElaboratedNode *, std::vector<StreamedLeaf>> streamed_leaves_;
+    size_t                                                                 streamed_nodes_ = 0;
+
+    // Attach a finished instance to its parent, streaming it out in streaming mode
+    void attach_child(ElaboratedNode *parent, std::unique_ptr<ElaboratedNode> node);
+    void validate_container_addresses(ElaboratedNode *container);
+
+    // Lazy mode: container bodies not yet elaborated, with the parameter values in effect
+    struct DeferredBody
+    {
+        SystemRDLParser::Component_bodyContext        *body;
+        std::unordered_map<std::string, PropertyValue> parameters;
+    };
+    std::unordered_map<const ElaboratedNode *, DeferredBody> deferred_bodies_;
+    std::unordered_set<const ElaboratedNode *>               failed_bodies_;
+
+    // Lazy mode: the instance placed last in the body being elaborated, whose size the next
+    // instance without @ follows. Deferred register files under it are elaborated first.
+    ElaboratedNode *previous_instance_ = nullptr;
+    bool            settle_size(ElaboratedNode *node);
+
+    // Index of the error recorded for a source location (file, line, column) and code or,
+    // without location, a message
+    using ErrorLocation = std::tuple<std::string, size_t, size_t, std::string>;
+    std::map<ErrorLocation, size_t>         error_index_by_location_;
+    std::unordered_map<std::string, size_t> error_index_by_message_;
 
     // Symbol table: stores named component definitions
     struct ComponentDefinition
@@ -262,6 +451,7 @@ private:
         std::string                                  type;
         SystemRDLParser::Component_named_defContext *def_ctx;
         std::vector<ParameterDefinition>             parameters; // Parameter definition list
+        bool analysed = false; // Parameters are parsed on first use
     };
     std::unordered_map<std::string, ComponentDefinition> component_definitions_;
 
@@ -269,12 +459,77 @@ private:
     std::unordered_map<std::string, EnumDefinition>   enum_definitions_;
     std::unordered_map<std::string, StructDefinition> struct_definitions_;
 
+    // Enum and struct definitions found in the source but not needed yet
+    std::unordered_map<std::string, SystemRDLParser::Enum_defContext *>   pending_enum_defs_;
+    std::unordered_map<std::string, SystemRDLParser::Struct_defContext *> pending_struct_defs_;
+
+    DefinitionStats definition_stats_;
+
+    // Definition libraries: names already looked up and parse trees already collected. While
+    // collecting a library tree, definitions from the source take precedence.
+    bool load_library_definition(const std::string &name);
+    std::unordered_set<std::string>                    library_lookups_;
+    std::unordered_set<SystemRDLParser::RootContext *> library_trees_;
+    bool                                               collecting_library_ = false;
+
     // Parameter context: parameter values during current instantiation
     std::unordered_map<std::string, PropertyValue> current_parameter_values_;
 
+    // Dynamic property assignments (inst.path->prop = value) are applied once the body
+    // declaring them is complete, so they may refer to instances declared after them and an
+    // enclosing body's assignment overrides a nested one
+    struct PathSegment
+    {
+        uint32_t name;            // Interned instance name without array suffix
+        bool     indexed = false; // With an index only that array element is targeted
+        size_t   index   = 0;
+    };
+    struct DynamicAssignment
+    {
+        std::vector<PathSegment>                             path;
+        std::string                                          property;
+        PropertyValue                                        value;
+        SystemRDLParser::Dynamic_property_assignmentContext *ctx      = nullptr;
+        bool                                                 streamed = false; // Reached a leaf
+    };
+    void apply_dynamic_assignments(
+        ElaboratedNode *scope, const std::vector<DynamicAssignment> &assignments);
+    void apply_dynamic_assignment(
+        ElaboratedNode *node, const DynamicAssignment &assignment, size_t depth);
+    uint32_t intern_path_segment(const std::string &name);
+
+    // Path index: interned segments, and children by segment for the nodes looked into during
+    // one pass (array elements share their base name's bucket, in index order)
+    using ChildIndex = std::unordered_map<uint32_t, std::vector<ElaboratedNode *>>;
+    std::unordered_map<std::string, uint32_t>              path_segment_ids_;
+    std::unordered_map<const ElaboratedNode *, ChildIndex> child_indexes_;
+    const ChildIndex                                      &child_index(const ElaboratedNode *node);
+
+    // Lazy mode: assignments reaching into a deferred body, applied when it is materialized
+    std::unordered_map<const ElaboratedNode *, std::vector<DynamicAssignment>> pending_assignments_;
+
+    // Streaming mode: the assignments of the bodies being elaborated, innermost last. Registers
+    // and memories are released when attached, so the assignments reaching them apply then.
+    struct AssignmentScope
+    {
+        ElaboratedNode                 *scope;
+        std::vector<DynamicAssignment> *assignments;
+    };
+    std::vector<AssignmentScope> assignment_scopes_;
+    void                         apply_enclosing_assignments(ElaboratedNode *leaf);
+
     // Internal elaboration methods
+    std::unique_ptr<ElaboratedAddrmap> elaborate_root(SystemRDLParser::RootContext *ast_root);
+    SystemRDLParser::Component_named_defContext *find_top_addrmap(
+        SystemRDLParser::RootContext *ast_root) const;
+
     void elaborate_component_body(
         SystemRDLParser::Component_bodyContext *body_ctx, ElaboratedNode *parent);
+    void elaborate_instance_body(
+        SystemRDLParser::Component_bodyContext *body_ctx,
+        ElaboratedNode                         *node,
+        ElaboratedNode                         *parent,
+        bool                                    layout_known);
 
     void elaborate_component_definition(
         SystemRDLParser::Component_defContext *comp_def,
@@ -302,6 +557,9 @@ private:
 
     void register_component_definition(SystemRDLParser::Component_named_defContext *named_def);
 
+    // Look up a named definition, analysing it on first use; nullptr if undefined
+    const ComponentDefinition *find_component_definition(const std::string &name);
+
     void elaborate_named_component_instance(
         const std::string                      &type_name,
         SystemRDLParser::Component_instContext *inst_ctx,
@@ -319,12 +577,23 @@ private:
         ElaboratedNode                                  *parent,
         Address                                         &current_address);
 
+    void elaborate_linked_block_instance(
+        const std::string                      &type_name,
+        Size                                    block_size,
+        SystemRDLParser::Component_instContext *inst_ctx,
+        ElaboratedNode                         *parent,
+        Address                                &current_address);
+
     // Property handling methods
     void elaborate_local_property_assignment(
         SystemRDLParser::Local_property_assignmentContext *local_prop, ElaboratedNode *parent);
 
     void elaborate_dynamic_property_assignment(
-        SystemRDLParser::Dynamic_property_assignmentContext *dynamic_prop, ElaboratedNode *parent);
+        SystemRDLParser::Dynamic_property_assignmentContext *dynamic_prop,
+        std::vector<DynamicAssignment>                      &assignments);
+
+    // Set a property and the node state derived from it (regwidth, encode)
+    void apply_property(ElaboratedNode *node, const std::string &name, const PropertyValue &value);
 
     PropertyValue evaluate_property_value(SystemRDLParser::ExprContext *expr_ctx);
 
@@ -372,10 +641,13 @@ private:
         antlr4::ParserRuleContext *ctx = nullptr);
 
     // Instance address validation methods
-    void validate_instance_addresses(ElaboratedNode *parent);
-    void check_instance_address_overlaps(ElaboratedNode *parent);
-    bool instances_overlap(const ElaboratedNode *instance1, const ElaboratedNode *instance2);
+    void validate_instance_addresses(ElaboratedNode *root);
+    void collect_address_spaces(ElaboratedNode *parent, std::vector<ElaboratedNode *> &spaces);
+    void check_instance_address_overlaps(
+        ElaboratedNode *parent, std::vector<PendingError> &pending_errors);
+    static bool ranges_overlap(Address start1, Size size1, Address start2, Size size2);
     void report_instance_overlap_error(
+        std::vector<PendingError> &pending_errors,
         const std::string         &instance1_name,
         const std::string         &instance2_name,
         Address                    addr1_start,
@@ -411,6 +683,10 @@ private:
 
     void register_struct_definition(SystemRDLParser::Struct_defContext *struct_def);
 
+    // Record where an enum/struct is defined; it is registered when first looked up
+    void index_enum_definition(SystemRDLParser::Enum_defContext *enum_def);
+    void index_struct_definition(SystemRDLParser::Struct_defContext *struct_def);
+
     EnumDefinition   *find_enum_definition(const std::string &name);
     StructDefinition *find_struct_definition(const std::string &name);
 
@@ -420,6 +696,11 @@ private:
 
     Address evaluate_address_expression(SystemRDLParser::ExprContext *expr_ctx);
 
+    // Address of an instance relative to its parent: @ if given, else current_address (the end
+    // of the previous instance, see previous_instance_) rounded up to the %= alignment
+    Address instance_base_address(
+        SystemRDLParser::Component_instContext *inst_ctx, Address current_address);
+
     size_t evaluate_integer_expression(SystemRDLParser::ExprContext *expr_ctx);
 
     void calculate_node_size(ElaboratedNode *node);
@@ -427,11 +708,54 @@ private:
     // Register reset value calculation methods
     void        calculate_register_reset_value(ElaboratedReg *reg_node);
     void        validate_register_reset_value(ElaboratedReg *reg_node);
+    void        validate_field_reset_value(ElaboratedField *field, antlr4::ParserRuleContext *ctx);
     std::string uint64_to_binary_string(uint64_t value, size_t width);
     std::string binary_string_to_hex(const std::string &binary);
 
     // Error reporting
-    void report_error(const std::string &message, antlr4::ParserRuleContext *ctx = nullptr);
+    void report_error(
+        const std::string         &message,
+        antlr4::ParserRuleContext *ctx  = nullptr,
+        const char                *code = "elaboration");
+};
+
+// On-demand view of an elaborated design: the top-level layout is elaborated up front and
+// blocks are elaborated the first time a consumer navigates into them. All methods are
+// thread-safe; a node's children and size are final once materialize() returned for it
+// (nodes returned by find_by_path/find_by_address are always materialized).
+class LazyElaboratedModel
+{
+public:
+    explicit LazyElaboratedModel(SystemRDLElaborator::Options options = {});
+
+    // Collect definitions and lay out the top level; the parse trees must outlive the model
+    bool open(
+        SystemRDLParser::RootContext               *ast_root,
+        std::vector<SystemRDLParser::RootContext *> library_roots = {});
+
+    ElaboratedAddrmap *root() const;
+
+    // Dotted instance path including the root name, e.g. "soc.cpu_block[2].ctrl"
+    ElaboratedNode *find_by_path(const std::string &path);
+
+    // Deepest register, memory or container whose address range contains the address
+    ElaboratedNode *find_by_address(Address address);
+
+    bool materialize(ElaboratedNode *node);
+    bool is_materialized(const ElaboratedNode *node) const;
+
+    std::vector<SystemRDLElaborator::ElaborationError> get_errors() const;
+
+private:
+    ElaboratedNode *materialize_locked(ElaboratedNode *node);
+
+    // End of the address range covered by a node and its descendants, materializing the nodes
+    // along the way
+    Address span_end(ElaboratedNode *node);
+
+    mutable std::mutex                 mutex_;
+    SystemRDLElaborator                elaborator_;
+    std::unique_ptr<ElaboratedAddrmap> root_;
 };
 
 // Utility class: elaborated model traverser
@@ -451,7 +775,9 @@ protected:
     void visit(ElaboratedMem &node) override;
 };
 
-// Utility class: address map generator
+// Utility class: address map generator, a projection of the regfile, register and memory rows
+// of a FlatModel (systemrdl_flat.h). Still an ElaboratedModelTraverser for code using it as one,
+// although generate_address_map() no longer traverses.
 class AddressMapGenerator : public ElaboratedModelTraverser
 {
 public:
@@ -465,14 +791,6 @@ public:
     };
 
     std::vector<AddressEntry> generate_address_map(ElaboratedAddrmap &root);
-
-protected:
-    void visit(ElaboratedRegfile &node) override;
-    void visit(ElaboratedReg &node) override;
-    void visit(ElaboratedMem &node) override;
-
-private:
-    std::vector<AddressEntry> address_map_;
 };
 
 } // namespace systemrdl
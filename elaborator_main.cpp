@@ -4,12 +4,29 @@
 #include "cmdline_parser.h"
 #include "elaborator.h"
 #include "systemrdl_api.h"
+#include "systemrdl_columnar.h"
+#include "systemrdl_fanout.h"
+#include "systemrdl_include.h"
+#include "systemrdl_index.h"
+#include "systemrdl_library.h"
+#include "systemrdl_link.h"
+#include "systemrdl_lint.h"
+#include "systemrdl_memory.h"
+#include "systemrdl_ndjson.h"
+#include "systemrdl_preprocessor.h"
+#include "systemrdl_query.h"
+#include "systemrdl_trace.h"
 #include "systemrdl_version.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 using namespace antlr4;
 using namespace systemrdl;
@@ -76,8 +93,16 @@ protected:
 
         std::cout << std::endl;
 
-        // Print properties
+        // Print properties, sorted so the printout does not depend on hash order
+        std::vector<const std::pair<const std::string, PropertyValue> *> properties;
         for (const auto &prop : node.properties) {
+            properties.push_back(&prop);
+        }
+        std::sort(properties.begin(), properties.end(), [](const auto *a, const auto *b) {
+            return a->first < b->first;
+        });
+        for (const auto *entry : properties) {
+            const auto &prop = *entry;
             for (int i = 0; i <= depth_; i++) {
                 std::cout << "  ";
             }
@@ -108,8 +133,109 @@ private:
     int depth_ = 0;
 };
 
+// Stream sink: prints each register/memory as soon as the elaborator finalizes it and passes it on
+// to the exporters added with add_sink()
+class StreamingAddressPrinter : public ElaboratedNodeVisitor
+{
+public:
+    size_t count() const { return count_; }
+    void   add_sink(ElaboratedNodeVisitor *sink) { sinks_.push_back(sink); }
+
+    void visit(ElaboratedAddrmap &node) override {}
+    void visit(ElaboratedRegfile &node) override {}
+    void visit(ElaboratedReg &node) override { print(node); }
+    void visit(ElaboratedField &node) override {}
+    void visit(ElaboratedMem &node) override { print(node); }
+
+private:
+    void print(ElaboratedNode &node)
+    {
+        printf(
+            "0x%08" PRIx64 "  %-6" PRIu64 "  %-18s  %s\n",
+            node.absolute_address,
+            node.size,
+            node.inst_name.c_str(),
+            node.get_hierarchical_path().c_str());
+        count_++;
+        for (auto sink : sinks_) {
+            node.accept_visitor(*sink);
+        }
+    }
+
+    size_t                               count_ = 0;
+    std::vector<ElaboratedNodeVisitor *> sinks_;
+};
+
+// Prints syntax errors of the main file at their position in the unexpanded source
+class SyntaxErrorPrinter : public BaseErrorListener
+{
+public:
+    SyntaxErrorPrinter(const std::string &file, const preprocess::LineMap &line_map)
+        : file_(file)
+        , line_map_(line_map)
+    {}
+
+    void syntaxError(
+        Recognizer * /*recognizer*/,
+        Token * /*offendingSymbol*/,
+        size_t             line,
+        size_t             column,
+        const std::string &msg,
+        std::exception_ptr /*e*/) override
+    {
+        Diagnostic diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.file     = file_;
+        diagnostic.line     = line;
+        diagnostic.column   = line_map_.source_column(line, column);
+        diagnostic.code     = "syntax";
+        diagnostic.message  = msg;
+        std::cerr << diagnostic.to_string() << std::endl;
+    }
+
+private:
+    const std::string         &file_;
+    const preprocess::LineMap &line_map_;
+};
+
+// One line per error, with the source file when it is known and the number of repeats. Columns
+// of errors in main_file are mapped through its macro expansions when line_map is given.
+static void print_elaboration_errors(
+    const std::vector<SystemRDLElaborator::ElaborationError> &errors,
+    const preprocess::LineMap                                *line_map  = nullptr,
+    const std::string                                        &main_file = "")
+{
+    for (const auto &error : errors) {
+        size_t column = line_map && error.file == main_file
+                            ? line_map->source_column(error.line, error.column)
+                            : error.column;
+        if (error.file.empty()) {
+            std::cerr << "  Line " << error.line << ":" << column;
+        } else {
+            std::cerr << "  " << error.file << ":" << error.line << ":" << column;
+        }
+        std::cerr << " - " << error.message;
+        if (error.count > 1) {
+            std::cerr << " (reported " << error.count << " times)";
+        }
+        std::cerr << std::endl;
+    }
+}
+
+// Materialize a whole subtree of a lazy model, e.g. before printing it
+static void materialize_subtree(LazyElaboratedModel &model, ElaboratedNode &node)
+{
+    model.materialize(&node);
+    for (auto &child : node.children) {
+        materialize_subtree(model, *child);
+    }
+}
+
 // Helper function to generate default JSON filename
-std::string get_default_ast_filename(const std::string &input_file, const std::string &suffix = "")
+std::string get_default_ast_filename(
+    const std::string &input_file,
+    const std::string &suffix    = "",
+    const std::string &extension = ".json")
 {
     // Simple basename extraction
     size_t last_slash = input_file.find_last_of("/\\");
@@ -127,7 +253,25 @@ std::string get_default_ast_filename(const std::string &input_file, const std::s
         basename.resize(trim_pos);
     }
 
-    return basename + suffix + ".json";
+    return basename + suffix + extension;
+}
+
+// Fold the JSON phases of the API serialization into the report of the elaboration
+static void merge_json_memory_stats(
+    const systemrdl::memory::MemoryStats &api_stats,
+    const std::string                    &prefix,
+    systemrdl::memory::MemoryStats       &memory_stats)
+{
+    for (const auto &phase : api_stats.phases) {
+        if (phase.name.rfind("json_", 0) == 0) {
+            memory_stats.phases.push_back(phase);
+            memory_stats.phases.back().name = prefix + "." + phase.name.substr(5);
+        }
+    }
+    memory_stats.json_dom_bytes  = std::max(memory_stats.json_dom_bytes, api_stats.json_dom_bytes);
+    memory_stats.json_text_bytes = std::max(
+        memory_stats.json_text_bytes, api_stats.json_text_bytes);
+    memory_stats.peak_rss_bytes  = std::max(memory_stats.peak_rss_bytes, api_stats.peak_rss_bytes);
 }
 
 int main(int argc, char *argv[])
@@ -139,6 +283,91 @@ int main(int argc, char *argv[])
         "a", "ast", "Enable AST JSON output, optionally specify filename");
     cmdline.add_option_with_optional_value(
         "j", "json", "Enable simplified JSON output, optionally specify filename");
+    cmdline.add_option_with_optional_value(
+        "", "ndjson", "Enable JSON Lines output, one object per register/regfile/mem");
+    cmdline.add_option(
+        "",
+        "format",
+        "Encoding of -a/-j output: json, json-min, json-canonical, cbor or msgpack",
+        true,
+        "json");
+    cmdline.add_option(
+        "", "compact-paths", "Simplified JSON: refer to a shared path table, not path arrays");
+    cmdline.add_option(
+        "", "project", "Simplified JSON: keep only these comma-separated node keys", true);
+    cmdline.add_option(
+        "", "trace", "Write Chrome/Perfetto trace-event profile to file", true);
+    cmdline.add_option(
+        "", "memory-stats", "Report peak RSS, per-phase allocations and model footprint");
+    cmdline.add_option(
+        "", "max-errors", "Stop after N distinct errors (0 = unlimited)", true, "0");
+    cmdline.add_option("", "fail-fast", "Stop at the first elaboration error");
+    cmdline.add_option(
+        "t", "top", "Top-level addrmap to elaborate (default: first addrmap in the file)", true);
+    cmdline.add_option(
+        "I", "include-path", "Directories searched for `include files (comma-separated)", true);
+    cmdline.add_option(
+        "D", "define", "Predefine preprocessor macros (NAME or NAME=value, comma-separated)", true);
+    cmdline.add_option(
+        "L", "library", "Load precompiled component libraries (.rdlib, comma-separated)", true);
+    cmdline.add_option(
+        "",
+        "compile-library",
+        "Compile the definitions of the input file into a library file and exit",
+        true);
+    cmdline.add_option(
+        "",
+        "index",
+        "Load definition indexes; indexed files are parsed when used (comma-separated)",
+        true);
+    cmdline.add_option(
+        "",
+        "build-index",
+        "Index the definitions of the input files and directories into a file and exit",
+        true);
+    cmdline.add_option(
+        "", "save-model", "Save the elaborated top-level addrmap as a linkable model file", true);
+    cmdline.add_option(
+        "", "query-index", "Save a name/path/address index for systemrdl_query to a file", true);
+    cmdline.add_option(
+        "",
+        "arrow",
+        "Export registers and fields as Arrow IPC tables <prefix>_registers/_fields.arrow",
+        true);
+    cmdline.add_option(
+        "", "link", "Link separately elaborated addrmap models (comma-separated)", true);
+    cmdline.add_option(
+        "", "timeout", "Abort elaboration after N seconds (0 = no limit)", true, "0");
+    cmdline.add_option(
+        "", "max-nodes", "Abort elaboration after N component instances (0 = no limit)", true, "0");
+    cmdline.add_option(
+        "",
+        "max-memory",
+        "Abort elaboration above N MiB resident memory (0 = no limit)",
+        true,
+        "0");
+    cmdline.add_option(
+        "",
+        "jobs",
+        "Elaborate the top's sub-addrmaps in N worker processes (0 = one per CPU)",
+        true,
+        "1");
+    cmdline.add_option("", "progress", "Report elaboration progress on stderr");
+    cmdline.add_option(
+        "", "stream", "Print registers and memories as they are elaborated, without keeping them");
+    cmdline.add_option(
+        "",
+        "find",
+        "Elaborate and print only the block at a dotted path or address (top.blk[2], 0x4000)",
+        true);
+    cmdline.add_option(
+        "", "check", "Only parse and validate; print diagnostics and skip all output generation");
+    cmdline.add_option("", "lint", "Run the built-in lint rules on the elaborated model");
+    cmdline.add_option(
+        "",
+        "lint-plugin",
+        "Load lint rules from shared libraries (comma-separated, implies --lint)",
+        true);
     cmdline.add_option("h", "help", "Show this help message");
 
     if (!cmdline.parse(argc, argv)) {
@@ -158,42 +387,421 @@ int main(int argc, char *argv[])
 
     std::string inputFile = args[0];
 
+    // Records spans until main() returns; the trace is written on every exit path
+    systemrdl::trace::Session trace_session(cmdline.get_value("trace"));
+
+    // Memory accounting; phases are only recorded when --memory-stats is given
+    bool                            collect_memory = cmdline.is_set("memory-stats");
+    systemrdl::memory::MemoryStats  memory_stats;
+    systemrdl::memory::MemoryStats *mem_stats = collect_memory ? &memory_stats : nullptr;
+
+    memory_stats.allocation_tracking = systemrdl::memory::allocation_tracking_available();
+
+    SystemRDLElaborator::Options elab_options;
+    size_t                       jobs = 1;
+    for (const char *option : {"max-errors", "timeout", "max-nodes", "max-memory", "jobs"}) {
+        try {
+            unsigned long value = std::stoul(cmdline.get_value(option));
+            if (std::string(option) == "jobs") {
+                jobs = value;
+            } else if (std::string(option) == "max-errors") {
+                elab_options.max_errors = value;
+            } else if (std::string(option) == "timeout") {
+                elab_options.timeout = std::chrono::seconds(value);
+            } else if (std::string(option) == "max-nodes") {
+                elab_options.max_nodes = value;
+            } else {
+                elab_options.max_memory_bytes = static_cast<uint64_t>(value) * 1024 * 1024;
+            }
+        } catch (const std::exception &) {
+            std::cerr << "Error: Invalid --" << option << " value: " << cmdline.get_value(option)
+                      << std::endl;
+            return 1;
+        }
+    }
+    // Streaming releases registers as they are printed, so nothing can use the finished model
+    if (cmdline.is_set("stream")) {
+        for (const char *option :
+             {"query-index", "save-model", "ast", "json", "lint", "lint-plugin"}) {
+            if (cmdline.is_set(option)) {
+                std::cerr << "Error: --" << option << " cannot be combined with --stream"
+                          << std::endl;
+                return 1;
+            }
+        }
+        if (jobs != 1) {
+            std::cerr << "Error: --jobs cannot be combined with --stream" << std::endl;
+            return 1;
+        }
+    }
+
+    // The check API elaborates the source alone; linked models are only placed by the full run
+    if (cmdline.is_set("check") && cmdline.is_set("link")) {
+        std::cerr << "Error: --link cannot be combined with --check" << std::endl;
+        return 1;
+    }
+
+    elab_options.fail_fast = cmdline.is_set("fail-fast");
+    elab_options.top       = cmdline.get_value("top");
+    if (cmdline.is_set("progress")) {
+        elab_options.progress_callback = [](const systemrdl::ElaborationProgress &progress) {
+            std::cerr << "[PROGRESS] " << progress.nodes_elaborated << " nodes, "
+                      << progress.elapsed.count() << " ms, at " << progress.current_path
+                      << std::endl;
+        };
+    }
+
+    systemrdl::ElaborateOptions api_options;
+    api_options.collect_memory_stats = collect_memory;
+    api_options.max_errors           = elab_options.max_errors;
+    api_options.fail_fast            = elab_options.fail_fast;
+    api_options.top                  = elab_options.top;
+    api_options.timeout              = elab_options.timeout;
+    api_options.max_nodes            = elab_options.max_nodes;
+    api_options.max_memory_bytes     = elab_options.max_memory_bytes;
+    api_options.progress_callback    = elab_options.progress_callback;
+    api_options.compact_paths        = cmdline.is_set("compact-paths");
+    if (cmdline.is_set("project")) {
+        api_options.projection = systemrdl::Projection::from_list(cmdline.get_value("project"));
+    }
+    if (!systemrdl::parse_output_format(cmdline.get_value("format"), api_options.output_format)) {
+        std::cerr << "Error: Unknown --format value: " << cmdline.get_value("format") << std::endl;
+        return 1;
+    }
+    const std::string output_extension = systemrdl::output_format_extension(
+        api_options.output_format);
+
+    std::stringstream include_paths(cmdline.get_value("include-path"));
+    std::string       include_path;
+    while (std::getline(include_paths, include_path, ',')) {
+        if (!include_path.empty()) {
+            api_options.include_paths.push_back(include_path);
+        }
+    }
+
+    std::stringstream defines(cmdline.get_value("define"));
+    std::string       define;
+    while (std::getline(defines, define, ',')) {
+        size_t equals = define.find('=');
+        if (!define.empty()) {
+            api_options.defines[define.substr(0, equals)] = equals == std::string::npos
+                                                                ? ""
+                                                                : define.substr(equals + 1);
+        }
+    }
+
+    // Definition index over every input file and directory
+    if (cmdline.is_set("build-index")) {
+        std::vector<systemrdl::Diagnostic> diagnostics;
+        auto        index = systemrdl::DefinitionIndex::build(
+            args, diagnostics, api_options.defines);
+        std::string error;
+        size_t      io_errors = 0;
+        for (const auto &diagnostic : diagnostics) {
+            std::cerr << diagnostic.to_string() << std::endl;
+            if (diagnostic.severity == systemrdl::Diagnostic::Severity::Error) {
+                io_errors++;
+            }
+        }
+        if (!index->save(cmdline.get_value("build-index"), &error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        if (io_errors > 0) {
+            // The index is still written, but it misses the definitions of unreadable files
+            std::cerr << "Error: " << io_errors << " path(s) could not be read; "
+                      << cmdline.get_value("build-index") << " is incomplete" << std::endl;
+            return 1;
+        }
+        std::cout << "[OK] Indexed " << index->entries().size() << " definitions into "
+                  << cmdline.get_value("build-index") << std::endl;
+        return 0;
+    }
+
+    // Separate compilation: write the definitions to a library instead of elaborating
+    if (cmdline.is_set("compile-library")) {
+        systemrdl::Result result = systemrdl::file::compile_library(
+            inputFile, cmdline.get_value("compile-library"), api_options);
+        if (!result.ok()) {
+            std::cerr << result.error() << std::endl;
+            return 1;
+        }
+        std::cout << "[OK] " << result.value() << std::endl;
+        return 0;
+    }
+
+    std::stringstream library_paths(cmdline.get_value("library"));
+    std::string       library_path;
+    while (std::getline(library_paths, library_path, ',')) {
+        if (library_path.empty()) {
+            continue;
+        }
+        std::string error;
+        auto        library = systemrdl::ComponentLibrary::load(library_path, &error);
+        if (!library) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        api_options.libraries.push_back(library);
+        elab_options.definition_libraries.push_back(library);
+    }
+
+    std::vector<std::shared_ptr<systemrdl::DefinitionIndex>> indexes;
+
+    std::stringstream index_paths(cmdline.get_value("index"));
+    std::string       index_path;
+    while (std::getline(index_paths, index_path, ',')) {
+        if (index_path.empty()) {
+            continue;
+        }
+        std::string error;
+        auto        index = systemrdl::DefinitionIndex::load(index_path, &error);
+        if (!index) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        index->set_include_paths(api_options.include_paths);
+        index->set_defines(api_options.defines);
+        indexes.push_back(index);
+        api_options.indexes.push_back(index);
+        elab_options.definition_libraries.push_back(index);
+    }
+
+    // Separately elaborated IP blocks: instantiated as placeholders and filled in after elaboration
+    systemrdl::link::Linker  linker;
+    std::vector<std::string> link_models;
+    std::stringstream        model_paths(cmdline.get_value("link"));
+    std::string              model_path;
+    while (std::getline(model_paths, model_path, ',')) {
+        std::string error;
+        if (!model_path.empty() && !linker.add_model_file(model_path, &error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        link_models.push_back(model_path);
+    }
+    elab_options.linked_blocks = linker.linked_blocks();
+
+    // Diagnostics-only mode for pre-submit checks: no model printing, address map or JSON
+    if (cmdline.is_set("check")) {
+        systemrdl::CheckResult result = systemrdl::file::check(inputFile, api_options);
+        for (const auto &diagnostic : result.diagnostics) {
+            std::cerr << diagnostic.to_string() << std::endl;
+        }
+        if (result.aborted) {
+            std::cerr << "Elaboration stopped after " << result.error_count() << " error(s)"
+                      << std::endl;
+        }
+        if (!result.ok()) {
+            std::cerr << "[FAIL] " << inputFile << ": " << result.error_count() << " error(s)"
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "[OK] " << inputFile << ": no errors" << std::endl;
+        return 0;
+    }
+
     try {
         // 1. Parsing phase
         std::cout << "[PARSE] Parsing SystemRDL file: " << inputFile << std::endl;
 
-        std::ifstream stream(inputFile);
-        if (!stream.is_open()) {
+        std::ifstream file(inputFile);
+        if (!file.is_open()) {
             std::cerr << "Error: Cannot open file " << inputFile << std::endl;
             return 1;
         }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
 
-        ANTLRInputStream  input(stream);
-        SystemRDLLexer    lexer(&input);
-        CommonTokenStream tokens(&lexer);
-        SystemRDLParser   parser(&tokens);
+        // Macros are expanded and included files parsed before the lexer sees the buffer
+        std::string                                                        content = buffer.str();
+        std::vector<std::shared_ptr<const systemrdl::include::ParsedFile>> libraries;
+        std::vector<systemrdl::Diagnostic>                                 include_errors;
+        systemrdl::preprocess::LineMap                                     line_map;
+        {
+            systemrdl::memory::PhaseScope     phase(mem_stats, "preprocess");
+            systemrdl::preprocess::MacroTable macros;
+            for (const auto &define : api_options.defines) {
+                macros.define(define.first, define.second);
+            }
+            libraries = systemrdl::include::ParseCache::global().preprocess_buffer(
+                content,
+                inputFile,
+                api_options.include_paths,
+                macros,
+                include_errors,
+                &line_map);
+        }
+        if (!include_errors.empty()) {
+            for (const auto &diagnostic : include_errors) {
+                std::cerr << diagnostic.to_string() << std::endl;
+            }
+            return 1;
+        }
 
-        tree::ParseTree *tree = parser.root();
+        std::istringstream stream(content);
+        ANTLRInputStream   input(stream);
+        SystemRDLLexer     lexer(&input);
+        CommonTokenStream  tokens(&lexer);
+        SystemRDLParser    parser(&tokens);
+        SyntaxErrorPrinter syntax_errors(inputFile, line_map);
+
+        // Tokens name their file, so elaboration errors do too, as with the library API
+        input.name = inputFile;
+        lexer.removeErrorListeners();
+        lexer.addErrorListener(&syntax_errors);
+        parser.removeErrorListeners();
+        parser.addErrorListener(&syntax_errors);
+
+        tree::ParseTree *tree = nullptr;
+        {
+            systemrdl::memory::PhaseScope phase(mem_stats, "parse");
+            systemrdl::trace::Span        span("parse", "parse");
+            span.add_arg("file", inputFile);
+            tree = parser.root();
+        }
 
         if (parser.getNumberOfSyntaxErrors() > 0) {
             std::cerr << "Syntax errors found: " << parser.getNumberOfSyntaxErrors() << std::endl;
             return 1;
         }
 
+        std::vector<SystemRDLParser::RootContext *> library_roots;
+        for (const auto &library : libraries) {
+            library_roots.push_back(library->root);
+        }
+        if (!libraries.empty()) {
+            std::cout << "[OK] Included " << libraries.size() << " file(s)" << std::endl;
+        }
+
         std::cout << "[OK] Parsing successful!" << std::endl;
 
+        // Lazy lookup: only the blocks on the way to the requested one are elaborated
+        if (cmdline.is_set("find")) {
+            std::string         target = cmdline.get_value("find");
+            LazyElaboratedModel model(elab_options);
+            bool opened = model.open(
+                dynamic_cast<SystemRDLParser::RootContext *>(tree), library_roots);
+
+            ElaboratedNode *node = nullptr;
+            if (opened) {
+                bool is_address = !target.empty()
+                                  && std::isdigit(static_cast<unsigned char>(target[0]));
+                try {
+                    node = is_address ? model.find_by_address(std::stoull(target, nullptr, 0))
+                                      : model.find_by_path(target);
+                } catch (const std::exception &) {
+                    std::cerr << "Error: Invalid address: " << target << std::endl;
+                    return 1;
+                }
+                if (node) {
+                    materialize_subtree(model, *node);
+                }
+            }
+
+            print_elaboration_errors(model.get_errors(), &line_map, inputFile);
+            if (!opened || !model.get_errors().empty()) {
+                return 1;
+            }
+            if (!node) {
+                std::cerr << "Error: No instance found for " << target << std::endl;
+                return 1;
+            }
+
+            ElaboratedModelPrinter printer;
+            printer.traverse(*node);
+            return 0;
+        }
+
         // 2. Elaboration phase
         std::cout << "\n[ELAB] Starting elaboration..." << std::endl;
 
-        SystemRDLElaborator elaborator;
-        auto                root_context     = dynamic_cast<SystemRDLParser::RootContext *>(tree);
-        auto                elaborated_model = elaborator.elaborate(root_context);
+        SystemRDLElaborator     elaborator;
+        auto                    root_context = dynamic_cast<SystemRDLParser::RootContext *>(tree);
+        StreamingAddressPrinter stream_printer;
+
+        // Columnar export: filled while streaming, or from the finished model below
+        const std::string arrow_prefix = cmdline.is_set("arrow") ? cmdline.get_value("arrow") : "";
+        systemrdl::columnar::ArrowExporter arrow_exporter;
+        if (!arrow_prefix.empty()) {
+            std::string error;
+            if (!arrow_exporter.open(
+                    arrow_prefix + "_registers.arrow", arrow_prefix + "_fields.arrow", &error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            stream_printer.add_sink(&arrow_exporter);
+        }
+
+        // JSON Lines: registers are written while streaming, or from the finished model below
+        std::string ndjson_file;
+        if (cmdline.is_set("ndjson")) {
+            ndjson_file = cmdline.get_value("ndjson");
+            if (ndjson_file.empty()) {
+                ndjson_file = get_default_ast_filename(inputFile, "", ".ndjson");
+            }
+        }
+        std::ofstream           ndjson_output;
+        systemrdl::NdjsonWriter ndjson_writer(ndjson_output);
+        if (!ndjson_file.empty()) {
+            ndjson_output.open(ndjson_file, std::ios::binary);
+            if (!ndjson_output.is_open()) {
+                std::cerr << "Error: Cannot write JSON Lines output to: " << ndjson_file
+                          << std::endl;
+                return 1;
+            }
+            stream_printer.add_sink(&ndjson_writer);
+        }
+
+        if (cmdline.is_set("stream")) {
+            elab_options.stream_sink = &stream_printer;
+            std::cout << std::left << std::setw(12) << "Address" << std::setw(8) << "Size"
+                      << std::setw(20) << "Name" << "Path" << std::endl;
+            std::cout << std::string(60, '-') << std::endl;
+        }
+        elaborator.set_options(elab_options);
+        elaborator.set_library_roots(library_roots);
+
+        // Fan-out: sub-addrmaps are elaborated by worker processes and linked into the top here
+        bool                               fan_out = jobs != 1;
+        std::unique_ptr<ElaboratedAddrmap> elaborated_model;
+        if (fan_out) {
+            systemrdl::fanout::Driver driver(elab_options, jobs);
+            for (const auto &path : link_models) {
+                driver.linker().add_model_file(path);
+            }
+            {
+                systemrdl::memory::PhaseScope phase(mem_stats, "elaborate");
+                elaborated_model = driver.elaborate(root_context, library_roots);
+            }
+            if (!elaborated_model) {
+                std::cerr << "Elaboration errors:" << std::endl;
+                print_elaboration_errors(driver.get_errors(), &line_map, inputFile);
+                return 1;
+            }
+            std::cout << "[OK] Elaborated " << driver.get_unit_count() << " block(s) in "
+                      << driver.get_worker_count() << " worker process(es)" << std::endl;
+        } else {
+            systemrdl::memory::PhaseScope phase(mem_stats, "elaborate");
+            elaborated_model = elaborator.elaborate(root_context);
+        }
 
         if (elaborator.has_errors()) {
             std::cerr << "Elaboration errors:" << std::endl;
-            for (const auto &error : elaborator.get_errors()) {
-                std::cerr << "  Line " << error.line << ":" << error.column << " - "
-                          << error.message << std::endl;
+            print_elaboration_errors(elaborator.get_errors(), &line_map, inputFile);
+            if (elaborator.get_suppressed_error_count() > 0) {
+                std::cerr << "  " << elaborator.get_suppressed_error_count()
+                          << " duplicate error(s) at already reported locations suppressed"
+                          << std::endl;
+            }
+            if (elaborator.was_aborted()) {
+                std::cerr << "  Elaboration stopped after " << elaborator.get_errors().size()
+                          << " error(s)" << std::endl;
+            }
+            for (const auto &index : indexes) {
+                for (const auto &diagnostic : index->parse_errors()) {
+                    std::cerr << "  " << diagnostic.to_string() << std::endl;
+                }
             }
             return 1;
         }
@@ -205,18 +813,106 @@ int main(int argc, char *argv[])
 
         std::cout << "[OK] Elaboration successful!" << std::endl;
 
+        if (!fan_out && !elab_options.linked_blocks.empty()) {
+            bool linked;
+            {
+                systemrdl::memory::PhaseScope phase(mem_stats, "link");
+                linked = linker.link(*elaborated_model);
+            }
+            if (!linked) {
+                std::cerr << "Link errors:" << std::endl;
+                print_elaboration_errors(linker.get_errors(), &line_map, inputFile);
+                return 1;
+            }
+            std::cout << "[OK] Linked " << linker.get_linked_count() << " block(s)" << std::endl;
+        }
+
+        if (cmdline.is_set("save-model")) {
+            std::string error;
+            if (!systemrdl::link::save_model(
+                    *elaborated_model, cmdline.get_value("save-model"), &error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            std::cout << "[OK] Model saved to " << cmdline.get_value("save-model") << std::endl;
+        }
+
+        if (cmdline.is_set("query-index")) {
+            systemrdl::memory::PhaseScope phase(mem_stats, "query_index");
+            std::string                   error;
+            systemrdl::QueryIndex         index(*elaborated_model);
+            if (!index.save(cmdline.get_value("query-index"), &error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            std::cout << "[OK] Query index written to " << cmdline.get_value("query-index") << " ("
+                      << index.size() << " instances)" << std::endl;
+        }
+
+        if (!arrow_prefix.empty()) {
+            systemrdl::memory::PhaseScope phase(mem_stats, "arrow_export");
+            std::string                   error;
+            if (!cmdline.is_set("stream")) {
+                arrow_exporter.add_model(*elaborated_model);
+            }
+            if (!arrow_exporter.finish(&error)) {
+                std::cerr << "Error: " << error << std::endl;
+                return 1;
+            }
+            std::cout << "[OK] Arrow tables exported: " << arrow_exporter.register_count()
+                      << " register(s), " << arrow_exporter.field_count() << " field(s) to "
+                      << arrow_prefix << "_{registers,fields}.arrow" << std::endl;
+        }
+
+        // In streaming mode only the addrmaps and regfiles are left to write
+        if (!ndjson_file.empty()) {
+            systemrdl::memory::PhaseScope phase(mem_stats, "ndjson");
+            ndjson_writer.write_model(*elaborated_model);
+            ndjson_output.close();
+            if (!ndjson_output) {
+                std::cerr << "Failed to write JSON Lines output to: " << ndjson_file << std::endl;
+                return 1;
+            }
+            std::cout << "[OK] " << ndjson_writer.line_count() << " JSON Lines written to "
+                      << ndjson_file << std::endl;
+        }
+
+        // Streaming mode: registers were printed and released during elaboration
+        if (cmdline.is_set("stream")) {
+            std::cout << "Streamed " << elaborator.get_streamed_node_count()
+                      << " register(s)/memories" << std::endl;
+            if (mem_stats) {
+                std::cout << "\n";
+                systemrdl::memory::print_report(memory_stats, std::cout);
+            }
+            return 0;
+        }
+
+        if (mem_stats) {
+            systemrdl::memory::estimate_model_footprint(*elaborated_model, *mem_stats);
+        }
+
         // 3. Print elaborated model
         std::cout << "\n" << std::string(50, '=') << std::endl;
-        ElaboratedModelPrinter printer;
-        printer.print_model(*elaborated_model);
+        {
+            systemrdl::memory::PhaseScope phase(mem_stats, "print_model");
+            systemrdl::trace::Span        span("print_model", "output");
+            ElaboratedModelPrinter printer;
+            printer.print_model(*elaborated_model);
+        }
 
         // 4. Generate address mapping
         std::cout << "\n" << std::string(50, '=') << std::endl;
         std::cout << "[ADDR] Address Map:" << std::endl;
         std::cout << std::string(50, '=') << std::endl;
 
-        AddressMapGenerator addr_gen;
-        auto                address_map = addr_gen.generate_address_map(*elaborated_model);
+        std::vector<AddressMapGenerator::AddressEntry> address_map;
+        {
+            systemrdl::memory::PhaseScope phase(mem_stats, "address_map");
+            systemrdl::trace::Span        span("generate_address_map", "output");
+            AddressMapGenerator    addr_gen;
+            address_map = addr_gen.generate_address_map(*elaborated_model);
+        }
 
         std::cout << std::left << std::setw(12) << "Address" << std::setw(8) << "Size"
                   << std::setw(20) << "Name" << "Path" << std::endl;
@@ -224,28 +920,71 @@ int main(int argc, char *argv[])
 
         for (const auto &entry : address_map) {
             printf(
-                "0x%08lx  %-6lu  %-18s  %s\n",
+                "0x%08" PRIx64 "  %-6" PRIu64 "  %-18s  %s\n",
                 entry.address,
                 entry.size,
                 entry.name.c_str(),
                 entry.path.c_str());
         }
 
-        // 5. Generate AST JSON output if requested
+        // 5. Lint the elaborated model if requested
+        if (cmdline.is_set("lint") || cmdline.is_set("lint-plugin")) {
+            systemrdl::lint::LintEngine engine;
+            engine.add_builtin_rules();
+
+            std::stringstream plugins(cmdline.get_value("lint-plugin"));
+            std::string       plugin;
+            while (std::getline(plugins, plugin, ',')) {
+                std::string error;
+                if (!plugin.empty() && !engine.load_plugin(plugin, &error)) {
+                    std::cerr << "Error: Cannot load lint plugin " << error << std::endl;
+                    return 1;
+                }
+            }
+
+            std::vector<systemrdl::lint::LintFinding> findings;
+            {
+                systemrdl::memory::PhaseScope phase(mem_stats, "lint");
+                findings = engine.run(*elaborated_model);
+            }
+
+            std::cout << "\n" << std::string(50, '=') << std::endl;
+            std::cout << "[LINT] " << engine.rules().size() << " rule(s), " << findings.size()
+                      << " finding(s)" << std::endl;
+            std::cout << std::string(50, '=') << std::endl;
+
+            size_t lint_errors = 0;
+            for (const auto &finding : findings) {
+                std::cout << finding.to_diagnostic(inputFile).to_string() << std::endl;
+                if (finding.severity == systemrdl::Diagnostic::Severity::Error) {
+                    lint_errors++;
+                }
+            }
+            if (lint_errors > 0) {
+                std::cerr << "[FAIL] Lint found " << lint_errors << " error(s)" << std::endl;
+                return 1;
+            }
+        }
+
+        // 6. Generate AST JSON output if requested
         if (cmdline.is_set("ast")) {
             std::string output_file = cmdline.get_value("ast");
 
             // If no filename provided, generate default
             if (output_file.empty()) {
-                output_file = get_default_ast_filename(inputFile, "_ast_elaborated");
+                output_file = get_default_ast_filename(
+                    inputFile, "_ast_elaborated", output_extension);
             }
 
             std::cout << "\nGenerating AST JSON output..." << std::endl;
 
-            // Use unified API for consistent JSON output
-            systemrdl::Result result = systemrdl::file::elaborate(inputFile);
+            // The model elaborated above, including linked and fanned-out blocks
+            systemrdl::ElaborateStats api_stats;
+            systemrdl::Result         result = systemrdl::model_to_json(
+                *elaborated_model, api_options, &api_stats);
+            merge_json_memory_stats(api_stats.memory, "ast_json", memory_stats);
             if (result.ok()) {
-                std::ofstream outFile(output_file);
+                std::ofstream outFile(output_file, std::ios::binary);
                 if (outFile.is_open()) {
                     outFile << result.value();
                     outFile.close();
@@ -260,21 +999,24 @@ int main(int argc, char *argv[])
             }
         }
 
-        // 6. Generate simplified JSON output if requested
+        // 7. Generate simplified JSON output if requested
         if (cmdline.is_set("json")) {
             std::string output_file = cmdline.get_value("json");
 
             // If no filename provided, generate default
             if (output_file.empty()) {
-                output_file = get_default_ast_filename(inputFile, "_simplified");
+                output_file = get_default_ast_filename(inputFile, "_simplified", output_extension);
             }
 
             std::cout << "\nGenerating simplified JSON output..." << std::endl;
 
-            // Use unified API for consistent JSON output
-            systemrdl::Result result = systemrdl::file::elaborate_simplified(inputFile);
+            // The model elaborated above, including linked and fanned-out blocks
+            systemrdl::ElaborateStats api_stats;
+            systemrdl::Result         result = systemrdl::model_to_simplified_json(
+                *elaborated_model, api_options, &api_stats);
+            merge_json_memory_stats(api_stats.memory, "simplified_json", memory_stats);
             if (result.ok()) {
-                std::ofstream outFile(output_file);
+                std::ofstream outFile(output_file, std::ios::binary);
                 if (outFile.is_open()) {
                     outFile << result.value();
                     outFile.close();
@@ -290,6 +1032,21 @@ int main(int argc, char *argv[])
             }
         }
 
+        if (mem_stats) {
+            std::cout << "\n";
+            systemrdl::memory::print_report(memory_stats, std::cout);
+        }
+
+        if (!trace_session.filename().empty()) {
+            if (trace_session.finish()) {
+                std::cout << "\nTrace written to: " << trace_session.filename() << std::endl;
+            } else {
+                std::cerr << "Failed to write trace to: " << trace_session.filename()
+                          << std::endl;
+                return 1;
+            }
+        }
+
         std::cout << "\nElaboration completed successfully!" << std::endl;
 
     } catch (const std::exception &e) {
@@ -0,0 +1,216 @@
+#include "cmdline_parser.h"
+#include "systemrdl_link.h"
+#include "systemrdl_query.h"
+#include "systemrdl_version.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+std::string hex_address(systemrdl::Address address)
+{
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "0x%08llx", static_cast<unsigned long long>(address));
+    return buffer;
+}
+
+// "0x4002_1000", "0x40021000" or decimal; underscores are ignored
+bool parse_address(const std::string &text, systemrdl::Address &address)
+{
+    std::string digits;
+    for (char c : text) {
+        if (c != '_') {
+            digits += c;
+        }
+    }
+    if (digits.empty()) {
+        return false;
+    }
+    char *end = nullptr;
+    address   = std::strtoull(digits.c_str(), &end, 0);
+    return *end == '\0';
+}
+
+bool parse_kind(const std::string &name, systemrdl::FlatModel::Kind &kind)
+{
+    for (int k = 0; k < systemrdl::FlatModel::KIND_COUNT; k++) {
+        if (name == systemrdl::FlatModel::kind_name(static_cast<systemrdl::FlatModel::Kind>(k))) {
+            kind = static_cast<systemrdl::FlatModel::Kind>(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+void print_row(const systemrdl::QueryIndex &index, uint32_t row)
+{
+    std::cout << hex_address(index.address(row)) << "  " << std::left;
+    std::cout.width(8);
+    std::cout << systemrdl::FlatModel::kind_name(index.kind(row)) << index.path(row);
+    if (index.kind(row) == systemrdl::FlatModel::FIELD) {
+        std::cout << " [" << index.msb(row) << ":" << index.lsb(row) << "]";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Setup command line parser
+    CmdLineParser cmdline(
+        "SystemRDL Query - Look up registers by name, path or address in a prebuilt index");
+    cmdline.set_version(systemrdl::get_detailed_version());
+    cmdline.add_option("f", "find", "Instances whose name matches a glob (*_INT_STATUS)", true);
+    cmdline.add_option("u", "under", "Restrict --find to the blocks at a dotted path (pcie)", true);
+    cmdline.add_option(
+        "k", "kind", "Restrict --find to addrmap, regfile, reg, field or mem instances", true);
+    cmdline.add_option("p", "path", "Instances at a dotted path of globs (pcie[1].CTRL)", true);
+    cmdline.add_option("a", "address", "Register or memory at an address (0x4002_1000)", true);
+    cmdline.add_option("", "save", "Write the index of a model file (.rdlm) to a file", true);
+    cmdline.add_option("", "time", "Report the load and query times");
+    cmdline.add_option("h", "help", "Show this help message");
+
+    if (!cmdline.parse(argc, argv)) {
+        return argc == 2
+                       && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h"
+                           || std::string(argv[1]) == "--version" || std::string(argv[1]) == "-v")
+                   ? 0
+                   : 1;
+    }
+
+    const auto &args = cmdline.get_positional_args();
+    if (args.empty()) {
+        std::cerr << "Error: No index (.rdlqx) or model (.rdlm) file specified" << std::endl;
+        cmdline.print_help();
+        return 1;
+    }
+
+    using Clock       = std::chrono::steady_clock;
+    auto microseconds = [](Clock::time_point since) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since)
+            .count();
+    };
+
+    const bool  timing = cmdline.is_set("time");
+    std::string input  = args[0];
+    std::string error;
+    auto        started = Clock::now();
+
+    // A saved model is indexed on load; an index file is used as is
+    std::unique_ptr<systemrdl::QueryIndex> index;
+    if (input.size() > 5 && input.compare(input.size() - 5, 5, ".rdlm") == 0) {
+        auto model = systemrdl::link::load_model(input, &error);
+        if (model) {
+            index = std::make_unique<systemrdl::QueryIndex>(*model);
+        }
+    } else {
+        index = systemrdl::QueryIndex::load(input, &error);
+    }
+    if (!index) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    if (timing) {
+        std::cout << "Loaded " << index->size() << " instance(s) in " << microseconds(started)
+                  << " us" << std::endl;
+    }
+
+    if (cmdline.is_set("save")) {
+        if (!index->save(cmdline.get_value("save"), &error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "[OK] Query index written to " << cmdline.get_value("save") << " ("
+                  << index->size() << " instances)" << std::endl;
+    }
+
+    size_t matches = 0;
+
+    if (cmdline.is_set("find")) {
+        bool                       any_kind = !cmdline.is_set("kind");
+        systemrdl::FlatModel::Kind kind     = systemrdl::FlatModel::REG;
+        if (!any_kind && !parse_kind(cmdline.get_value("kind"), kind)) {
+            std::cerr << "Error: Unknown --kind value: " << cmdline.get_value("kind") << std::endl;
+            return 1;
+        }
+
+        started = Clock::now();
+        std::vector<uint32_t> scopes{systemrdl::QueryIndex::NONE};
+        if (cmdline.is_set("under")) {
+            scopes = index->find_path(cmdline.get_value("under"));
+        }
+        std::vector<uint32_t> rows;
+        for (uint32_t scope : scopes) {
+            for (uint32_t row : index->find(cmdline.get_value("find"), scope)) {
+                // Nested scopes (pcie matching at two levels) would report a row twice
+                if ((any_kind || index->kind(row) == kind) && (rows.empty() || row > rows.back())) {
+                    rows.push_back(row);
+                }
+            }
+        }
+        auto elapsed = microseconds(started);
+
+        for (uint32_t row : rows) {
+            print_row(*index, row);
+        }
+        matches += rows.size();
+        if (timing) {
+            std::cout << rows.size() << " match(es) in " << elapsed << " us" << std::endl;
+        }
+    }
+
+    if (cmdline.is_set("path")) {
+        started      = Clock::now();
+        auto rows    = index->find_path(cmdline.get_value("path"));
+        auto elapsed = microseconds(started);
+
+        for (uint32_t row : rows) {
+            print_row(*index, row);
+        }
+        matches += rows.size();
+        if (timing) {
+            std::cout << rows.size() << " match(es) in " << elapsed << " us" << std::endl;
+        }
+    }
+
+    if (cmdline.is_set("address")) {
+        systemrdl::Address address = 0;
+        if (!parse_address(cmdline.get_value("address"), address)) {
+            std::cerr << "Error: Invalid --address value: " << cmdline.get_value("address")
+                      << std::endl;
+            return 1;
+        }
+
+        started      = Clock::now();
+        uint32_t row = index->decode(address);
+        auto elapsed = microseconds(started);
+
+        if (row != systemrdl::QueryIndex::NONE) {
+            std::cout << hex_address(address) << " -> " << index->path(row) << " + 0x" << std::hex
+                      << address - index->address(row) << std::dec << std::endl;
+            print_row(*index, row);
+            for (uint32_t child = row + 1; child < index->subtree_end(row); child++) {
+                if (index->kind(child) == systemrdl::FlatModel::FIELD) {
+                    print_row(*index, child);
+                }
+            }
+            matches++;
+        } else {
+            std::cout << hex_address(address) << " is not mapped" << std::endl;
+        }
+        if (timing) {
+            std::cout << "Decoded in " << elapsed << " us" << std::endl;
+        }
+    }
+
+    if (!cmdline.is_set("find") && !cmdline.is_set("path") && !cmdline.is_set("address")) {
+        if (!cmdline.is_set("save")) {
+            std::cout << input << ": " << index->size() << " instance(s)" << std::endl;
+        }
+        return 0;
+    }
+    return matches > 0 ? 0 : 1;
+}
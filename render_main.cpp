@@ -2,6 +2,7 @@
 #include "SystemRDLParser.h"
 #include "cmdline_parser.h"
 #include "systemrdl_api.h"
+#include "systemrdl_trace.h"
 #include "systemrdl_version.h"
 #include <algorithm>
 #include <fstream>
@@ -36,6 +37,10 @@ int main(int argc, char *argv[])
         .add_option_with_optional_value("o", "output", "Output file (default: auto-generated name)");
     cmdline.add_option(
         "", "ast", "Use full AST JSON format instead of simplified JSON (default: simplified)");
+    cmdline.add_option(
+        "", "project", "Emit only the simplified JSON keys the template refers to");
+    cmdline.add_option(
+        "", "trace", "Write Chrome/Perfetto trace-event profile to file", true);
     cmdline.add_option("", "verbose", "Enable verbose output");
     cmdline.add_option("h", "help", "Show this help message");
 
@@ -66,6 +71,7 @@ int main(int argc, char *argv[])
     std::string template_file = cmdline.get_value("template");
     bool        verbose       = cmdline.is_set("verbose");
     bool use_ast = cmdline.is_set("ast"); // Default to simplified JSON unless --ast is specified
+    bool project = cmdline.is_set("project") && !use_ast;
 
     // Detect input file type
     std::string file_ext = get_file_extension(input_file);
@@ -87,7 +93,31 @@ int main(int argc, char *argv[])
                   << std::endl;
     }
 
+    // Records spans until main() returns; the trace is written on every exit path
+    systemrdl::trace::Session trace_session(cmdline.get_value("trace"));
+
     try {
+        // Derive the projection from the keys the template refers to
+        systemrdl::ElaborateOptions options;
+        if (project) {
+            std::ifstream template_stream(template_file);
+            if (!template_stream) {
+                std::cerr << "Error: Cannot open template file: " << template_file << std::endl;
+                return 1;
+            }
+            std::string template_text(
+                (std::istreambuf_iterator<char>(template_stream)),
+                std::istreambuf_iterator<char>());
+            options.projection = systemrdl::Projection::from_template(template_text);
+            if (verbose) {
+                std::cout << "Projected keys:";
+                for (const auto &key : options.projection->keys) {
+                    std::cout << " " << key;
+                }
+                std::cout << std::endl;
+            }
+        }
+
         // Get elaborated JSON - different path for CSV vs RDL
         auto elaborate_result = systemrdl::Result::success("");
 
@@ -114,14 +144,15 @@ int main(int argc, char *argv[])
             if (use_ast) {
                 elaborate_result = systemrdl::elaborate(csv_to_rdl_result.value());
             } else {
-                elaborate_result = systemrdl::elaborate_simplified(csv_to_rdl_result.value());
+                elaborate_result
+                    = systemrdl::elaborate_simplified(csv_to_rdl_result.value(), options);
             }
         } else {
             // Direct RDL -> Elaborate
             if (use_ast) {
                 elaborate_result = systemrdl::file::elaborate(input_file);
             } else {
-                elaborate_result = systemrdl::file::elaborate_simplified(input_file);
+                elaborate_result = systemrdl::file::elaborate_simplified(input_file, options);
             }
         }
 
@@ -139,6 +170,7 @@ int main(int argc, char *argv[])
         // Parse the JSON string to nlohmann::json for Inja
         json elaborated_json;
         try {
+            systemrdl::trace::Span span("json_parse", "output");
             elaborated_json = json::parse(elaborate_result.value());
         } catch (const json::parse_error &e) {
             std::cerr << "Failed to parse elaborated JSON: " << e.what() << std::endl;
@@ -155,7 +187,12 @@ int main(int argc, char *argv[])
         // Disable line statements
         env.set_line_statement("");
         // Render template
-        std::string rendered_content = env.render_file(template_file, elaborated_json);
+        std::string rendered_content;
+        {
+            systemrdl::trace::Span span("render_template", "output");
+            span.add_arg("template", template_file);
+            rendered_content = env.render_file(template_file, elaborated_json);
+        }
 
         if (verbose) {
             std::cout << "Successfully rendered template" << std::endl;
@@ -205,6 +242,15 @@ int main(int argc, char *argv[])
             std::cout << output_file << std::endl;
         }
 
+        if (!trace_session.finish()) {
+            std::cerr << "Error: Cannot write trace file: " << trace_session.filename()
+                      << std::endl;
+            return 1;
+        }
+        if (verbose && !trace_session.filename().empty()) {
+            std::cout << "Trace written to: " << trace_session.filename() << std::endl;
+        }
+
         return 0;
 
     } catch (const std::exception &e) {
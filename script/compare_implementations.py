@@ -5,6 +5,7 @@ Compare SystemRDL implementations: Python (systemrdl-compiler) vs C++ (systemrdl
 
 import glob
 import os
+import re
 import subprocess
 import sys
 from pathlib import Path
@@ -87,8 +88,8 @@ class ImplementationComparator:
             ):
                 # Clean up the error message
                 error = line.strip()
-                # For C++ format, remove "Line X:Y - " prefix
-                if " - " in error and "Line " in error:
+                # For C++ format, remove "Line X:Y - " or "file:X:Y - " prefix
+                if re.match(r"(Line \d+|\S+:\d+):\d+ - ", error):
                     error = error.split(" - ", 1)[1]
                 # For Python format, extract after file:line:col
                 elif ":" in error:
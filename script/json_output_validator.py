@@ -9,18 +9,142 @@ and can also run end-to-end tests to generate and validate simplified JSON outpu
 import argparse
 import json
 import os
+import struct
 import subprocess
 import sys
 import tempfile
 from pathlib import Path
 from typing import Any, Dict, List, Optional
 
+# Exit code of a test that cannot run here, e.g. --arrow without pyarrow (CTest SKIP_RETURN_CODE)
+SKIP_EXIT_CODE = 77
+
+# Column names and types of the --arrow tables, as pyarrow prints them
+ARROW_DICTIONARY = "dictionary<values=string, indices=int32, ordered=0>"
+ARROW_SCHEMAS = {
+    "registers": [
+        ("id", "uint32"),
+        ("path", "string"),
+        ("name", ARROW_DICTIONARY),
+        ("address", "uint64"),
+        ("size", "uint64"),
+        ("width", "uint32"),
+        ("reset", "uint64"),
+        ("desc", "string"),
+    ],
+    "fields": [
+        ("register_id", "uint32"),
+        ("name", ARROW_DICTIONARY),
+        ("lsb", "uint32"),
+        ("msb", "uint32"),
+        ("width", "uint32"),
+        ("reset", "uint64"),
+        ("sw", ARROW_DICTIONARY),
+        ("hw", ARROW_DICTIONARY),
+        ("onread", ARROW_DICTIONARY),
+        ("onwrite", ARROW_DICTIONARY),
+        ("desc", "string"),
+    ],
+}
+
+
+def decode_cbor(data: bytes) -> Any:
+    """Decode the CBOR subset written by the elaborator (no tags or indefinite lengths)"""
+
+    def item(pos: int):
+        major, info = data[pos] >> 5, data[pos] & 0x1F
+        pos += 1
+        if major == 7:
+            if info in (20, 21, 22):
+                return [False, True, None][info - 20], pos
+            fmt, size = {25: (">e", 2), 26: (">f", 4), 27: (">d", 8)}[info]
+            return struct.unpack_from(fmt, data, pos)[0], pos + size
+        if info < 24:
+            arg = info
+        else:
+            size = 1 << (info - 24)
+            arg = int.from_bytes(data[pos : pos + size], "big")
+            pos += size
+        if major == 0:
+            return arg, pos
+        if major == 1:
+            return -1 - arg, pos
+        if major in (2, 3):
+            raw = data[pos : pos + arg]
+            return (raw if major == 2 else raw.decode("utf-8")), pos + arg
+        if major == 4:
+            values = []
+            for _ in range(arg):
+                value, pos = item(pos)
+                values.append(value)
+            return values, pos
+        if major == 5:
+            values = {}
+            for _ in range(arg):
+                key, pos = item(pos)
+                values[key], pos = item(pos)
+            return values, pos
+        raise ValueError(f"unsupported CBOR major type {major}")
+
+    return item(0)[0]
+
+
+def decode_msgpack(data: bytes) -> Any:
+    """Decode the MessagePack subset written by the elaborator (no extension types)"""
+
+    def sequence(pos: int, count: int, is_map: bool):
+        values = {} if is_map else []
+        for _ in range(count):
+            value, pos = item(pos)
+            if is_map:
+                values[value], pos = item(pos)
+            else:
+                values.append(value)
+        return values, pos
+
+    def item(pos: int):
+        byte = data[pos]
+        pos += 1
+        if byte <= 0x7F:
+            return byte, pos
+        if byte >= 0xE0:
+            return byte - 0x100, pos
+        if 0x80 <= byte <= 0x8F:
+            return sequence(pos, byte & 0x0F, True)
+        if 0x90 <= byte <= 0x9F:
+            return sequence(pos, byte & 0x0F, False)
+        if 0xA0 <= byte <= 0xBF:
+            length = byte & 0x1F
+            return data[pos : pos + length].decode("utf-8"), pos + length
+        if byte in (0xC0, 0xC2, 0xC3):
+            return {0xC0: None, 0xC2: False, 0xC3: True}[byte], pos
+        if byte in (0xCA, 0xCB):
+            size = 4 if byte == 0xCA else 8
+            return struct.unpack_from(">f" if size == 4 else ">d", data, pos)[0], pos + size
+        if 0xCC <= byte <= 0xD3:
+            size = 1 << ((byte - 0xCC) % 4)
+            signed = byte >= 0xD0
+            return int.from_bytes(data[pos : pos + size], "big", signed=signed), pos + size
+        if byte in (0xD9, 0xDA, 0xDB, 0xC4, 0xC5, 0xC6):
+            size = {0xD9: 1, 0xDA: 2, 0xDB: 4, 0xC4: 1, 0xC5: 2, 0xC6: 4}[byte]
+            length = int.from_bytes(data[pos : pos + size], "big")
+            raw = data[pos + size : pos + size + length]
+            return (raw.decode("utf-8") if byte >= 0xD9 else raw), pos + size + length
+        if byte in (0xDC, 0xDD, 0xDE, 0xDF):
+            size = 2 if byte in (0xDC, 0xDE) else 4
+            count = int.from_bytes(data[pos : pos + size], "big")
+            return sequence(pos + size, count, byte >= 0xDE)
+        raise ValueError(f"unsupported MessagePack type 0x{byte:02x}")
+
+    return item(0)[0]
+
 
 class JsonValidator:
     def __init__(self, verbose: bool = True):
         self.errors = []
         self.warnings = []
         self.verbose = verbose
+        self.path_count = None  # Entries of the compact schema's path table
 
     def log_error(self, msg: str):
         self.errors.append(msg)
@@ -84,6 +208,13 @@ class JsonValidator:
         if not self.validate_addrmap(data["addrmap"]):
             return False
 
+        # Compact schema: paths are indexes into a shared path table
+        self.path_count = None
+        if data.get("schema") == "compact":
+            if not self.validate_path_table(data.get("paths")):
+                return False
+            self.path_count = len(data["paths"])
+
         # Validate registers array
         if not isinstance(data["registers"], list):
             self.log_error("Registers field must be an array")
@@ -133,6 +264,37 @@ class JsonValidator:
 
         return True
 
+    def validate_path_table(self, paths: Any) -> bool:
+        """Validate the path table of the compact schema"""
+        if not isinstance(paths, list) or len(paths) == 0:
+            self.log_error("Compact schema requires a non-empty paths array")
+            return False
+
+        for i, entry in enumerate(paths):
+            if not isinstance(entry, dict) or "name" not in entry or "absolute_address" not in entry:
+                self.log_error(f"Path entry {i} must have name and absolute_address")
+                return False
+            if i == 0 and "parent" in entry:
+                self.log_error("The first path entry is the root and must not have a parent")
+                return False
+            # Entries are in preorder, so a parent always comes first
+            if i > 0 and (not isinstance(entry.get("parent"), int) or not 0 <= entry["parent"] < i):
+                self.log_error(f"Path entry {i} must refer to an earlier parent entry")
+                return False
+
+        return True
+
+    def validate_path_reference(self, value: Any, path: str) -> bool:
+        """Validate a path reference: an array in the default schema, a path table index in the compact one"""
+        if self.path_count is None:
+            if not isinstance(value, list):
+                self.log_error(f"Path must be an array at {path}")
+                return False
+        elif not isinstance(value, int) or not 0 <= value < self.path_count:
+            self.log_error(f"Path must be an index into the path table at {path}")
+            return False
+        return True
+
     def validate_regfile(self, regfile: Dict[str, Any], path: str) -> bool:
         """Validate regfile structure"""
         required_fields = ["inst_name", "absolute_address", "path", "size"]
@@ -155,8 +317,7 @@ class JsonValidator:
             return False
 
         # Validate path
-        if not isinstance(regfile["path"], list):
-            self.log_error(f"Path must be an array at {path}")
+        if not self.validate_path_reference(regfile["path"], path):
             return False
 
         # Validate size
@@ -172,7 +333,9 @@ class JsonValidator:
             self.log_error(f"Register at {path} must be an object")
             return False
 
-        required_fields = ["inst_name", "absolute_address", "path", "path_abs", "fields"]
+        required_fields = ["inst_name", "absolute_address", "path", "fields"]
+        if self.path_count is None:
+            required_fields.append("path_abs")
         for field in required_fields:
             if field not in register:
                 self.log_error(f"Missing required field '{field}' in register at {path}")
@@ -191,7 +354,9 @@ class JsonValidator:
             return False
 
         # Validate path arrays
-        if not isinstance(register["path"], list) or not isinstance(register["path_abs"], list):
+        if not self.validate_path_reference(register["path"], path):
+            return False
+        if self.path_count is None and not isinstance(register["path_abs"], list):
             self.log_error(f"Path and path_abs must be arrays at {path}")
             return False
 
@@ -262,6 +427,55 @@ class JsonValidator:
 
         return True
 
+    def check_expectations(self, data: Dict[str, Any], expectations: List[str]) -> bool:
+        """Check "inst.path->key=value", "inst.path->key" (present) and "!inst.path->key" (absent)
+
+        Instance paths are the dotted regfile, register and field names below the addrmaps,
+        e.g. "chan[2].status.mode"; a "*" segment matches any name. Output projected without
+        "path" names registers from their own name. Values are parsed as JSON if possible and
+        compared as strings otherwise.
+        """
+        instances = []
+        for kind in ("regfiles", "registers"):
+            for item in data.get(kind, []):
+                path = item.get("path", [])
+                if not isinstance(path, list):
+                    self.log_error("Expectations need path arrays, not the compact path table")
+                    return False
+                name = ".".join(path + [item["inst_name"]])
+                instances.append((name, item))
+                for field in item.get("fields", []):
+                    instances.append((f"{name}.{field['inst_name']}", field))
+
+        def matches(pattern: str, name: str) -> bool:
+            wanted, segments = pattern.split("."), name.split(".")
+            return len(wanted) == len(segments) and all(w in ("*", s) for w, s in zip(wanted, segments))
+
+        errors_before = len(self.errors)
+        for expectation in expectations:
+            failed = len(self.errors)
+            absent = expectation.startswith("!")
+            target, _, value_text = expectation.lstrip("!").partition("=")
+            pattern, _, key = target.partition("->")
+            matched = [item for name, item in instances if matches(pattern, name)]
+            if not key or not matched:
+                self.log_error(f"Expectation '{expectation}' matches no instance property")
+                continue
+            try:
+                value = json.loads(value_text)
+            except json.JSONDecodeError:
+                value = value_text
+            for item in matched:
+                if absent and key in item:
+                    self.log_error(f"{expectation}: '{key}' is present")
+                elif not absent and key not in item:
+                    self.log_error(f"{expectation}: '{key}' is missing")
+                elif not absent and value_text and item[key] != value:
+                    self.log_error(f"{expectation}: '{key}' is {item[key]!r}")
+            if len(self.errors) == failed:
+                self.log_success(f"{expectation} ({len(matched)} instance(s))")
+        return len(self.errors) == errors_before
+
     def validate_field(self, field: Dict[str, Any], path: str) -> bool:
         """Validate individual field"""
         if not isinstance(field, dict):
@@ -365,6 +579,289 @@ class JsonTester:
         except (FileNotFoundError, OSError):
             return 0
 
+    def run_compact_paths_test(
+        self, elaborator_exe: str, rdl_file: str, temp_path: Path, json_data: Dict[str, Any]
+    ) -> bool:
+        """Check that --compact-paths output expands to the paths of the default schema"""
+        if self.verbose:
+            print("  Testing compact path table...")
+        compact_output = temp_path / f"{Path(rdl_file).stem}_compact.json"
+        if not self.run_command([elaborator_exe, rdl_file, f"--json={compact_output}", "--compact-paths"]):
+            self.validator.log_error("Elaborator failed with --compact-paths")
+            return False
+
+        compact = self.validator.validate_json_file(str(compact_output))
+        if not compact or not self.validator.validate_simplified_json(compact):
+            return False
+        self.validator.path_count = None
+
+        def expand(index: int):
+            names, addresses = [], []
+            while index is not None:
+                entry = compact["paths"][index]
+                names.insert(0, entry["name"])
+                addresses.insert(0, entry["absolute_address"])
+                index = entry.get("parent")
+            return names, addresses
+
+        for kind in ("registers", "regfiles"):
+            for full, reduced in zip(json_data.get(kind, []), compact.get(kind, [])):
+                names, addresses = expand(reduced["path"])
+                if names != full["path"] or (kind == "registers" and addresses != full["path_abs"]):
+                    self.validator.log_error(f"Compact path of {full['inst_name']} differs: {names}")
+                    return False
+
+        self.validator.log_success("Compact path table matches the default paths")
+        return True
+
+    def run_canonical_test(
+        self, elaborator_exe: str, rdl_file: str, temp_path: Path, json_data: Dict[str, Any]
+    ) -> bool:
+        """Check that --format json-canonical is byte-stable across job counts and in canonical form
+
+        --jobs 4 elaborates the top's sub-addrmaps in worker processes and writes the JSON from the
+        merged model, so for such designs the two runs take different paths. Designs without
+        sub-addrmaps elaborate in-process both times; the fanout_matches_in_process_* CTests compare
+        both paths on test/fanout/soc_fanout.rdl.
+        """
+        if self.verbose:
+            print("  Testing canonical JSON output...")
+        outputs = []
+        for jobs in (1, 4):
+            output = temp_path / f"{Path(rdl_file).stem}_canonical_j{jobs}.json"
+            command = [elaborator_exe, rdl_file, f"--json={output}", "--format", "json-canonical", "--jobs", str(jobs)]
+            if not self.run_command(command):
+                self.validator.log_error(f"Elaborator failed with --format json-canonical --jobs {jobs}")
+                return False
+            outputs.append(output.read_bytes())
+
+        if outputs[0] != outputs[1]:
+            self.validator.log_error("Canonical JSON differs between in-process (--jobs 1) and fan-out (--jobs 4) runs")
+            return False
+        document = json.loads(outputs[0])
+        if document != json_data:
+            self.validator.log_error("Canonical JSON carries a different document than the JSON output")
+            return False
+        expected = json.dumps(
+            document, sort_keys=True, separators=(",", ":"), ensure_ascii=True
+        ).encode("ascii")
+        if outputs[0] != expected:
+            self.validator.log_error("Canonical JSON is not in canonical form (sorted keys, no whitespace, ASCII)")
+            return False
+
+        self.validator.log_success("Canonical JSON is byte-identical for --jobs 1 and 4 and in canonical form")
+        return True
+
+    def run_binary_formats_test(
+        self, elaborator_exe: str, rdl_file: str, temp_path: Path, json_data: Dict[str, Any]
+    ) -> bool:
+        """Check that the json-min, CBOR and MessagePack outputs decode to the JSON document"""
+        if self.verbose:
+            print("  Testing binary and minified output formats...")
+        decoders = {
+            "json-min": lambda raw: json.loads(raw.decode("utf-8")),
+            "cbor": decode_cbor,
+            "msgpack": decode_msgpack,
+        }
+        for name, decode in decoders.items():
+            output = temp_path / f"{Path(rdl_file).stem}_simplified.{name}"
+            if not self.run_command([elaborator_exe, rdl_file, f"--json={output}", "--format", name]):
+                self.validator.log_error(f"Elaborator failed with --format {name}")
+                return False
+            try:
+                document = decode(output.read_bytes())
+            except Exception as e:
+                self.validator.log_error(f"Cannot decode --format {name} output: {e}")
+                return False
+            if document != json_data:
+                self.validator.log_error(f"--format {name} output differs from the JSON output")
+                return False
+            self.validator.log_success(
+                f"--format {name} output matches the JSON output ({self.get_file_size(str(output))} bytes)"
+            )
+        return True
+
+    def run_trace_test(self, elaborator_exe: str, rdl_file: str, temp_path: Path) -> bool:
+        """Check that --trace writes a trace-event document with the pipeline spans"""
+        if self.verbose:
+            print("  Testing trace output...")
+        output = temp_path / f"{Path(rdl_file).stem}_trace.json"
+        if not self.run_command([elaborator_exe, rdl_file, f"--trace={output}"]):
+            self.validator.log_error("Elaborator failed with --trace")
+            return False
+        try:
+            events = json.loads(output.read_text(encoding="utf-8"))["traceEvents"]
+        except (OSError, ValueError, KeyError) as e:
+            self.validator.log_error(f"Cannot load trace file: {e}")
+            return False
+
+        spans = [event for event in events if event.get("ph") == "X"]
+        threads = {event["tid"] for event in events if event.get("name") == "thread_name"}
+        for span in spans:
+            if span["tid"] not in threads or span["dur"] < 0:
+                self.validator.log_error(f"Trace span '{span['name']}' has no thread or a negative duration")
+                return False
+
+        names = {span["name"] for span in spans}
+        missing = {"parse", "elaborate", "collect_definitions", "validate_instance_addresses"} - names
+        if missing:
+            self.validator.log_error(f"Trace is missing spans: {', '.join(sorted(missing))}")
+            return False
+        if not any("top" in span.get("args", {}) for span in spans if span["name"] == "elaborate"):
+            self.validator.log_error("Trace span 'elaborate' does not name the top addrmap")
+            return False
+
+        self.validator.log_success(f"Trace has {len(spans)} spans covering parse, elaborate and validation")
+        return True
+
+    def run_arrow_test(
+        self, elaborator_exe: str, rdl_file: str, temp_path: Path, json_data: Dict[str, Any]
+    ) -> bool:
+        """Check that the --arrow tables load with pyarrow and hold the registers and fields of the JSON output"""
+        import pyarrow
+        import pyarrow.ipc
+
+        if self.verbose:
+            print("  Testing Arrow table output...")
+
+        tables = {}
+        for mode, options in (("model", []), ("stream", ["--stream"])):
+            prefix = temp_path / f"{Path(rdl_file).stem}_{mode}"
+            if not self.run_command([elaborator_exe, rdl_file, "--arrow", str(prefix), *options]):
+                self.validator.log_error(f"Elaborator failed with --arrow {' '.join(options)}")
+                return False
+            try:
+                tables[mode] = {
+                    name: pyarrow.ipc.open_file(f"{prefix}_{name}.arrow").read_all() for name in ARROW_SCHEMAS
+                }
+            except (OSError, pyarrow.ArrowInvalid) as e:
+                self.validator.log_error(f"Cannot read Arrow table: {e}")
+                return False
+
+        registers, fields = tables["model"]["registers"], tables["model"]["fields"]
+        for name, table in tables["model"].items():
+            schema = [(field.name, str(field.type)) for field in table.schema]
+            if schema != ARROW_SCHEMAS[name]:
+                self.validator.log_error(f"Arrow {name} schema differs: {schema}")
+                return False
+
+        # Rows are the JSON registers in the same order, fields grouped by register id
+        expected = json_data.get("registers", [])
+        rows = registers.to_pylist()
+        if [row["id"] for row in rows] != list(range(len(expected))):
+            self.validator.log_error("Arrow register ids are not the row numbers")
+            return False
+        fields_by_register: Dict[int, List[Dict[str, Any]]] = {}
+        for field in fields.to_pylist():
+            fields_by_register.setdefault(field["register_id"], []).append(field)
+        if not set(fields_by_register) <= set(range(len(rows))):
+            self.validator.log_error("Arrow field rows refer to unknown register ids")
+            return False
+
+        for row, register in zip(rows, expected):
+            if (row["name"], row["address"], row["width"]) != (
+                register["inst_name"],
+                int(register["absolute_address"], 16),
+                register.get("register_width", row["width"]),
+            ):
+                self.validator.log_error(f"Arrow register {row['path']} differs from the JSON output")
+                return False
+            actual_fields = fields_by_register.get(row["id"], [])
+            if len(actual_fields) != len(register["fields"]) or any(
+                field["name"] != json_field["inst_name"]
+                or field["lsb"] != json_field.get("lsb", field["lsb"])
+                or field["msb"] != json_field.get("msb", field["msb"])
+                for field, json_field in zip(actual_fields, register["fields"])
+            ):
+                self.validator.log_error(f"Arrow fields of {row['path']} differ from the JSON output")
+                return False
+
+        # Streaming emits registers as they complete, so compare rows independent of order and ids
+        def content(mode: str) -> Any:
+            register_rows = tables[mode]["registers"].to_pylist()
+            addresses = {row.pop("id"): row["address"] for row in register_rows}
+            field_rows = tables[mode]["fields"].to_pylist()
+            for row in field_rows:
+                row["register_id"] = addresses[row["register_id"]]
+            return sorted(tuple(row.values()) for row in register_rows), sorted(
+                tuple(row.values()) for row in field_rows
+            )
+
+        if content("stream") != content("model"):
+            self.validator.log_error("Arrow tables written with --stream differ from the finished-model tables")
+            return False
+
+        self.validator.log_success(
+            f"Arrow tables match the JSON output ({registers.num_rows} registers, {fields.num_rows} fields)"
+        )
+        return True
+
+    def run_ndjson_test(
+        self, elaborator_exe: str, rdl_file: str, temp_path: Path, json_data: Dict[str, Any]
+    ) -> bool:
+        """Check that every --ndjson line parses and matches the paths and fields of the JSON output"""
+        if self.verbose:
+            print("  Testing JSON Lines output...")
+        output = temp_path / f"{Path(rdl_file).stem}.ndjson"
+        if not self.run_command([elaborator_exe, rdl_file, f"--ndjson={output}"]):
+            self.validator.log_error("Elaborator failed with --ndjson")
+            return False
+
+        lines = []
+        for number, text in enumerate(output.read_text(encoding="utf-8").splitlines(), 1):
+            try:
+                lines.append(json.loads(text))
+            except json.JSONDecodeError as e:
+                self.validator.log_error(f"JSON Lines line {number} does not parse: {e}")
+                return False
+
+        # Simplified paths name the enclosing regfiles and memories but not the addrmaps
+        addrmaps = {line["path"] for line in lines if line["type"] == "addrmap"}
+
+        def simplified_path(dotted: str) -> List[str]:
+            segments = dotted.split(".")
+            return [
+                name for depth, name in enumerate(segments[:-1]) if ".".join(segments[: depth + 1]) not in addrmaps
+            ]
+
+        for kind, line_type in (("registers", "reg"), ("regfiles", "regfile")):
+            expected = [(item["path"], item["inst_name"]) for item in json_data.get(kind, [])]
+            actual = [
+                (simplified_path(line["path"]), line["path"].rsplit(".", 1)[-1])
+                for line in lines
+                if line["type"] == line_type
+            ]
+            if actual != expected:
+                self.validator.log_error(f"JSON Lines {kind} paths differ from the JSON output")
+                return False
+
+        registers = [line for line in lines if line["type"] == "reg"]
+        for register, line in zip(json_data.get("registers", []), registers):
+            if line["fields"] != register["fields"]:
+                self.validator.log_error(f"JSON Lines fields of {line['path']} differ from the JSON output")
+                return False
+
+        self.validator.log_success(f"JSON Lines output matches the JSON output ({len(lines)} lines)")
+        return True
+
+    def run_arrow_end_to_end_test(self, elaborator_exe: str, rdl_file: str) -> bool:
+        """Check the --arrow tables against the simplified JSON output; needs pyarrow"""
+        elaborator_exe = os.path.abspath(elaborator_exe)
+        rdl_file = os.path.abspath(rdl_file)
+        if not all([self.check_executable(elaborator_exe), self.check_rdl_file(rdl_file)]):
+            return False
+
+        with tempfile.TemporaryDirectory(prefix="arrow_test_") as temp_dir:
+            temp_path = Path(temp_dir)
+            json_output = temp_path / f"{Path(rdl_file).stem}_simplified.json"
+            if not self.run_command([elaborator_exe, rdl_file, f"--json={json_output}"]):
+                self.validator.log_error("Elaborator failed to generate simplified JSON")
+                return False
+            json_data = self.validator.validate_json_file(str(json_output))
+            if not json_data:
+                return False
+            return self.run_arrow_test(elaborator_exe, rdl_file, temp_path, json_data)
+
     def run_end_to_end_test(self, elaborator_exe: str, rdl_file: str) -> bool:
         """Run complete end-to-end simplified JSON test"""
 
@@ -425,6 +922,26 @@ class JsonTester:
                 if not json_data or not self.validator.validate_simplified_json(json_data):
                     return False
 
+                # The compact schema must describe the same paths
+                if not self.run_compact_paths_test(elaborator_exe, rdl_file, temp_path, json_data):
+                    return False
+
+                # Canonical output must be byte-stable
+                if not self.run_canonical_test(elaborator_exe, rdl_file, temp_path, json_data):
+                    return False
+
+                # Minified and binary encodings must carry the same document
+                if not self.run_binary_formats_test(elaborator_exe, rdl_file, temp_path, json_data):
+                    return False
+
+                # Each JSON Lines record must describe the same registers and regfiles
+                if not self.run_ndjson_test(elaborator_exe, rdl_file, temp_path, json_data):
+                    return False
+
+                # The profile must load as JSON and name the pipeline stages
+                if not self.run_trace_test(elaborator_exe, rdl_file, temp_path):
+                    return False
+
                 # Test default filename generation
                 if self.verbose:
                     print("  Testing default filename generation...")
@@ -460,10 +977,24 @@ def main():
     # Validation mode arguments
     parser.add_argument("--json", help="Path to simplified JSON file")
     parser.add_argument("--rdl", help="Path to original RDL file (for context)")
+    parser.add_argument(
+        "--expect",
+        action="append",
+        default=[],
+        help='Property the --json file must have: "inst.path->key=value", "inst.path->key" or "!inst.path->key"',
+    )
+    parser.add_argument(
+        "--projected", action="store_true", help="The --json file was written with --project: only check --expect"
+    )
 
     # End-to-end test mode arguments
     parser.add_argument("--test", action="store_true", help="Run end-to-end simplified JSON test")
     parser.add_argument("--elaborator", help="Path to systemrdl_elaborator executable")
+    parser.add_argument(
+        "--arrow",
+        action="store_true",
+        help=f"With --test: only check the --arrow tables; exits with {SKIP_EXIT_CODE} if pyarrow is not installed",
+    )
 
     # Common options
     parser.add_argument("--strict", action="store_true", help="Treat warnings as errors")
@@ -510,7 +1041,15 @@ def main():
             sys.exit(1)
 
         tester = JsonTester(verbose=not args.quiet)
-        success = tester.run_end_to_end_test(args.elaborator, args.rdl)
+        if args.arrow:
+            try:
+                import pyarrow  # noqa: F401
+            except ImportError:
+                print("\nTest SKIPPED: pyarrow is not installed")
+                sys.exit(SKIP_EXIT_CODE)
+            success = tester.run_arrow_end_to_end_test(args.elaborator, args.rdl)
+        else:
+            success = tester.run_end_to_end_test(args.elaborator, args.rdl)
 
         if not success or tester.validator.errors:
             print("\nTest FAILED")
@@ -534,7 +1073,10 @@ def main():
             print(f"Validating simplified JSON: {args.json}")
         json_data = validator.validate_json_file(args.json)
         if json_data:
-            validator.validate_simplified_json(json_data)
+            if not args.projected:
+                validator.validate_simplified_json(json_data)
+            if args.expect:
+                validator.check_expectations(json_data, args.expect)
 
         # Summary
         if not args.quiet:
@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""
+SystemRDL Performance Regression Test
+Generates large SystemRDL designs at two sizes, runs systemrdl_elaborator on them and
+checks that wall time and peak memory grow close to linearly between the sizes. This
+catches quadratic behaviour regardless of how fast the machine is.
+
+Slowdowns that stay linear are caught against baselines. Times are divided by the time
+systemrdl_parser takes on a fixed calibration design on the same machine, so a stored
+baseline holds on faster and slower machines; peak memory is compared as measured.
+
+Sizes, tolerances and baselines come from test/perf_config.json; --update-baseline
+writes the measured values back to it. A design without a baseline fails the run.
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+try:
+    import resource  # POSIX only; peak memory is skipped elsewhere
+except ImportError:  # pragma: no cover - Windows
+    resource = None
+
+
+def find_tool_executable(tool_name):
+    """Find the tool executable in build directory or PATH"""
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent
+    for build_dir in ["build", "build-release", "build-debug"]:
+        for root in [Path("."), project_root]:
+            tool_path = root / build_dir / tool_name
+            if tool_path.exists() and tool_path.is_file():
+                return str(tool_path)
+
+    try:
+        result = subprocess.run(["which", tool_name], capture_output=True, text=True)
+        if result.returncode == 0:
+            return result.stdout.strip()
+    except FileNotFoundError:
+        pass
+
+    return None
+
+
+# ---------------------------------------------------------------------------
+# Design generators. Each returns SystemRDL text for a design with `count` registers.
+# ---------------------------------------------------------------------------
+
+
+def generate_flat_regs(count):
+    """Many register instances directly in one addrmap"""
+    lines = [
+        "reg perf_ctrl_t {",
+        "    field { sw = rw; hw = r; } enable[0:0] = 0;",
+        "    field { sw = rw; hw = r; } mode[3:1] = 0;",
+        "    field { sw = r; hw = w; } status[15:8] = 0;",
+        "    field { sw = rw; hw = r; } data[31:16] = 0;",
+        "};",
+        "",
+        "addrmap perf_flat_regs {",
+    ]
+    for i in range(count):
+        lines.append(f"    perf_ctrl_t reg_{i} @ 0x{i * 4:x};")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def generate_regfile_array(count):
+    """Arrays of register files, 16 registers each"""
+    regs_per_file = 16
+    lines = [
+        "reg perf_data_t {",
+        "    field { sw = rw; hw = rw; } data[31:0] = 0;",
+        "};",
+        "",
+        "regfile perf_block_t {",
+    ]
+    for i in range(regs_per_file):
+        lines.append(f"    perf_data_t data_{i} @ 0x{i * 4:x};")
+    lines.extend(
+        [
+            "};",
+            "",
+            "addrmap perf_regfile_array {",
+            f"    perf_block_t block[{max(1, count // regs_per_file)}] @ 0x0 += 0x{regs_per_file * 4:x};",
+            "};",
+        ]
+    )
+    return "\n".join(lines) + "\n"
+
+
+def generate_dense_fields(count):
+    """Registers with 32 single-bit fields, stressing field validation and reset calculation"""
+    lines = ["reg perf_flags_t {"]
+    for bit in range(32):
+        lines.append(f"    field {{ sw = rw; hw = r; }} flag_{bit}[{bit}:{bit}] = {bit % 2};")
+    lines.extend(["};", "", "addrmap perf_dense_fields {"])
+    for i in range(count):
+        lines.append(f"    perf_flags_t flags_{i} @ 0x{i * 4:x};")
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+GENERATORS = {
+    "flat_regs": generate_flat_regs,
+    "regfile_array": generate_regfile_array,
+    "dense_fields": generate_dense_fields,
+}
+
+
+# ---------------------------------------------------------------------------
+# Measurement
+# ---------------------------------------------------------------------------
+
+
+def run_measured(cmd, timeout):
+    """Run a command, returning (returncode, wall seconds, peak RSS in MiB or None)"""
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    if resource is not None and hasattr(os, "wait4"):
+        # wait4 reports the resource usage of this child only
+        deadline = start + timeout
+        while True:
+            pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+            if pid != 0:
+                break
+            if time.perf_counter() > deadline:
+                proc.kill()
+                os.wait4(proc.pid, 0)
+                raise subprocess.TimeoutExpired(cmd, timeout)
+            time.sleep(0.005)
+        elapsed = time.perf_counter() - start
+        proc.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, "waitstatus_to_exitcode") else status
+        # ru_maxrss is kilobytes on Linux and bytes on macOS
+        divisor = 1024 * 1024 if platform.system() == "Darwin" else 1024
+        peak_mib = usage.ru_maxrss / divisor
+        return proc.returncode, elapsed, peak_mib
+
+    proc.wait(timeout=timeout)
+    elapsed = time.perf_counter() - start
+    return proc.returncode, elapsed, None
+
+
+def measure_benchmark(elaborator, rdl_file, json_file, repeat, timeout):
+    """Measure one design: best wall time and peak memory over `repeat` runs"""
+    best_time = None
+    best_mem = None
+    for _ in range(repeat):
+        cmd = [elaborator, str(rdl_file), f"--json={json_file}"]
+        returncode, elapsed, peak_mib = run_measured(cmd, timeout)
+        if returncode != 0:
+            raise RuntimeError(f"elaborator exited with code {returncode} on {rdl_file}")
+        best_time = elapsed if best_time is None else min(best_time, elapsed)
+        if peak_mib is not None:
+            best_mem = peak_mib if best_mem is None else min(best_mem, peak_mib)
+    return {"time_s": round(best_time, 4), "peak_rss_mib": None if best_mem is None else round(best_mem, 2)}
+
+
+def measure_calibration(parser, temp_path, registers, repeat, timeout):
+    """Best time of systemrdl_parser on a fixed design, the unit for the time baselines"""
+    rdl_file = temp_path / "calibration.rdl"
+    rdl_file.write_text(generate_flat_regs(registers), encoding="utf-8")
+    best_time = None
+    for _ in range(repeat):
+        returncode, elapsed, _ = run_measured([parser, str(rdl_file)], timeout)
+        if returncode != 0:
+            raise RuntimeError(f"parser exited with code {returncode} on the calibration design")
+        best_time = elapsed if best_time is None else min(best_time, elapsed)
+    return best_time
+
+
+# ---------------------------------------------------------------------------
+# Checks
+# ---------------------------------------------------------------------------
+
+
+def check_scaling(design, small, large, size_ratio, tolerances):
+    """Return regression messages if cost grows clearly faster than the design size"""
+    failures = []
+    allowed = size_ratio * tolerances["scaling"]
+
+    if small["time_s"] > 0:
+        time_ratio = large["time_s"] / small["time_s"]
+        if time_ratio > allowed:
+            failures.append(
+                f"{design}: time grows {time_ratio:.1f}x for {size_ratio:.0f}x more registers (limit {allowed:.1f}x)"
+            )
+
+    if small.get("peak_rss_mib") and large.get("peak_rss_mib"):
+        mem_ratio = large["peak_rss_mib"] / small["peak_rss_mib"]
+        if mem_ratio > allowed:
+            failures.append(
+                f"{design}: peak RSS grows {mem_ratio:.1f}x for {size_ratio:.0f}x more registers (limit {allowed:.1f}x)"
+            )
+    return failures
+
+
+def check_baseline(design, large, calibration_s, baseline, tolerances):
+    """Return regression messages if the large design is slower or larger than its baseline"""
+    failures = []
+    allowed = tolerances["baseline"]
+
+    relative_time = large["time_s"] / calibration_s
+    if relative_time > baseline["relative_time"] * allowed:
+        failures.append(
+            f"{design}: takes {relative_time:.2f}x the calibration time, baseline {baseline['relative_time']:.2f}x "
+            f"(limit {baseline['relative_time'] * allowed:.2f}x)"
+        )
+
+    if large.get("peak_rss_mib") and baseline.get("peak_rss_mib"):
+        if large["peak_rss_mib"] > baseline["peak_rss_mib"] * allowed:
+            failures.append(
+                f"{design}: peak RSS {large['peak_rss_mib']:.1f} MiB, baseline {baseline['peak_rss_mib']:.1f} MiB "
+                f"(limit {baseline['peak_rss_mib'] * allowed:.1f} MiB)"
+            )
+    return failures
+
+
+def load_config(path):
+    default = {
+        "tolerances": {"scaling": 1.5, "baseline": 1.5},
+        "sizes": {"small": 1000, "large": 4000},
+        "calibration": {"registers": 20000},
+        "baselines": {},
+    }
+    if not path.exists():
+        return default
+    with open(path, "r", encoding="utf-8") as f:
+        data = json.load(f)
+    for key, value in default.items():
+        data.setdefault(key, value)
+    for key, value in default["tolerances"].items():
+        data["tolerances"].setdefault(key, value)
+    return data
+
+
+def save_config(path, config):
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump(config, f, indent=2, sort_keys=True)
+        f.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run SystemRDL performance regression benchmarks")
+    parser.add_argument("--elaborator", help="Path to systemrdl_elaborator executable")
+    parser.add_argument("--parser", help="Path to systemrdl_parser executable, timed for calibration")
+    parser.add_argument("--config", help="Sizes and tolerances (default: test/perf_config.json)")
+    parser.add_argument("--repeat", type=int, default=3, help="Runs per benchmark; the best one is kept (default: 3)")
+    parser.add_argument("--timeout", type=float, default=300.0, help="Timeout per elaborator run in seconds")
+    parser.add_argument("--scale", type=float, default=1.0, help="Multiply design sizes (for local experiments)")
+    parser.add_argument("--no-scaling-check", action="store_true", help="Only report the measurements")
+    parser.add_argument(
+        "--update-baseline", action="store_true", help="Store the measurements as baselines in the config file"
+    )
+    args = parser.parse_args()
+
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent
+
+    elaborator = args.elaborator or find_tool_executable("systemrdl_elaborator")
+    if not elaborator or not Path(elaborator).exists():
+        print("[FAIL] systemrdl_elaborator not found (use --elaborator)")
+        return 1
+    rdl_parser = args.parser or find_tool_executable("systemrdl_parser")
+    if not rdl_parser or not Path(rdl_parser).exists():
+        print("[FAIL] systemrdl_parser not found (use --parser)")
+        return 1
+
+    config_path = Path(args.config) if args.config else project_root / "test" / "perf_config.json"
+    config = load_config(config_path)
+    tolerances = config["tolerances"]
+    small_size = max(1, int(config["sizes"]["small"] * args.scale))
+    large_size = max(1, int(config["sizes"]["large"] * args.scale))
+    # Baselines were measured at the configured sizes
+    check_baselines = args.scale == 1.0 and not args.no_scaling_check
+
+    print("SystemRDL Performance Regression Test")
+    print(f"Elaborator: {elaborator}")
+    print(f"Config:     {config_path}")
+    print(f"Sizes:      {small_size} / {large_size} registers")
+    print("=" * 60)
+
+    failures = []
+    baselines = {}
+    with tempfile.TemporaryDirectory(prefix="systemrdl_perf_") as temp_dir:
+        temp_path = Path(temp_dir)
+        try:
+            calibration_s = measure_calibration(
+                rdl_parser, temp_path, config["calibration"]["registers"], max(1, args.repeat), args.timeout
+            )
+        except (RuntimeError, subprocess.TimeoutExpired) as e:
+            print(f"[FAIL] calibration: {e}")
+            return 1
+        print(f"  {'calibration':<24} {calibration_s:>8.3f}s")
+
+        for design, generator in GENERATORS.items():
+            measured = {}
+            for label, size in (("small", small_size), ("large", large_size)):
+                name = f"{design}_{label}"
+                rdl_file = temp_path / f"{name}.rdl"
+                rdl_file.write_text(generator(size), encoding="utf-8")
+                try:
+                    result = measure_benchmark(
+                        elaborator, rdl_file, temp_path / f"{name}.json", max(1, args.repeat), args.timeout
+                    )
+                except (RuntimeError, subprocess.TimeoutExpired) as e:
+                    failures.append(f"{name}: {e}")
+                    print(f"  [FAIL] {name}: {e}")
+                    continue
+
+                measured[label] = result
+                mem_text = "n/a" if result["peak_rss_mib"] is None else f"{result['peak_rss_mib']:.1f} MiB"
+                print(f"  {name:<24} {result['time_s']:>8.3f}s  {mem_text:>12}")
+
+            if not args.no_scaling_check and "small" in measured and "large" in measured:
+                failures.extend(
+                    check_scaling(design, measured["small"], measured["large"], large_size / small_size, tolerances)
+                )
+
+            if "large" not in measured:
+                continue
+            large = measured["large"]
+            baselines[design] = {
+                "relative_time": round(large["time_s"] / calibration_s, 3),
+                "peak_rss_mib": large["peak_rss_mib"],
+            }
+            baseline = config["baselines"].get(design)
+            if check_baselines and baseline:
+                failures.extend(check_baseline(design, large, calibration_s, baseline, tolerances))
+            elif check_baselines and not args.update_baseline:
+                # Without a baseline a linear slowdown would pass unnoticed
+                failures.append(f"{design}: no baseline in {config_path.name} (record one with --update-baseline)")
+
+    print("=" * 60)
+
+    if args.update_baseline:
+        if args.scale != 1.0 or len(baselines) != len(GENERATORS):
+            print("[FAIL] Baselines are only stored for a complete run at the configured sizes")
+            return 1
+        config["baselines"] = baselines
+        save_config(config_path, config)
+        print(f"[OK] Baselines stored in {config_path}")
+        return 0
+
+    if failures:
+        print("[FAIL] Performance regressions detected:")
+        for failure in failures:
+            print(f"  - {failure}")
+        return 1
+
+    print("[OK] No performance regressions detected")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -38,7 +38,7 @@ def find_tool_executable(tool_name):
     return None
 
 
-def run_template_render(rdl_file, template_file, output_file=None, verbose=False, use_ast=False):
+def run_template_render(rdl_file, template_file, output_file=None, verbose=False, use_ast=False, project=False):
     """Run systemrdl_render tool with specified parameters"""
     tool_path = find_tool_executable("systemrdl_render")
     if not tool_path:
@@ -50,6 +50,8 @@ def run_template_render(rdl_file, template_file, output_file=None, verbose=False
         cmd.extend(["-o", output_file])
     if use_ast:
         cmd.append("--ast")  # Use full AST JSON instead of simplified (default)
+    if project:
+        cmd.append("--project")  # Emit only the JSON keys the template refers to
     if verbose:
         cmd.append("--verbose")
 
@@ -274,6 +276,51 @@ def test_template_rendering():
         return False
 
 
+def test_projection():
+    """Rendering with --project must give the same output as rendering without it"""
+    print("\n[PROJECT] Testing template-derived projection")
+    print("-" * 40)
+
+    project_root = Path(__file__).parent.parent
+    test_dir = project_root / "test"
+    template_files = sorted(test_dir.glob("test_j2_json_*.j2"))
+    rdl_files = [test_dir / "test_basic_chip.rdl", test_dir / "test_regfile_array.rdl"]
+    rdl_files = [rdl_file for rdl_file in rdl_files if rdl_file.exists()]
+
+    passed = 0
+    total = 0
+    with tempfile.TemporaryDirectory() as temp_dir:
+        for template_file in template_files:
+            for rdl_file in rdl_files:
+                total += 1
+                name = f"{rdl_file.stem}_{template_file.stem}"
+                full_output = os.path.join(temp_dir, f"{name}.full")
+                projected_output = os.path.join(temp_dir, f"{name}.projected")
+
+                success, output = run_template_render(str(rdl_file), str(template_file), full_output)
+                if success:
+                    success, output = run_template_render(
+                        str(rdl_file), str(template_file), projected_output, project=True
+                    )
+                if not success:
+                    print(f"  [FAIL] {name}: rendering failed: {output}")
+                    continue
+
+                with open(full_output, "r", encoding="utf-8") as f:
+                    full_content = f.read()
+                with open(projected_output, "r", encoding="utf-8") as f:
+                    projected_content = f.read()
+                if full_content != projected_content:
+                    print(f"  [FAIL] {name}: projected output differs from the full output")
+                    continue
+
+                print(f"  [OK] {name}: identical output ({len(full_content)} chars)")
+                passed += 1
+
+    print(f"[SUMMARY] Projection tests: {passed}/{total}")
+    return passed == total
+
+
 def test_error_conditions():
     """Test error conditions and edge cases"""
     print("\n[ERROR] Testing Error Conditions")
@@ -343,6 +390,10 @@ def main():
     if not test_template_rendering():
         success = False
 
+    # Run projection tests
+    if not test_projection():
+        success = False
+
     # Run error condition tests
     if not test_error_conditions():
         success = False
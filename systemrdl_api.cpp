@@ -4,6 +4,13 @@
 #include "SystemRDLParser.h"
 #include "antlr4-runtime.h"
 #include "elaborator.h"
+#include "systemrdl_include.h"
+#include "systemrdl_index.h"
+#include "systemrdl_library.h"
+#include "systemrdl_memory.h"
+#include "systemrdl_ndjson.h"
+#include "systemrdl_path.h"
+#include "systemrdl_trace.h"
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
@@ -35,17 +42,34 @@ public:
         const std::string &msg,
         std::exception_ptr /*e*/) override
     {
+        if (line_map) {
+            column = line_map->source_column(line, column);
+        }
         if (!buffer_.empty()) {
             buffer_ += '\n';
         }
         buffer_ += "line " + std::to_string(line) + ":" + std::to_string(column) + " " + msg;
+
+        Diagnostic diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.file     = file;
+        diagnostic.line     = line;
+        diagnostic.column   = column;
+        diagnostic.code     = "syntax";
+        diagnostic.message  = msg;
+        diagnostics_.push_back(std::move(diagnostic));
     }
 
-    bool               hasErrors() const noexcept { return !buffer_.empty(); }
-    const std::string &joined() const noexcept { return buffer_; }
+    bool                           hasErrors() const noexcept { return !buffer_.empty(); }
+    const std::string             &joined() const noexcept { return buffer_; }
+    const std::vector<Diagnostic> &diagnostics() const noexcept { return diagnostics_; }
+
+    const preprocess::LineMap *line_map = nullptr; // Reports columns of the unexpanded source
+    std::string                file;               // Parsed file, empty for in-memory content
 
 private:
-    std::string buffer_;
+    std::string             buffer_;
+    std::vector<Diagnostic> diagnostics_;
 };
 
 } // namespace
@@ -59,10 +83,38 @@ struct ParseContext
     std::unique_ptr<SystemRDLParser>           parser;
     SystemRDLParser::RootContext              *tree;
     CapturingErrorListener                     listener;
+    preprocess::LineMap                        line_map;
+
+    // Included files in elaboration order, and errors of the preprocessor and included files
+    std::vector<std::shared_ptr<const include::ParsedFile>> libraries;
+    std::vector<Diagnostic>                                 include_errors;
 
-    ParseContext(std::string_view content)
+    // Without options, `include directives are removed but not followed
+    ParseContext(
+        std::string_view        content,
+        const std::string      &filename = "",
+        const ElaborateOptions *options  = nullptr)
     {
-        std::string        content_str(content);
+        trace::Span span("parse", "parse");
+        if (span.active()) {
+            span.add_arg("bytes", std::to_string(content.size()));
+        }
+
+        std::string            content_str(content);
+        preprocess::MacroTable macros;
+        if (options) {
+            for (const auto &define : options->defines) {
+                macros.define(define.first, define.second);
+            }
+            libraries = include::ParseCache::global().preprocess_buffer(
+                content_str, filename, options->include_paths, macros, include_errors, &line_map);
+        } else {
+            auto expanded  = preprocess::run(content_str, macros);
+            line_map       = std::move(expanded.line_map);
+            include_errors = std::move(expanded.diagnostics);
+        }
+        listener.line_map = &line_map;
+        listener.file     = filename;
         std::istringstream content_stream(content_str);
 
         input  = std::make_unique<antlr4::ANTLRInputStream>(content_stream);
@@ -70,6 +122,9 @@ struct ParseContext
         tokens = std::make_unique<antlr4::CommonTokenStream>(lexer.get());
         parser = std::make_unique<SystemRDLParser>(tokens.get());
 
+        // Tokens name their file, so elaboration errors do too
+        input->name = filename;
+
         // Replace ANTLR4's default ConsoleErrorListener so syntax errors
         // do not leak to stderr. They are accumulated in `listener` and
         // surfaced through Result::error() instead.
@@ -85,6 +140,83 @@ struct ParseContext
     std::string errorMessages() const { return listener.joined(); }
 };
 
+static std::vector<SystemRDLParser::RootContext *> library_roots(
+    const std::vector<std::shared_ptr<const include::ParsedFile>> &libraries)
+{
+    std::vector<SystemRDLParser::RootContext *> roots;
+    roots.reserve(libraries.size());
+    for (const auto &library : libraries) {
+        roots.push_back(library->root);
+    }
+    return roots;
+}
+
+// Serialize a JSON document for Result output (pretty print with 2 spaces by default). The
+// binary encoders write straight into the result string while walking the document.
+static std::string dump_json(
+    const nlohmann::json &document, OutputFormat format = OutputFormat::JSON)
+{
+    trace::Span span("json_dump", "output");
+    std::string output;
+    switch (format) {
+    case OutputFormat::JSON_MINIFIED:
+        return document.dump();
+    case OutputFormat::JSON_CANONICAL:
+        // Object keys are already in byte order (std::map); what is left is fixing the layout
+        // and keeping the output ASCII, with invalid UTF-8 replaced instead of rejected
+        return document.dump(-1, ' ', true, nlohmann::json::error_handler_t::replace);
+    case OutputFormat::CBOR:
+        nlohmann::json::to_cbor(document, output);
+        return output;
+    case OutputFormat::MSGPACK:
+        nlohmann::json::to_msgpack(document, output);
+        return output;
+    default:
+        return document.dump(2);
+    }
+}
+
+// Estimate heap footprint of a JSON DOM (objects are std::map based)
+static uint64_t estimate_json_dom_bytes(const nlohmann::json &value)
+{
+    // Red-black tree node: colour + three links around the stored pair
+    constexpr uint64_t map_node_overhead = 4 * sizeof(void *);
+    static const size_t inline_capacity  = std::string().capacity();
+
+    auto string_heap = [](const std::string &str) -> uint64_t {
+        return str.capacity() > inline_capacity ? str.capacity() + 1 : 0;
+    };
+
+    uint64_t bytes = 0;
+    switch (value.type()) {
+    case nlohmann::json::value_t::object: {
+        const auto &object = value.get_ref<const nlohmann::json::object_t &>();
+        bytes += sizeof(object);
+        for (const auto &entry : object) {
+            bytes += map_node_overhead + sizeof(entry) + string_heap(entry.first)
+                     + estimate_json_dom_bytes(entry.second);
+        }
+        break;
+    }
+    case nlohmann::json::value_t::array: {
+        const auto &array = value.get_ref<const nlohmann::json::array_t &>();
+        bytes += sizeof(array) + array.capacity() * sizeof(nlohmann::json);
+        for (const auto &element : array) {
+            bytes += estimate_json_dom_bytes(element);
+        }
+        break;
+    }
+    case nlohmann::json::value_t::string: {
+        const auto &str = value.get_ref<const nlohmann::json::string_t &>();
+        bytes += sizeof(str) + string_heap(str);
+        break;
+    }
+    default:
+        break;
+    }
+    return bytes;
+}
+
 // Helper function to convert ANTLR parse tree to JSON using nlohmann/json
 static nlohmann::json convert_ast_to_json(antlr4::tree::ParseTree *tree, SystemRDLParser *parser)
 {
@@ -140,6 +272,19 @@ static nlohmann::json convert_property_to_json(const systemrdl::PropertyValue &p
     }
 }
 
+// "0x..." address text; formatted without the stream locale so the bytes never vary
+static std::string hex_address(uint64_t address)
+{
+    char  buffer[19] = {'0', 'x'};
+    char *end        = buffer + sizeof(buffer);
+    char *begin      = end;
+    do {
+        *--begin = "0123456789abcdef"[address & 0xF];
+        address >>= 4;
+    } while (address != 0);
+    return std::string(buffer, 2) + std::string(begin, end);
+}
+
 // Helper function to convert elaborated node to JSON using nlohmann/json
 static nlohmann::json convert_elaborated_node_to_json(systemrdl::ElaboratedNode &node)
 {
@@ -148,10 +293,7 @@ static nlohmann::json convert_elaborated_node_to_json(systemrdl::ElaboratedNode
     json_node["node_type"] = node.get_node_type();
     json_node["inst_name"] = node.inst_name;
 
-    // Format address as hex string
-    std::ostringstream hex_addr;
-    hex_addr << "0x" << std::hex << node.absolute_address;
-    json_node["absolute_address"] = hex_addr.str();
+    json_node["absolute_address"] = hex_address(node.absolute_address);
 
     json_node["size"] = node.size;
 
@@ -184,39 +326,57 @@ static nlohmann::json convert_elaborated_node_to_json(systemrdl::ElaboratedNode
     return json_node;
 }
 
+// Whether a key of the simplified JSON is emitted; checked before its value is formatted
+static bool projected(const Projection *projection, const char *key)
+{
+    return !projection || projection->keeps(key);
+}
+
+// name and desc properties of a simplified JSON object
+static void add_name_and_desc(
+    const systemrdl::ElaboratedNode &node, nlohmann::json &object, const Projection *projection)
+{
+    for (const char *key : {"name", "desc"}) {
+        auto prop = node.properties.find(key);
+        if (prop != node.properties.end() && projected(projection, key)) {
+            object[key] = convert_property_to_json(prop->second);
+        }
+    }
+}
+
 // Helper function to convert elaborated node to simplified JSON
 static void extract_registers_simplified(
     systemrdl::ElaboratedNode &node,
     nlohmann::json            &registers_array,
     nlohmann::json            &regfiles_array,
     std::vector<std::string>  &path,
-    std::vector<std::string>  &path_abs)
+    std::vector<std::string>  &path_abs,
+    const PathTable           *paths,
+    const Projection          *projection)
 {
-    // Format current absolute address as hex string
-    std::ostringstream hex_addr;
-    hex_addr << "0x" << std::hex << node.absolute_address;
-    std::string current_addr = hex_addr.str();
+    std::string current_addr = hex_address(node.absolute_address);
 
     if (node.get_node_type() == "regfile") {
         // Add regfile to regfiles array
-        nlohmann::json regfile_obj;
-        regfile_obj["inst_name"] = node.inst_name;
-        if (!node.properties.empty()) {
-            auto name_prop = node.properties.find("name");
-            if (name_prop != node.properties.end()) {
-                regfile_obj["name"] = convert_property_to_json(name_prop->second);
-            }
-            auto desc_prop = node.properties.find("desc");
-            if (desc_prop != node.properties.end()) {
-                regfile_obj["desc"] = convert_property_to_json(desc_prop->second);
+        nlohmann::json regfile_obj = nlohmann::json::object();
+        if (projected(projection, "inst_name")) {
+            regfile_obj["inst_name"] = node.inst_name;
+        }
+        add_name_and_desc(node, regfile_obj, projection);
+        if (projected(projection, "absolute_address")) {
+            regfile_obj["absolute_address"] = current_addr;
+        }
+        if (paths && projected(projection, "path")) {
+            regfile_obj["path"] = paths->find_enclosing(node.parent);
+        } else if (projected(projection, "path")) {
+            regfile_obj["path"] = nlohmann::json::array();
+            for (const auto &p : path) {
+                regfile_obj["path"].push_back(p);
             }
         }
-        regfile_obj["absolute_address"] = current_addr;
-        regfile_obj["path"]             = nlohmann::json::array();
-        for (const auto &p : path) {
-            regfile_obj["path"].push_back(p);
+        if (projected(projection, "size")) {
+            regfile_obj["size"] = node.size;
         }
-        regfile_obj["size"] = node.size;
         regfiles_array.push_back(regfile_obj);
 
         // Add current regfile to path for children
@@ -224,78 +384,84 @@ static void extract_registers_simplified(
         path_abs.push_back(current_addr);
     } else if (node.get_node_type() == "reg") {
         // This is a register - add it to the registers array
-        nlohmann::json register_obj;
-        register_obj["inst_name"] = node.inst_name;
+        nlohmann::json register_obj = nlohmann::json::object();
+        if (projected(projection, "inst_name")) {
+            register_obj["inst_name"] = node.inst_name;
+        }
 
         // Add name and desc from properties if available
-        if (!node.properties.empty()) {
-            auto name_prop = node.properties.find("name");
-            if (name_prop != node.properties.end()) {
-                register_obj["name"] = convert_property_to_json(name_prop->second);
-            }
-            auto desc_prop = node.properties.find("desc");
-            if (desc_prop != node.properties.end()) {
-                register_obj["desc"] = convert_property_to_json(desc_prop->second);
-            }
-        }
+        add_name_and_desc(node, register_obj, projection);
 
-        register_obj["absolute_address"] = current_addr;
-        register_obj["offset"]           = static_cast<int>(node.absolute_address);
-        register_obj["size"] = static_cast<int>(node.size); // Add size field for convenience
+        if (projected(projection, "absolute_address")) {
+            register_obj["absolute_address"] = current_addr;
+        }
+        if (projected(projection, "offset")) {
+            register_obj["offset"] = static_cast<int>(node.absolute_address);
+        }
+        if (projected(projection, "size")) {
+            register_obj["size"] = static_cast<int>(node.size); // Add size field for convenience
+        }
 
         // Add register-specific information if this is an ElaboratedReg
         if (auto reg_node = dynamic_cast<systemrdl::ElaboratedReg *>(&node)) {
-            register_obj["register_width"] = static_cast<int>(reg_node->register_width);
-            if (!reg_node->register_reset_hex.empty()) {
+            if (projected(projection, "register_width")) {
+                register_obj["register_width"] = static_cast<int>(reg_node->register_width);
+            }
+            if (!reg_node->register_reset_hex.empty()
+                && projected(projection, "register_reset_value")) {
                 register_obj["register_reset_value"] = reg_node->register_reset_hex;
             }
         }
 
-        register_obj["path"]     = nlohmann::json::array();
-        register_obj["path_abs"] = nlohmann::json::array();
-
         // Add path information
-        for (const auto &p : path) {
-            register_obj["path"].push_back(p);
-        }
-        for (const auto &pa : path_abs) {
-            register_obj["path_abs"].push_back(pa);
+        if (paths && projected(projection, "path")) {
+            register_obj["path"] = paths->find_enclosing(node.parent);
+        } else if (!paths) {
+            if (projected(projection, "path")) {
+                register_obj["path"] = nlohmann::json::array();
+                for (const auto &p : path) {
+                    register_obj["path"].push_back(p);
+                }
+            }
+            if (projected(projection, "path_abs")) {
+                register_obj["path_abs"] = nlohmann::json::array();
+                for (const auto &pa : path_abs) {
+                    register_obj["path_abs"].push_back(pa);
+                }
+            }
         }
 
         // Extract fields
         nlohmann::json fields = nlohmann::json::array();
         for (const auto &child : node.children) {
             if (child->get_node_type() == "field") {
-                nlohmann::json field_obj;
-                field_obj["inst_name"] = child->inst_name;
+                nlohmann::json field_obj = nlohmann::json::object();
+                if (projected(projection, "inst_name")) {
+                    field_obj["inst_name"] = child->inst_name;
+                }
 
                 // Add field properties
                 if (!child->properties.empty()) {
-                    auto name_prop = child->properties.find("name");
-                    if (name_prop != child->properties.end()) {
-                        field_obj["name"] = convert_property_to_json(name_prop->second);
-                    } else {
+                    add_name_and_desc(*child, field_obj, projection);
+                    if (!field_obj.contains("name") && projected(projection, "name")) {
                         field_obj["name"] = child->inst_name; // fallback to inst_name
                     }
-                    auto desc_prop = child->properties.find("desc");
-                    if (desc_prop != child->properties.end()) {
-                        field_obj["desc"] = convert_property_to_json(desc_prop->second);
-                    }
 
                     // Add other important properties
                     for (const auto &prop : child->properties) {
-                        if (prop.first == "lsb" || prop.first == "msb" || prop.first == "width"
-                            || prop.first == "sw" || prop.first == "hw" || prop.first == "reserved"
-                            || prop.first == "reset" || prop.first == "onwrite"
-                            || prop.first == "onread") {
+                        if ((prop.first == "lsb" || prop.first == "msb" || prop.first == "width"
+                             || prop.first == "sw" || prop.first == "hw"
+                             || prop.first == "reserved" || prop.first == "reset"
+                             || prop.first == "onwrite" || prop.first == "onread")
+                            && projected(projection, prop.first.c_str())) {
                             field_obj[prop.first] = convert_property_to_json(prop.second);
                         }
                     }
                 }
 
-                std::ostringstream field_hex_addr;
-                field_hex_addr << "0x" << std::hex << child->absolute_address;
-                field_obj["absolute_address"] = field_hex_addr.str();
+                if (projected(projection, "absolute_address")) {
+                    field_obj["absolute_address"] = hex_address(child->absolute_address);
+                }
 
                 fields.push_back(field_obj);
             }
@@ -313,7 +479,8 @@ static void extract_registers_simplified(
 
     // Recurse through children
     for (auto &child : node.children) {
-        extract_registers_simplified(*child, registers_array, regfiles_array, path, path_abs);
+        extract_registers_simplified(
+            *child, registers_array, regfiles_array, path, path_abs, paths, projection);
     }
 
     // Remove current node from path when done (except for addrmap)
@@ -326,32 +493,39 @@ static void extract_registers_simplified(
     }
 }
 
-static nlohmann::json convert_elaborated_node_to_simplified_json(systemrdl::ElaboratedNode &node)
+// Entries of the compact schema's path table: the root and every container named in the path
+// of a register or regfile (nested addrmaps are not)
+static bool is_simplified_path_node(const systemrdl::ElaboratedNode &node)
+{
+    const std::string type = node.get_node_type();
+    return type != "addrmap" && type != "reg" && type != "field";
+}
+
+static nlohmann::json convert_elaborated_node_to_simplified_json(
+    systemrdl::ElaboratedNode &node,
+    bool                       compact_paths = false,
+    const Projection          *projection    = nullptr)
 {
     nlohmann::json result;
     result["format"]  = "SystemRDL_SimplifiedModel";
     result["version"] = "1.0";
 
     // Extract addrmap information (should be the root node)
-    nlohmann::json addrmap_obj;
-    addrmap_obj["inst_name"] = node.inst_name;
+    nlohmann::json addrmap_obj = nlohmann::json::object();
+    if (projected(projection, "inst_name")) {
+        addrmap_obj["inst_name"] = node.inst_name;
+    }
 
     // Add addrmap properties
-    if (!node.properties.empty()) {
-        auto name_prop = node.properties.find("name");
-        if (name_prop != node.properties.end()) {
-            addrmap_obj["name"] = convert_property_to_json(name_prop->second);
-        }
-        auto desc_prop = node.properties.find("desc");
-        if (desc_prop != node.properties.end()) {
-            addrmap_obj["desc"] = convert_property_to_json(desc_prop->second);
-        }
-    }
+    add_name_and_desc(node, addrmap_obj, projection);
 
-    std::ostringstream hex_addr;
-    hex_addr << "0x" << std::hex << node.absolute_address;
-    addrmap_obj["absolute_address"] = hex_addr.str();
-    addrmap_obj["base"]             = hex_addr.str(); // Alternative name for base address
+    const std::string base_address = hex_address(node.absolute_address);
+    if (projected(projection, "absolute_address")) {
+        addrmap_obj["absolute_address"] = base_address;
+    }
+    if (projected(projection, "base")) {
+        addrmap_obj["base"] = base_address; // Alternative name for base address
+    }
 
     result["addrmap"] = addrmap_obj;
 
@@ -363,10 +537,29 @@ static nlohmann::json convert_elaborated_node_to_simplified_json(systemrdl::Elab
 
     // Start with addrmap in path
     path.push_back(node.inst_name);
-    path_abs.push_back(hex_addr.str());
+    path_abs.push_back(base_address);
+
+    std::unique_ptr<PathTable> paths;
+    if (compact_paths) {
+        paths = std::make_unique<PathTable>(node, is_simplified_path_node);
+
+        result["schema"]    = "compact";
+        nlohmann::json list = nlohmann::json::array();
+        for (uint32_t id = 0; id < paths->size(); id++) {
+            nlohmann::json entry;
+            entry["name"]             = paths->segment(id);
+            entry["absolute_address"] = hex_address(paths->node(id)->absolute_address);
+            if (paths->parent(id) != PathTable::NONE) {
+                entry["parent"] = paths->parent(id);
+            }
+            list.push_back(std::move(entry));
+        }
+        result["paths"] = std::move(list);
+    }
 
     for (auto &child : node.children) {
-        extract_registers_simplified(*child, registers_array, regfiles_array, path, path_abs);
+        extract_registers_simplified(
+            *child, registers_array, regfiles_array, path, path_abs, paths.get(), projection);
     }
 
     // Add regfiles array if not empty
@@ -1094,7 +1287,11 @@ Result parse(std::string_view rdl_content)
         }
 
         // Convert AST to JSON
-        nlohmann::json ast_result = convert_ast_to_json(ctx.tree, ctx.parser.get());
+        nlohmann::json ast_result;
+        {
+            trace::Span span("convert_ast_to_json", "output");
+            ast_result = convert_ast_to_json(ctx.tree, ctx.parser.get());
+        }
 
         // Create full JSON structure
         nlohmann::json json_result;
@@ -1103,86 +1300,432 @@ Result parse(std::string_view rdl_content)
         json_result["ast"]     = nlohmann::json::array();
         json_result["ast"].push_back(ast_result);
 
-        return Result::success(json_result.dump(2)); // Pretty print with 2 spaces
+        return Result::success(dump_json(json_result));
     } catch (const std::exception &e) {
         return Result::error(std::string("Parse error: ") + e.what());
     }
 }
 
-Result elaborate(std::string_view rdl_content)
+// Elaborator options derived from the API options
+static SystemRDLElaborator::Options to_elaborator_options(const ElaborateOptions &options)
+{
+    SystemRDLElaborator::Options elaborator_options;
+    elaborator_options.max_errors        = options.max_errors;
+    elaborator_options.fail_fast         = options.fail_fast;
+    elaborator_options.top               = options.top;
+    elaborator_options.cancel_token      = options.cancel_token;
+    elaborator_options.timeout           = options.timeout;
+    elaborator_options.max_nodes         = options.max_nodes;
+    elaborator_options.max_memory_bytes  = options.max_memory_bytes;
+    elaborator_options.progress_callback = options.progress_callback;
+    elaborator_options.progress_interval = options.progress_interval;
+    elaborator_options.definition_libraries.assign(
+        options.libraries.begin(), options.libraries.end());
+    elaborator_options.definition_libraries.insert(
+        elaborator_options.definition_libraries.end(),
+        options.indexes.begin(),
+        options.indexes.end());
+    return elaborator_options;
+}
+
+// Summarize elaborator errors, including repeat counts and why elaboration stopped
+static std::string format_elaboration_errors(const SystemRDLElaborator &elaborator)
+{
+    std::string error_details = "Elaboration errors:\n";
+    for (const auto &err : elaborator.get_errors()) {
+        error_details += "  " + err.message;
+        if (err.count > 1) {
+            error_details += " (reported " + std::to_string(err.count) + " times)";
+        }
+        error_details += "\n";
+    }
+    if (elaborator.get_suppressed_error_count() > 0) {
+        error_details += "  " + std::to_string(elaborator.get_suppressed_error_count())
+                         + " duplicate error(s) at already reported locations suppressed\n";
+    }
+    if (elaborator.was_aborted()) {
+        error_details += "  Elaboration stopped after " + std::to_string(elaborator.get_errors().size())
+                         + " error(s)\n";
+    }
+    return error_details;
+}
+
+// Elaborated model (simplified or full schema) in the requested encoding
+static Result model_to_document(
+    ElaboratedAddrmap      &model,
+    bool                    simplified,
+    const ElaborateOptions &options,
+    memory::MemoryStats    *mem_stats)
+{
+    nlohmann::json json_result;
+    {
+        memory::PhaseScope phase(mem_stats, "json_convert");
+        if (simplified) {
+            // Convert elaborated model to simplified JSON
+            trace::Span span("convert_elaborated_node_to_simplified_json", "output");
+            json_result = convert_elaborated_node_to_simplified_json(
+                model,
+                options.compact_paths,
+                options.projection ? &*options.projection : nullptr);
+        } else {
+            // Convert elaborated model to JSON
+            trace::Span span("convert_elaborated_node_to_json", "output");
+            nlohmann::json elaborated_result = convert_elaborated_node_to_json(model);
+
+            // Create full JSON structure
+            json_result["format"]  = "SystemRDL_ElaboratedModel";
+            json_result["version"] = "1.0";
+            json_result["model"]   = nlohmann::json::array();
+            json_result["model"].push_back(std::move(elaborated_result));
+        }
+    }
+
+    std::string output;
+    {
+        memory::PhaseScope phase(mem_stats, "json_dump");
+        output = dump_json(json_result, options.output_format);
+    }
+
+    if (mem_stats) {
+        mem_stats->json_dom_bytes  = sizeof(json_result) + estimate_json_dom_bytes(json_result);
+        mem_stats->json_text_bytes = output.size();
+    }
+
+    return Result::success(std::move(output));
+}
+
+// Shared implementation of model_to_json() and model_to_simplified_json()
+static Result model_to_json_document(
+    ElaboratedAddrmap &model, bool simplified, const ElaborateOptions &options, ElaborateStats *stats)
 {
+    memory::MemoryStats *mem_stats = (stats && options.collect_memory_stats) ? &stats->memory
+                                                                             : nullptr;
+    if (mem_stats) {
+        mem_stats->allocation_tracking = memory::allocation_tracking_available();
+    }
+
     try {
-        ParseContext ctx(rdl_content);
+        return model_to_document(model, simplified, options, mem_stats);
+    } catch (const std::exception &e) {
+        return Result::error(std::string("JSON generation error: ") + e.what());
+    }
+}
 
-        if (ctx.hasErrors()) {
-            return Result::error("Syntax errors found during parsing:\n" + ctx.errorMessages());
+// Shared implementation of elaborate() and elaborate_simplified()
+static Result elaborate_to_json(
+    std::string_view        rdl_content,
+    const std::string      &filename,
+    bool                    simplified,
+    const ElaborateOptions &options,
+    ElaborateStats         *stats)
+{
+    memory::MemoryStats *mem_stats = (stats && options.collect_memory_stats) ? &stats->memory
+                                                                             : nullptr;
+    if (mem_stats) {
+        mem_stats->allocation_tracking = memory::allocation_tracking_available();
+    }
+
+    try {
+        std::unique_ptr<ParseContext> ctx;
+        {
+            memory::PhaseScope phase(mem_stats, "parse");
+            ctx = std::make_unique<ParseContext>(rdl_content, filename, &options);
+
+            if (!ctx->include_errors.empty()) {
+                std::string message = "Errors in included files:";
+                for (const auto &diagnostic : ctx->include_errors) {
+                    message += "\n" + diagnostic.to_string();
+                }
+                return Result::error(message);
+            }
         }
 
-        // Create elaborator and elaborate the design
+        if (ctx->hasErrors()) {
+            return Result::error("Syntax errors found during parsing:\n" + ctx->errorMessages());
+        }
+
+        // Create elaborator and elaborate the design. Documentation properties the projection
+        // leaves out are not stored at all.
+        SystemRDLElaborator::Options elaborator_options = to_elaborator_options(options);
+        if (simplified && options.projection) {
+            for (const char *key : {"desc", "name"}) {
+                if (!options.projection->keeps(key)) {
+                    elaborator_options.discarded_properties.insert(key);
+                }
+            }
+        }
         systemrdl::SystemRDLElaborator elaborator;
-        auto                           elaborated_model = elaborator.elaborate(ctx.tree);
+        elaborator.set_options(elaborator_options);
+        elaborator.set_library_roots(library_roots(ctx->libraries));
+
+        std::unique_ptr<ElaboratedAddrmap> elaborated_model;
+        {
+            memory::PhaseScope phase(mem_stats, "elaborate");
+            elaborated_model = elaborator.elaborate(ctx->tree);
+        }
 
         if (elaborator.has_errors()) {
-            std::string error_details = "Elaboration errors:\n";
-            for (const auto &err : elaborator.get_errors()) {
-                error_details += "  " + err.message + "\n";
-            }
-            return Result::error(error_details);
+            return Result::error(format_elaboration_errors(elaborator));
         }
 
         if (!elaborated_model) {
             return Result::error("Failed to elaborate design");
         }
 
-        // Convert elaborated model to JSON
-        nlohmann::json elaborated_result = convert_elaborated_node_to_json(*elaborated_model);
-
-        // Create full JSON structure
-        nlohmann::json json_result;
-        json_result["format"]  = "SystemRDL_ElaboratedModel";
-        json_result["version"] = "1.0";
-        json_result["model"]   = nlohmann::json::array();
-        json_result["model"].push_back(elaborated_result);
+        if (mem_stats) {
+            memory::estimate_model_footprint(*elaborated_model, *mem_stats);
+        }
 
-        return Result::success(json_result.dump(2)); // Pretty print with 2 spaces
+        return model_to_document(*elaborated_model, simplified, options, mem_stats);
     } catch (const std::exception &e) {
         return Result::error(std::string("Elaboration error: ") + e.what());
     }
 }
 
-Result elaborate_simplified(std::string_view rdl_content)
+// JSON Lines output, written once elaboration is complete. With stream_output registers and
+// memories are written while they are elaborated and the retained addrmaps and regfiles at the
+// end.
+static bool elaborate_to_ndjson(
+    std::string_view        rdl_content,
+    const std::string      &filename,
+    const ElaborateOptions &options,
+    std::ostream           &output)
 {
+    trace::Span span("elaborate_ndjson", "output");
     try {
-        ParseContext ctx(rdl_content);
-
+        ParseContext ctx(rdl_content, filename, &options);
+        if (!ctx.include_errors.empty()) {
+            output << "Error: Errors in included files:";
+            for (const auto &diagnostic : ctx.include_errors) {
+                output << "\n" << diagnostic.to_string();
+            }
+            return false;
+        }
         if (ctx.hasErrors()) {
-            return Result::error("Syntax errors found during parsing:\n" + ctx.errorMessages());
+            output << "Error: Syntax errors found during parsing:\n" << ctx.errorMessages();
+            return false;
         }
 
-        // Create elaborator and elaborate the design
+        NdjsonWriter                   writer(output);
+        SystemRDLElaborator::Options   elaborator_options = to_elaborator_options(options);
         systemrdl::SystemRDLElaborator elaborator;
-        auto                           elaborated_model = elaborator.elaborate(ctx.tree);
+        if (options.stream_output) {
+            elaborator_options.stream_sink = &writer;
+        }
+        elaborator.set_options(elaborator_options);
+        elaborator.set_library_roots(library_roots(ctx.libraries));
+
+        auto elaborated_model = elaborator.elaborate(ctx.tree);
+        if (elaborator.has_errors() || !elaborated_model) {
+            output << "Error: " << format_elaboration_errors(elaborator);
+            return false;
+        }
+        writer.write_model(*elaborated_model);
+        return static_cast<bool>(output);
+    } catch (const std::exception &e) {
+        output << "Stream error: " << e.what();
+        return false;
+    }
+}
+
+// Parse and validate only; the elaborated model is discarded as soon as validation is done
+static CheckResult check_content(
+    std::string_view rdl_content, const std::string &filename, const ElaborateOptions &options)
+{
+    trace::Span span("check", "check");
+    CheckResult result;
+
+    try {
+        ParseContext ctx(rdl_content, filename, &options);
+        result.diagnostics = ctx.include_errors;
+
+        if (ctx.hasErrors() || !result.diagnostics.empty()) {
+            const auto &syntax = ctx.listener.diagnostics();
+            result.diagnostics.insert(result.diagnostics.begin(), syntax.begin(), syntax.end());
+        } else {
+            systemrdl::SystemRDLElaborator elaborator;
+            elaborator.set_options(to_elaborator_options(options));
+            elaborator.set_library_roots(library_roots(ctx.libraries));
+            elaborator.elaborate(ctx.tree);
 
-        if (elaborator.has_errors()) {
-            std::string error_details = "Elaboration errors:\n";
             for (const auto &err : elaborator.get_errors()) {
-                error_details += "  " + err.message + "\n";
+                // Errors in included files carry their file and are not macro-expanded here
+                Diagnostic diagnostic;
+                diagnostic.severity = Diagnostic::Severity::Error;
+                diagnostic.file     = err.file;
+                diagnostic.line     = err.line;
+                diagnostic.column   = err.file == filename
+                                          ? ctx.line_map.source_column(err.line, err.column)
+                                          : err.column;
+                diagnostic.code     = err.code;
+                diagnostic.message  = err.message;
+                diagnostic.count    = err.count;
+                result.diagnostics.push_back(std::move(diagnostic));
             }
-            return Result::error(error_details);
+            result.aborted = elaborator.was_aborted();
         }
+    } catch (const std::exception &e) {
+        Diagnostic diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.code     = "internal";
+        diagnostic.message  = e.what();
+        result.diagnostics.push_back(std::move(diagnostic));
+    }
 
-        if (!elaborated_model) {
-            return Result::error("Failed to elaborate design");
+    return result;
+}
+
+size_t CheckResult::error_count() const
+{
+    return std::count_if(diagnostics.begin(), diagnostics.end(), [](const Diagnostic &d) {
+        return d.severity == Diagnostic::Severity::Error;
+    });
+}
+
+std::string Diagnostic::to_string() const
+{
+    std::string text = file.empty() ? "<input>" : file;
+    text += ":" + std::to_string(line) + ":" + std::to_string(column) + ": ";
+    switch (severity) {
+    case Severity::Error:
+        text += "error";
+        break;
+    case Severity::Warning:
+        text += "warning";
+        break;
+    case Severity::Note:
+        text += "note";
+        break;
+    }
+    text += " [" + code + "]: " + message;
+    if (count > 1) {
+        text += " (reported " + std::to_string(count) + " times)";
+    }
+    return text;
+}
+
+Projection Projection::from_template(std::string_view template_text)
+{
+    Projection projection;
+    size_t     position = 0;
+    while ((position = template_text.find('{', position)) != std::string_view::npos) {
+        if (position + 1 >= template_text.size()
+            || (template_text[position + 1] != '{' && template_text[position + 1] != '%')) {
+            position++;
+            continue;
+        }
+        const char *close = template_text[position + 1] == '{' ? "}}" : "%}";
+        size_t      end   = template_text.find(close, position + 2);
+        if (end == std::string_view::npos) {
+            end = template_text.size();
         }
 
-        // Convert elaborated model to simplified JSON
-        nlohmann::json simplified_result = convert_elaborated_node_to_simplified_json(
-            *elaborated_model);
+        // Identifiers, including those in quoted strings such as at(reg, "desc")
+        for (size_t i = position + 2; i < end;) {
+            const auto c = static_cast<unsigned char>(template_text[i]);
+            if (!std::isalpha(c) && c != '_') {
+                i++;
+                continue;
+            }
+            size_t start = i;
+            while (i < end
+                   && (std::isalnum(static_cast<unsigned char>(template_text[i]))
+                       || template_text[i] == '_')) {
+                i++;
+            }
+            projection.keys.emplace(template_text.substr(start, i - start));
+        }
+        position = end;
+    }
+    return projection;
+}
 
-        return Result::success(simplified_result.dump(2)); // Pretty print with 2 spaces
-    } catch (const std::exception &e) {
-        return Result::error(std::string("Elaboration error: ") + e.what());
+Projection Projection::from_list(std::string_view keys)
+{
+    Projection projection;
+    while (!keys.empty()) {
+        size_t comma = keys.find(',');
+        auto   key   = keys.substr(0, comma);
+        // "inst_name, absolute_address" names the same keys as without the blank
+        while (!key.empty() && std::isspace(static_cast<unsigned char>(key.front()))) {
+            key.remove_prefix(1);
+        }
+        while (!key.empty() && std::isspace(static_cast<unsigned char>(key.back()))) {
+            key.remove_suffix(1);
+        }
+        if (!key.empty()) {
+            projection.keys.emplace(key);
+        }
+        keys.remove_prefix(comma == std::string_view::npos ? keys.size() : comma + 1);
     }
+    return projection;
+}
+
+bool parse_output_format(std::string_view name, OutputFormat &format)
+{
+    if (name == "json") {
+        format = OutputFormat::JSON;
+    } else if (name == "json-min") {
+        format = OutputFormat::JSON_MINIFIED;
+    } else if (name == "json-canonical") {
+        format = OutputFormat::JSON_CANONICAL;
+    } else if (name == "cbor") {
+        format = OutputFormat::CBOR;
+    } else if (name == "msgpack") {
+        format = OutputFormat::MSGPACK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *output_format_extension(OutputFormat format)
+{
+    switch (format) {
+    case OutputFormat::CBOR:
+        return ".cbor";
+    case OutputFormat::MSGPACK:
+        return ".msgpack";
+    default:
+        return ".json";
+    }
+}
+
+CheckResult check(std::string_view rdl_content, const ElaborateOptions &options)
+{
+    return check_content(rdl_content, "", options);
+}
+
+Result elaborate(std::string_view rdl_content)
+{
+    return elaborate_to_json(rdl_content, "", false, ElaborateOptions{}, nullptr);
+}
+
+Result elaborate(std::string_view rdl_content, const ElaborateOptions &options, ElaborateStats *stats)
+{
+    return elaborate_to_json(rdl_content, "", false, options, stats);
+}
+
+Result elaborate_simplified(std::string_view rdl_content)
+{
+    return elaborate_to_json(rdl_content, "", true, ElaborateOptions{}, nullptr);
+}
+
+Result elaborate_simplified(
+    std::string_view rdl_content, const ElaborateOptions &options, ElaborateStats *stats)
+{
+    return elaborate_to_json(rdl_content, "", true, options, stats);
+}
+
+Result model_to_json(ElaboratedAddrmap &model, const ElaborateOptions &options, ElaborateStats *stats)
+{
+    return model_to_json_document(model, false, options, stats);
+}
+
+Result model_to_simplified_json(
+    ElaboratedAddrmap &model, const ElaborateOptions &options, ElaborateStats *stats)
+{
+    return model_to_json_document(model, true, options, stats);
 }
 
 Result csv_to_rdl(std::string_view csv_content)
@@ -1228,6 +1771,11 @@ Result parse(const std::string &filename)
 }
 
 Result elaborate(const std::string &filename)
+{
+    return elaborate(filename, ElaborateOptions{}, nullptr);
+}
+
+Result elaborate(const std::string &filename, const ElaborateOptions &options, ElaborateStats *stats)
 {
     try {
         std::ifstream file(filename);
@@ -1237,13 +1785,19 @@ Result elaborate(const std::string &filename)
 
         std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-        return systemrdl::elaborate(content);
+        return elaborate_to_json(content, filename, false, options, stats);
     } catch (const std::exception &e) {
         return Result::error(std::string("File read error: ") + e.what());
     }
 }
 
 Result elaborate_simplified(const std::string &filename)
+{
+    return elaborate_simplified(filename, ElaborateOptions{}, nullptr);
+}
+
+Result elaborate_simplified(
+    const std::string &filename, const ElaborateOptions &options, ElaborateStats *stats)
 {
     try {
         std::ifstream file(filename);
@@ -1253,12 +1807,60 @@ Result elaborate_simplified(const std::string &filename)
 
         std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-        return systemrdl::elaborate_simplified(content);
+        return elaborate_to_json(content, filename, true, options, stats);
     } catch (const std::exception &e) {
         return Result::error(std::string("File read error: ") + e.what());
     }
 }
 
+CheckResult check(const std::string &filename, const ElaborateOptions &options)
+{
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        CheckResult result;
+        Diagnostic  diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.file     = filename;
+        diagnostic.code     = "io";
+        diagnostic.message  = "Cannot open file: " + filename;
+        result.diagnostics.push_back(std::move(diagnostic));
+        return result;
+    }
+
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    return check_content(content, filename, options);
+}
+
+Result compile_library(
+    const std::string      &filename,
+    const std::string      &output_filename,
+    const ElaborateOptions &options)
+{
+    try {
+        std::vector<Diagnostic> diagnostics;
+        auto library = ComponentLibrary::compile(
+            filename, options.include_paths, diagnostics, options.defines);
+        if (!library) {
+            std::string message = "Cannot compile library:";
+            for (const auto &diagnostic : diagnostics) {
+                message += "\n" + diagnostic.to_string();
+            }
+            return Result::error(message);
+        }
+
+        std::string error;
+        if (!library->save(output_filename, &error)) {
+            return Result::error(error);
+        }
+        return Result::success(
+            "Compiled " + std::to_string(library->definitions().size()) + " definitions into "
+            + output_filename);
+    } catch (const std::exception &e) {
+        return Result::error(std::string("Library compile error: ") + e.what());
+    }
+}
+
 Result csv_to_rdl(const std::string &filename)
 {
     try {
@@ -1340,6 +1942,12 @@ bool elaborate_simplified(std::istream &input, std::ostream &output)
     }
 }
 
+bool elaborate_ndjson(std::istream &input, std::ostream &output, const ElaborateOptions &options)
+{
+    std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    return elaborate_to_ndjson(content, "", options, output);
+}
+
 bool csv_to_rdl(std::istream &input, std::ostream &output)
 {
     try {
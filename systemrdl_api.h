@@ -1,12 +1,24 @@
 #pragma once
 
+#include "systemrdl_memory.h"
+#include "systemrdl_progress.h"
 #include "systemrdl_version.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace systemrdl {
 
+class ComponentLibrary; // Precompiled definitions, see systemrdl_library.h
+class DefinitionIndex;  // Definition name -> file index, see systemrdl_index.h
+class ElaboratedAddrmap; // Root of an elaborated model, see elaborator.h
+
 /**
  * @brief Result type for SystemRDL API operations
  *
@@ -44,6 +56,148 @@ public:
     const std::string &error() const { return error_; }
 };
 
+/**
+ * @brief Encoding of the documents returned by elaborate() and elaborate_simplified()
+ *
+ * Every format carries the same document. CBOR (RFC 8949) and MessagePack are binary, smaller
+ * and much faster to decode than pretty-printed JSON; for them Result::value() holds raw bytes.
+ *
+ * JSON_CANONICAL is byte-stable for content-addressed caching: object keys sorted bytewise, no
+ * whitespace, integers only, addresses as lowercase "0x" hex, non-ASCII characters escaped as
+ * \uXXXX and invalid UTF-8 replaced by U+FFFD. The same input and options give the same bytes
+ * on every run, platform and --jobs setting.
+ */
+enum class OutputFormat { JSON, JSON_MINIFIED, JSON_CANONICAL, CBOR, MSGPACK };
+
+// Parse "json", "json-min", "json-canonical", "cbor" or "msgpack"; false for other names
+bool parse_output_format(std::string_view name, OutputFormat &format);
+
+// File extension including the dot: ".json", ".cbor" or ".msgpack"
+const char *output_format_extension(OutputFormat format);
+
+/**
+ * @brief The keys of the simplified JSON a consumer reads
+ *
+ * With a projection, the addrmap, regfile, register and field objects of the simplified JSON
+ * carry only the listed keys (e.g. "absolute_address", "inst_name", "lsb", "sw", "desc"). The
+ * document structure (format, version, schema, addrmap, registers, regfiles, fields, paths) is
+ * always kept. The "desc" and "name" properties are not even stored during elaboration unless
+ * they are listed.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::ElaborateOptions options;
+ * options.projection = systemrdl::Projection::from_template(template_text);
+ * auto result = systemrdl::file::elaborate_simplified("soc.rdl", options);
+ * ```
+ */
+struct Projection
+{
+    std::set<std::string> keys;
+
+    bool keeps(const std::string &key) const { return keys.count(key) != 0; }
+
+    // Every identifier and quoted name inside the {{ }} and {% %} blocks of an Inja/Jinja2
+    // template: a superset of the keys the template can read
+    static Projection from_template(std::string_view template_text);
+
+    // Comma-separated key list, e.g. "inst_name,absolute_address,lsb,msb"; blanks around
+    // the keys are ignored
+    static Projection from_list(std::string_view keys);
+};
+
+/**
+ * @brief Options for the elaboration entry points
+ */
+struct ElaborateOptions
+{
+    bool   collect_memory_stats = false; // Fill ElaborateStats::memory
+    size_t max_errors           = 0;     // Stop after this many distinct errors (0 = unlimited)
+    bool   fail_fast            = false; // Stop at the first error
+
+    // Top-level addrmap definition to elaborate (empty = first one in the file)
+    std::string top;
+
+    // Directories searched for `include files after the including file's directory.
+    // Included files are parsed once per process and shared (see systemrdl_include.h).
+    std::vector<std::string> include_paths;
+
+    // Macros predefined for the preprocessor, as if by `define NAME value
+    std::map<std::string, std::string> defines;
+
+    // Precompiled libraries searched for definitions the source does not contain
+    std::vector<std::shared_ptr<const ComponentLibrary>> libraries;
+
+    // Indexes of RDL files parsed on demand for definitions not found above. Indexed files are
+    // preprocessed with the index's own include paths and defines (set_include_paths(),
+    // set_defines()); set them to include_paths and defines for -I/-D behavior.
+    std::vector<std::shared_ptr<const DefinitionIndex>> indexes;
+
+    // Simplified JSON: registers and regfiles refer to a shared "paths" table instead of
+    // carrying their own path and path_abs arrays
+    bool compact_paths = false;
+
+    // Encoding of the elaborated model documents
+    OutputFormat output_format = OutputFormat::JSON;
+
+    // stream::elaborate_ndjson: write registers and memories while they are elaborated, so
+    // memory stays bounded by the hierarchy. Dynamic assignments of the enclosing bodies
+    // (r1.f1->reset = 1;) are applied to a register before it is written and released.
+    bool stream_output = false;
+
+    // Simplified JSON: emit only these keys (see Projection); unset = everything
+    std::optional<Projection> projection;
+
+    // Limits for untrusted or runaway designs; exceeding one fails with an error (0 = no limit)
+    CancellationToken         cancel_token;
+    std::chrono::milliseconds timeout{0};         // Wall-clock limit for elaboration
+    size_t                    max_nodes        = 0; // Elaborated component instances
+    uint64_t                  max_memory_bytes = 0; // Process resident set size
+
+    // Called every progress_interval elaborated nodes
+    std::function<void(const ElaborationProgress &)> progress_callback;
+    size_t                                           progress_interval = 10000;
+};
+
+/**
+ * @brief Statistics collected by the elaboration entry points
+ */
+struct ElaborateStats
+{
+    memory::MemoryStats memory; // Per-phase allocations, model footprint and JSON DOM size
+};
+
+/**
+ * @brief A single structured diagnostic
+ */
+struct Diagnostic
+{
+    enum class Severity { Error, Warning, Note };
+
+    Severity    severity = Severity::Error;
+    std::string file;       // Source file, empty for in-memory content
+    size_t      line   = 0; // 1-based line, 0 if unknown
+    size_t      column = 0; // 0-based column
+    std::string code;       // Stable identifier, e.g. "syntax", "field-overlap"
+    std::string message;
+    size_t      count = 1; // Occurrences folded into this diagnostic
+
+    // Format as "file:line:column: severity [code]: message"
+    std::string to_string() const;
+};
+
+/**
+ * @brief Result of a diagnostics-only check
+ */
+struct CheckResult
+{
+    std::vector<Diagnostic> diagnostics;
+    bool                    aborted = false; // Stopped early (max_errors/fail_fast)
+
+    size_t error_count() const;
+    bool   ok() const { return error_count() == 0; }
+};
+
 /**
  * @brief Parse SystemRDL content and generate JSON AST
  *
@@ -82,6 +236,26 @@ Result parse(std::string_view rdl_content);
  */
 Result elaborate(std::string_view rdl_content);
 
+/**
+ * @brief Parse and elaborate SystemRDL content with options, collecting statistics
+ *
+ * @param rdl_content The SystemRDL content to elaborate
+ * @param options Elaboration options
+ * @param stats Optional output for statistics requested through options
+ * @return Result containing JSON elaborated model on success, or error message on failure
+ *
+ * @example
+ * ```cpp
+ * systemrdl::ElaborateOptions options;
+ * options.collect_memory_stats = true;
+ * systemrdl::ElaborateStats stats;
+ * auto result = systemrdl::elaborate(rdl_content, options, &stats);
+ * systemrdl::memory::print_report(stats.memory, std::cout);
+ * ```
+ */
+Result elaborate(
+    std::string_view rdl_content, const ElaborateOptions &options, ElaborateStats *stats = nullptr);
+
 /**
  * @brief Parse and elaborate SystemRDL content, generate simplified JSON model
  *
@@ -101,6 +275,73 @@ Result elaborate(std::string_view rdl_content);
  */
 Result elaborate_simplified(std::string_view rdl_content);
 
+/**
+ * @brief Parse and elaborate SystemRDL content to simplified JSON with options
+ *
+ * @param rdl_content The SystemRDL content to elaborate
+ * @param options Elaboration options
+ * @param stats Optional output for statistics requested through options
+ * @return Result containing simplified JSON model on success, or error message on failure
+ */
+Result elaborate_simplified(
+    std::string_view rdl_content, const ElaborateOptions &options, ElaborateStats *stats = nullptr);
+
+/**
+ * @brief Parse and validate SystemRDL content without generating any output
+ *
+ * Runs parsing and all elaboration checks and returns structured diagnostics.
+ * No JSON is generated and the elaborated model is not retained.
+ *
+ * @param rdl_content The SystemRDL content to check
+ * @param options Honours include_paths, defines, libraries, indexes, top, the error limits
+ *        (max_errors, fail_fast), the resource limits, cancel_token and the progress
+ *        callback; output options (output_format, compact_paths, projection,
+ *        stream_output, collect_memory_stats) are ignored
+ * @return CheckResult with all diagnostics; ok() is true when there are no errors
+ *
+ * @example
+ * ```cpp
+ * auto result = systemrdl::check(rdl_content);
+ * for (const auto &diagnostic : result.diagnostics) {
+ *     std::cerr << diagnostic.to_string() << std::endl;
+ * }
+ * return result.ok() ? 0 : 1;
+ * ```
+ */
+CheckResult check(std::string_view rdl_content, const ElaborateOptions &options = {});
+
+/**
+ * @brief Generate the JSON elaborated model of an already elaborated design
+ *
+ * Serializes a model built by the caller, e.g. one linked with link::Linker or merged by
+ * fanout::Driver, in the same document as elaborate().
+ *
+ * @param model The elaborated model; it is not modified
+ * @param options Only output_format is used
+ * @param stats Optional output for the JSON phases when options.collect_memory_stats is set
+ * @return Result containing JSON elaborated model on success, or error message on failure
+ */
+Result model_to_json(
+    ElaboratedAddrmap &model, const ElaborateOptions &options = {}, ElaborateStats *stats = nullptr);
+
+/**
+ * @brief Generate the simplified JSON model of an already elaborated design
+ *
+ * @param model The elaborated model; it is not modified
+ * @param options Only output_format, compact_paths and projection are used
+ * @param stats Optional output for the JSON phases when options.collect_memory_stats is set
+ * @return Result containing simplified JSON model on success, or error message on failure
+ *
+ * @example
+ * ```cpp
+ * auto model = elaborator.elaborate(tree);
+ * linker.link(*model);
+ * auto result = systemrdl::model_to_simplified_json(*model);
+ * ```
+ */
+Result model_to_simplified_json(
+    ElaboratedAddrmap &model, const ElaborateOptions &options = {}, ElaborateStats *stats = nullptr);
+
 /**
  * @brief Convert CSV content to SystemRDL format
  *
@@ -162,6 +403,17 @@ Result parse(const std::string &filename);
  */
 Result elaborate(const std::string &filename);
 
+/**
+ * @brief Parse and elaborate SystemRDL file with options, collecting statistics
+ *
+ * @param filename Path to the SystemRDL file
+ * @param options Elaboration options
+ * @param stats Optional output for statistics requested through options
+ * @return Result containing JSON elaborated model on success, or error message on failure
+ */
+Result elaborate(
+    const std::string &filename, const ElaborateOptions &options, ElaborateStats *stats = nullptr);
+
 /**
  * @brief Parse and elaborate SystemRDL file, generate simplified JSON model
  *
@@ -180,6 +432,61 @@ Result elaborate(const std::string &filename);
  */
 Result elaborate_simplified(const std::string &filename);
 
+/**
+ * @brief Parse and elaborate SystemRDL file to simplified JSON with options
+ *
+ * @param filename Path to the SystemRDL file
+ * @param options Elaboration options
+ * @param stats Optional output for statistics requested through options
+ * @return Result containing simplified JSON model on success, or error message on failure
+ */
+Result elaborate_simplified(
+    const std::string &filename, const ElaborateOptions &options, ElaborateStats *stats = nullptr);
+
+/**
+ * @brief Parse and validate SystemRDL file without generating any output
+ *
+ * @param filename Path to the SystemRDL file
+ * @param options Honours include_paths, defines, libraries, indexes, top, the error limits
+ *        (max_errors, fail_fast), the resource limits, cancel_token and the progress
+ *        callback; output options (output_format, compact_paths, projection,
+ *        stream_output, collect_memory_stats) are ignored
+ * @return CheckResult with diagnostics carrying the file name
+ *
+ * @example
+ * ```cpp
+ * auto result = systemrdl::file::check("design.rdl");
+ * if (!result.ok()) {
+ *     for (const auto &diagnostic : result.diagnostics) {
+ *         std::cerr << diagnostic.to_string() << std::endl;
+ *     }
+ * }
+ * ```
+ */
+CheckResult check(const std::string &filename, const ElaborateOptions &options = {});
+
+/**
+ * @brief Compile the definitions of a SystemRDL file into a precompiled library (.rdlib)
+ *
+ * Definitions are stored as preprocessed source text. Elaborations using the library parse
+ * each definition they use again, once per loaded library, at about the cost of parsing it
+ * from source; definitions they do not use are never parsed.
+ *
+ * @param filename Path to the SystemRDL file; `include files are compiled into the library
+ * @param output_filename Path of the library file to write
+ * @param options Only include_paths and defines are used; the defines are fixed in the library
+ * @return Result with a one-line summary on success, or the errors on failure
+ *
+ * @example
+ * ```cpp
+ * auto result = systemrdl::file::compile_library("ip_blocks.rdl", "ip_blocks.rdlib");
+ * ```
+ */
+Result compile_library(
+    const std::string      &filename,
+    const std::string      &output_filename,
+    const ElaborateOptions &options = {});
+
 /**
  * @brief Convert CSV file to SystemRDL format
  *
@@ -262,6 +569,30 @@ bool elaborate(std::istream &input, std::ostream &output);
  */
 bool elaborate_simplified(std::istream &input, std::ostream &output);
 
+/**
+ * @brief Parse and elaborate SystemRDL from input stream, write JSON Lines to output stream
+ *
+ * Writes one self-contained JSON object per addrmap, regfile, register and memory (see
+ * systemrdl_ndjson.h) once the model is elaborated. With ElaborateOptions::stream_output
+ * registers and memories are written while they are elaborated and released, so output starts
+ * before the model is complete and memory stays bounded by the hierarchy. On errors, lines
+ * written so far are followed by an "Error: " message.
+ *
+ * @param input Input stream containing SystemRDL content
+ * @param output Output stream to write one JSON object per line
+ * @param options Elaboration options
+ * @return true on success, false on failure
+ *
+ * @example
+ * ```cpp
+ * std::ifstream input("design.rdl");
+ * std::ofstream output("design.ndjson");
+ * bool success = systemrdl::stream::elaborate_ndjson(input, output);
+ * ```
+ */
+bool elaborate_ndjson(
+    std::istream &input, std::ostream &output, const ElaborateOptions &options = {});
+
 /**
  * @brief Convert CSV from input stream to SystemRDL in output stream
  *
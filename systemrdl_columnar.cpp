@@ -0,0 +1,681 @@
+#include "systemrdl_columnar.h"
+
+#include "systemrdl_path.h"
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+namespace columnar {
+
+namespace {
+
+// Arrow IPC metadata: MetadataVersion V5, MessageHeader and Type union tags (Schema.fbs,
+// Message.fbs)
+constexpr uint64_t METADATA_V5       = 4;
+constexpr uint64_t HEADER_SCHEMA     = 1;
+constexpr uint64_t HEADER_DICTIONARY = 2;
+constexpr uint64_t HEADER_BATCH      = 3;
+constexpr uint64_t TYPE_INT          = 2;
+constexpr uint64_t TYPE_UTF8         = 5;
+
+const char FILE_MAGIC[] = "ARROW1";
+
+/**
+ * Minimal FlatBuffers object tree and serializer for the few Arrow metadata tables. Objects
+ * are written front to back: a table is preceded by its vtable and followed by the objects it
+ * refers to, so every offset points forward as the format requires.
+ */
+struct FbObject;
+using FbRef = std::shared_ptr<FbObject>;
+
+struct FbObject
+{
+    enum Kind { TABLE, STRING, TABLE_VECTOR, STRUCT_VECTOR } kind = TABLE;
+
+    struct Slot
+    {
+        size_t   id;
+        size_t   size; // Inline size; 4 for offsets to child objects
+        uint64_t value = 0;
+        FbRef    child;
+        size_t   offset = 0; // Position within the table, set while writing
+    };
+    std::vector<Slot>  slots;
+    std::string        bytes; // String contents or packed struct elements
+    size_t             count = 0;
+    std::vector<FbRef> items;
+
+    FbObject &scalar(size_t id, size_t size, uint64_t value)
+    {
+        slots.push_back({id, size, value, nullptr});
+        return *this;
+    }
+    FbObject &child(size_t id, FbRef object)
+    {
+        slots.push_back({id, 4, 0, std::move(object)});
+        return *this;
+    }
+};
+
+FbRef fb_table()
+{
+    return std::make_shared<FbObject>();
+}
+
+FbRef fb_string(const std::string &value)
+{
+    auto object   = std::make_shared<FbObject>();
+    object->kind  = FbObject::STRING;
+    object->bytes = value;
+    return object;
+}
+
+FbRef fb_tables(std::vector<FbRef> items)
+{
+    auto object   = std::make_shared<FbObject>();
+    object->kind  = FbObject::TABLE_VECTOR;
+    object->items = std::move(items);
+    return object;
+}
+
+// Vector of structs made of 8-byte members (FieldNode, Buffer, Block)
+FbRef fb_structs(const std::vector<std::vector<uint64_t>> &elements, size_t struct_size)
+{
+    auto object   = std::make_shared<FbObject>();
+    object->kind  = FbObject::STRUCT_VECTOR;
+    object->count = elements.size();
+    for (const auto &element : elements) {
+        std::string bytes(struct_size, '\0');
+        for (size_t i = 0; i < element.size(); i++) {
+            for (size_t b = 0; b < 8; b++) {
+                bytes[i * 8 + b] = static_cast<char>((element[i] >> (8 * b)) & 0xFF);
+            }
+        }
+        object->bytes += bytes;
+    }
+    return object;
+}
+
+class FbWriter
+{
+public:
+    std::string finish(const FbObject &root)
+    {
+        buffer_.assign(4, '\0');
+        size_t position = write(root);
+        patch(0, static_cast<uint32_t>(position));
+        pad(8);
+        return std::move(buffer_);
+    }
+
+private:
+    // Pad until (size + shift) is a multiple of align
+    void pad(size_t align, size_t shift = 0)
+    {
+        while ((buffer_.size() + shift) % align != 0) {
+            buffer_.push_back('\0');
+        }
+    }
+
+    void put(uint64_t value, size_t size)
+    {
+        for (size_t b = 0; b < size; b++) {
+            buffer_.push_back(static_cast<char>((value >> (8 * b)) & 0xFF));
+        }
+    }
+
+    void patch(size_t position, uint64_t value, size_t size = 4)
+    {
+        for (size_t b = 0; b < size; b++) {
+            buffer_[position + b] = static_cast<char>((value >> (8 * b)) & 0xFF);
+        }
+    }
+
+    size_t write(const FbObject &object)
+    {
+        switch (object.kind) {
+        case FbObject::STRING: {
+            pad(4);
+            size_t position = buffer_.size();
+            put(object.bytes.size(), 4);
+            buffer_ += object.bytes;
+            buffer_.push_back('\0');
+            return position;
+        }
+        case FbObject::STRUCT_VECTOR: {
+            pad(8, 4); // Elements 8-byte aligned after the length
+            size_t position = buffer_.size();
+            put(object.count, 4);
+            buffer_ += object.bytes;
+            return position;
+        }
+        case FbObject::TABLE_VECTOR: {
+            pad(4);
+            size_t position = buffer_.size();
+            put(object.items.size(), 4);
+            buffer_.append(object.items.size() * 4, '\0');
+            for (size_t i = 0; i < object.items.size(); i++) {
+                size_t slot = position + 4 + i * 4;
+                patch(slot, write(*object.items[i]) - slot);
+            }
+            return position;
+        }
+        default:
+            return write_table(object);
+        }
+    }
+
+    size_t write_table(const FbObject &object)
+    {
+        // Inline layout after the vtable offset, largest members first
+        std::vector<FbObject::Slot> slots = object.slots;
+        std::stable_sort(slots.begin(), slots.end(), [](const auto &a, const auto &b) {
+            return a.size > b.size;
+        });
+        size_t inline_size = 4;
+        size_t field_count = 0;
+        for (auto &slot : slots) {
+            inline_size = (inline_size + slot.size - 1) / slot.size * slot.size;
+            slot.offset = inline_size;
+            inline_size += slot.size;
+            field_count = std::max(field_count, slot.id + 1);
+        }
+        inline_size = (inline_size + 3) / 4 * 4;
+
+        pad(2);
+        size_t vtable = buffer_.size();
+        put(4 + 2 * field_count, 2);
+        put(inline_size, 2);
+        for (size_t id = 0; id < field_count; id++) {
+            size_t offset = 0;
+            for (const auto &slot : slots) {
+                offset = slot.id == id ? slot.offset : offset;
+            }
+            put(offset, 2);
+        }
+
+        pad(8);
+        size_t table = buffer_.size();
+        buffer_.append(inline_size, '\0');
+        patch(table, static_cast<uint32_t>(table - vtable));
+        for (const auto &slot : slots) {
+            if (!slot.child) {
+                patch(table + slot.offset, slot.value, slot.size);
+            }
+        }
+        for (const auto &slot : slots) {
+            if (slot.child) {
+                size_t position = table + slot.offset;
+                patch(position, write(*slot.child) - position);
+            }
+        }
+        return table;
+    }
+
+    std::string buffer_;
+};
+
+FbRef int_type(size_t bits, bool is_signed)
+{
+    auto type = fb_table();
+    type->scalar(0, 4, bits).scalar(1, 1, is_signed ? 1 : 0);
+    return type;
+}
+
+} // namespace
+
+/**
+ * One Arrow IPC file: columns are filled row by row and written as a record batch whenever
+ * batch_rows rows are buffered.
+ */
+class TableWriter
+{
+public:
+    enum class Type { UINT32, UINT64, UTF8, DICTIONARY };
+
+    TableWriter(std::vector<std::pair<std::string, Type>> columns, size_t batch_rows)
+        : batch_rows_(batch_rows)
+    {
+        int64_t dictionary_id = 0;
+        for (auto &column : columns) {
+            Column entry;
+            entry.name = std::move(column.first);
+            entry.type = column.second;
+            if (entry.type == Type::DICTIONARY) {
+                entry.dictionary_id = dictionary_id++;
+            }
+            entry.offsets.push_back(0);
+            columns_.push_back(std::move(entry));
+        }
+    }
+
+    bool open(const std::string &path, std::string *error)
+    {
+        path_ = path;
+        output_.open(path, std::ios::binary | std::ios::trunc);
+        if (!output_.is_open()) {
+            return fail("Cannot write columnar file: " + path, error);
+        }
+        output_.write(FILE_MAGIC, 6);
+        output_.write("\0\0", 2);
+        position_ = 8;
+        write_message(HEADER_SCHEMA, schema(), {});
+        return static_cast<bool>(output_);
+    }
+
+    void set(size_t column, uint64_t value)
+    {
+        auto &target = columns_[column];
+        if (target.type == Type::UINT32) {
+            target.u32.push_back(static_cast<uint32_t>(value));
+        } else {
+            target.u64.push_back(value);
+        }
+    }
+
+    void set(size_t column, const std::string &value)
+    {
+        auto &target = columns_[column];
+        if (target.type == Type::UTF8) {
+            append_string(target.offsets, target.data, value);
+            return;
+        }
+        auto it = target.dictionary.find(value);
+        if (it == target.dictionary.end()) {
+            int32_t id = static_cast<int32_t>(target.dictionary.size());
+            it         = target.dictionary.emplace(value, id).first;
+            append_string(target.dictionary_offsets, target.dictionary_data, value);
+        }
+        target.u32.push_back(static_cast<uint32_t>(it->second));
+    }
+
+    void end_row()
+    {
+        if (++rows_ == batch_rows_) {
+            flush();
+        }
+    }
+
+    bool finish(std::string *error)
+    {
+        flush();
+
+        // Dictionaries after the batches: file readers find them through the footer
+        for (auto &column : columns_) {
+            if (column.type != Type::DICTIONARY) {
+                continue;
+            }
+            std::string body;
+            size_t      count = column.dictionary.size();
+            if (column.dictionary_offsets.empty()) {
+                column.dictionary_offsets.push_back(0);
+            }
+            std::vector<std::vector<uint64_t>> buffers;
+            add_buffer(body, buffers, nullptr, 0);
+            add_buffer(
+                body,
+                buffers,
+                column.dictionary_offsets.data(),
+                column.dictionary_offsets.size() * sizeof(int32_t));
+            add_buffer(
+                body, buffers, column.dictionary_data.data(), column.dictionary_data.size());
+
+            auto dictionary = fb_table();
+            dictionary->scalar(0, 8, column.dictionary_id)
+                .child(1, record_batch(count, {{count, 0}}, buffers));
+            dictionaries_.push_back(write_message(HEADER_DICTIONARY, dictionary, body));
+        }
+
+        // End-of-stream marker, then the footer
+        write_raw(std::string("\xFF\xFF\xFF\xFF\0\0\0\0", 8));
+        auto footer = fb_table();
+        footer->scalar(0, 2, METADATA_V5)
+            .child(1, schema())
+            .child(2, fb_structs(dictionaries_, 24))
+            .child(3, fb_structs(batches_, 24));
+        std::string footer_bytes = FbWriter().finish(*footer);
+        write_raw(footer_bytes);
+        std::string length(4, '\0');
+        for (size_t b = 0; b < 4; b++) {
+            length[b] = static_cast<char>((footer_bytes.size() >> (8 * b)) & 0xFF);
+        }
+        write_raw(length);
+        write_raw(FILE_MAGIC);
+
+        output_.close();
+        if (!output_) {
+            return fail("Failed writing columnar file: " + path_, error);
+        }
+        return true;
+    }
+
+private:
+    struct Column
+    {
+        std::string           name;
+        Type                  type;
+        std::vector<uint32_t> u32; // UINT32 values or dictionary indexes
+        std::vector<uint64_t> u64;
+        std::vector<int32_t>  offsets; // UTF8
+        std::string           data;
+        int64_t               dictionary_id = -1;
+        std::unordered_map<std::string, int32_t> dictionary;
+        std::vector<int32_t>                     dictionary_offsets;
+        std::string                              dictionary_data;
+    };
+
+    static bool fail(const std::string &message, std::string *error)
+    {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+
+    static void append_string(
+        std::vector<int32_t> &offsets, std::string &data, const std::string &value)
+    {
+        if (offsets.empty()) {
+            offsets.push_back(0);
+        }
+        data += value;
+        offsets.push_back(static_cast<int32_t>(data.size()));
+    }
+
+    // Body buffers are 8-byte aligned; a null buffer is an absent validity bitmap
+    static void add_buffer(
+        std::string                        &body,
+        std::vector<std::vector<uint64_t>> &buffers,
+        const void                         *data,
+        size_t                              size)
+    {
+        buffers.push_back({body.size(), size});
+        body.append(static_cast<const char *>(data), data ? size : 0);
+        body.append((8 - body.size() % 8) % 8, '\0');
+    }
+
+    FbRef field(const Column &column) const
+    {
+        auto field = fb_table();
+        field->child(0, fb_string(column.name)).scalar(1, 1, 0);
+        if (column.type == Type::UINT32 || column.type == Type::UINT64) {
+            field->scalar(2, 1, TYPE_INT)
+                .child(3, int_type(column.type == Type::UINT32 ? 32 : 64, false));
+        } else {
+            field->scalar(2, 1, TYPE_UTF8).child(3, fb_table());
+        }
+        if (column.type == Type::DICTIONARY) {
+            auto encoding = fb_table();
+            encoding->scalar(0, 8, column.dictionary_id).child(1, int_type(32, true));
+            field->child(4, encoding);
+        }
+        field->child(5, fb_tables({}));
+        return field;
+    }
+
+    FbRef schema() const
+    {
+        std::vector<FbRef> fields;
+        for (const auto &column : columns_) {
+            fields.push_back(field(column));
+        }
+        auto schema = fb_table();
+        schema->scalar(0, 2, 0).child(1, fb_tables(std::move(fields)));
+        return schema;
+    }
+
+    static FbRef record_batch(
+        size_t                                    rows,
+        const std::vector<std::vector<uint64_t>> &nodes,
+        const std::vector<std::vector<uint64_t>> &buffers)
+    {
+        auto batch = fb_table();
+        batch->scalar(0, 8, rows).child(1, fb_structs(nodes, 16)).child(2, fb_structs(buffers, 16));
+        return batch;
+    }
+
+    void flush()
+    {
+        if (rows_ == 0) {
+            return;
+        }
+
+        std::string                        body;
+        std::vector<std::vector<uint64_t>> nodes;
+        std::vector<std::vector<uint64_t>> buffers;
+        for (auto &column : columns_) {
+            nodes.push_back({rows_, 0});
+            add_buffer(body, buffers, nullptr, 0);
+            switch (column.type) {
+            case Type::UINT32:
+            case Type::DICTIONARY:
+                add_buffer(body, buffers, column.u32.data(), column.u32.size() * sizeof(uint32_t));
+                break;
+            case Type::UINT64:
+                add_buffer(body, buffers, column.u64.data(), column.u64.size() * sizeof(uint64_t));
+                break;
+            case Type::UTF8:
+                add_buffer(
+                    body, buffers, column.offsets.data(), column.offsets.size() * sizeof(int32_t));
+                add_buffer(body, buffers, column.data.data(), column.data.size());
+                break;
+            }
+            column.u32.clear();
+            column.u64.clear();
+            column.offsets.assign(1, 0);
+            column.data.clear();
+        }
+
+        batches_.push_back(write_message(HEADER_BATCH, record_batch(rows_, nodes, buffers), body));
+        rows_ = 0;
+    }
+
+    // Encapsulated message: continuation marker, metadata length, metadata, body; returns the
+    // footer Block (offset, metadata length, body length)
+    std::vector<uint64_t> write_message(uint64_t header_type, FbRef header, const std::string &body)
+    {
+        auto message = fb_table();
+        message->scalar(0, 2, METADATA_V5)
+            .scalar(1, 1, header_type)
+            .child(2, std::move(header))
+            .scalar(3, 8, body.size());
+        std::string metadata = FbWriter().finish(*message);
+
+        uint64_t    offset = position_;
+        std::string prefix("\xFF\xFF\xFF\xFF", 4);
+        for (size_t b = 0; b < 4; b++) {
+            prefix.push_back(static_cast<char>((metadata.size() >> (8 * b)) & 0xFF));
+        }
+        write_raw(prefix);
+        write_raw(metadata);
+        write_raw(body);
+        return {offset, prefix.size() + metadata.size(), body.size()};
+    }
+
+    void write_raw(const std::string &bytes)
+    {
+        output_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        position_ += bytes.size();
+    }
+
+    size_t                             batch_rows_;
+    size_t                             rows_ = 0;
+    std::vector<Column>                columns_;
+    std::string                        path_;
+    std::ofstream                      output_;
+    uint64_t                           position_ = 0;
+    std::vector<std::vector<uint64_t>> batches_;
+    std::vector<std::vector<uint64_t>> dictionaries_;
+};
+
+namespace {
+
+enum RegisterColumn {
+    REG_ID,
+    REG_PATH,
+    REG_NAME,
+    REG_ADDRESS,
+    REG_SIZE,
+    REG_WIDTH,
+    REG_RESET,
+    REG_DESC
+};
+enum FieldColumn {
+    FIELD_REGISTER,
+    FIELD_NAME,
+    FIELD_LSB,
+    FIELD_MSB,
+    FIELD_WIDTH,
+    FIELD_RESET,
+    FIELD_SW,
+    FIELD_HW,
+    FIELD_ONREAD,
+    FIELD_ONWRITE,
+    FIELD_DESC
+};
+
+std::string property_text(const ElaboratedNode &node, const std::string &name)
+{
+    auto it = node.properties.find(name);
+    if (it == node.properties.end()) {
+        return "";
+    }
+    switch (it->second.type) {
+    case PropertyValue::INTEGER:
+        return std::to_string(it->second.int_val);
+    case PropertyValue::BOOLEAN:
+        return it->second.bool_val ? "true" : "false";
+    default:
+        return it->second.string_val;
+    }
+}
+
+} // namespace
+
+ArrowExporter::ArrowExporter(size_t batch_rows)
+    : batch_rows_(batch_rows > 0 ? batch_rows : 1)
+{}
+
+ArrowExporter::~ArrowExporter() = default;
+
+bool ArrowExporter::open(
+    const std::string &registers_path, const std::string &fields_path, std::string *error)
+{
+    using Type = TableWriter::Type;
+    registers_ = std::make_unique<TableWriter>(
+        std::vector<std::pair<std::string, Type>>{
+            {"id", Type::UINT32},
+            {"path", Type::UTF8},
+            {"name", Type::DICTIONARY},
+            {"address", Type::UINT64},
+            {"size", Type::UINT64},
+            {"width", Type::UINT32},
+            {"reset", Type::UINT64},
+            {"desc", Type::UTF8}},
+        batch_rows_);
+    fields_ = std::make_unique<TableWriter>(
+        std::vector<std::pair<std::string, Type>>{
+            {"register_id", Type::UINT32},
+            {"name", Type::DICTIONARY},
+            {"lsb", Type::UINT32},
+            {"msb", Type::UINT32},
+            {"width", Type::UINT32},
+            {"reset", Type::UINT64},
+            {"sw", Type::DICTIONARY},
+            {"hw", Type::DICTIONARY},
+            {"onread", Type::DICTIONARY},
+            {"onwrite", Type::DICTIONARY},
+            {"desc", Type::UTF8}},
+        batch_rows_);
+    register_count_ = 0;
+    field_count_    = 0;
+    return registers_->open(registers_path, error) && fields_->open(fields_path, error);
+}
+
+bool ArrowExporter::finish(std::string *error)
+{
+    trace::Span span("columnar_finish", "output");
+    bool        ok = registers_ && registers_->finish(error) && fields_->finish(error);
+    registers_.reset();
+    fields_.reset();
+    return ok;
+}
+
+void ArrowExporter::add_model(ElaboratedNode &root)
+{
+    paths_ = std::make_unique<PathTable>(root, [](const ElaboratedNode &node) {
+        return dynamic_cast<const ElaboratedField *>(&node) == nullptr;
+    });
+    root.accept_visitor(*this);
+    paths_.reset();
+}
+
+void ArrowExporter::visit_children(ElaboratedNode &node)
+{
+    for (auto &child : node.children) {
+        child->accept_visitor(*this);
+    }
+}
+
+void ArrowExporter::visit(ElaboratedAddrmap &node)
+{
+    visit_children(node);
+}
+
+void ArrowExporter::visit(ElaboratedRegfile &node)
+{
+    visit_children(node);
+}
+
+void ArrowExporter::visit(ElaboratedMem &node)
+{
+    visit_children(node);
+}
+
+void ArrowExporter::visit(ElaboratedReg &node)
+{
+    if (!registers_) {
+        return;
+    }
+
+    const uint64_t id = register_count_++;
+    registers_->set(REG_ID, id);
+    const uint32_t path_id = paths_ ? paths_->find(&node) : PathTable::NONE;
+    registers_->set(
+        REG_PATH, path_id != PathTable::NONE ? paths_->join(path_id) : node.get_hierarchical_path());
+    registers_->set(REG_NAME, node.inst_name);
+    registers_->set(REG_ADDRESS, node.absolute_address);
+    registers_->set(REG_SIZE, node.size);
+    registers_->set(REG_WIDTH, node.register_width);
+    registers_->set(REG_RESET, node.reset_low64());
+    registers_->set(REG_DESC, property_text(node, "desc"));
+    registers_->end_row();
+
+    for (const auto &child : node.children) {
+        auto field = dynamic_cast<const ElaboratedField *>(child.get());
+        if (!field) {
+            continue;
+        }
+        fields_->set(FIELD_REGISTER, id);
+        fields_->set(FIELD_NAME, field->inst_name);
+        fields_->set(FIELD_LSB, field->lsb);
+        fields_->set(FIELD_MSB, field->msb);
+        fields_->set(FIELD_WIDTH, field->width);
+        fields_->set(FIELD_RESET, field->reset_value);
+        fields_->set(FIELD_SW, property_text(*field, "sw"));
+        fields_->set(FIELD_HW, property_text(*field, "hw"));
+        fields_->set(FIELD_ONREAD, property_text(*field, "onread"));
+        fields_->set(FIELD_ONWRITE, property_text(*field, "onwrite"));
+        fields_->set(FIELD_DESC, property_text(*field, "desc"));
+        fields_->end_row();
+        field_count_++;
+    }
+}
+
+} // namespace columnar
+
+} // namespace systemrdl
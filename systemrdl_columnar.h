@@ -0,0 +1,90 @@
+#pragma once
+
+#include "elaborator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace systemrdl {
+
+/**
+ * @brief Columnar export of registers and fields
+ *
+ * Writes two tables in the Apache Arrow IPC file format (readable by pyarrow,
+ * pandas, polars, DuckDB and Spark) without depending on the Arrow
+ * libraries. Rows are buffered into record batches of a fixed number of rows
+ * and written as each batch fills, so the export follows the model in one
+ * pass and works as a streaming sink. Names, access types and read/write side
+ * effects are dictionary-encoded; the dictionaries are written once, after the
+ * last batch, as the file format allows.
+ *
+ * Registers: id, path, name, address, size, width, reset (low 64 bits), desc.
+ * Fields: register_id, name, lsb, msb, width, reset, sw, hw, onread, onwrite, desc.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::columnar::ArrowExporter exporter;
+ * std::string                        error;
+ * if (!exporter.open("soc_registers.arrow", "soc_fields.arrow", &error)) { ... }
+ *
+ * exporter.add_model(*model); // or use it as SystemRDLElaborator::Options::stream_sink
+ * exporter.finish(&error);
+ * ```
+ *
+ * @code{.py}
+ * import pyarrow as pa
+ * registers = pa.ipc.open_file("soc_registers.arrow").read_all()
+ * @endcode
+ */
+class PathTable;
+
+namespace columnar {
+
+class TableWriter;
+
+class ArrowExporter : public ElaboratedNodeVisitor
+{
+public:
+    explicit ArrowExporter(size_t batch_rows = 65536);
+    ~ArrowExporter() override;
+
+    ArrowExporter(const ArrowExporter &)            = delete;
+    ArrowExporter &operator=(const ArrowExporter &) = delete;
+
+    bool open(
+        const std::string &registers_path,
+        const std::string &fields_path,
+        std::string       *error = nullptr);
+
+    // Append the registers (and the registers inside memories) of a model. Paths are joined
+    // from a PathTable of the model; streamed registers walk their parents instead
+    void add_model(ElaboratedNode &root);
+
+    // Write the remaining rows, the dictionaries and the file footers
+    bool finish(std::string *error = nullptr);
+
+    size_t register_count() const { return register_count_; }
+    size_t field_count() const { return field_count_; }
+
+    // Visiting a register appends it and its fields; containers are descended into
+    void visit(ElaboratedAddrmap &node) override;
+    void visit(ElaboratedRegfile &node) override;
+    void visit(ElaboratedReg &node) override;
+    void visit(ElaboratedField &node) override {}
+    void visit(ElaboratedMem &node) override;
+
+private:
+    void visit_children(ElaboratedNode &node);
+
+    size_t                       batch_rows_;
+    std::unique_ptr<TableWriter> registers_;
+    std::unique_ptr<TableWriter> fields_;
+    std::unique_ptr<PathTable>   paths_; // Set during add_model()
+    size_t                       register_count_ = 0;
+    size_t                       field_count_    = 0;
+};
+
+} // namespace columnar
+
+} // namespace systemrdl
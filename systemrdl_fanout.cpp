@@ -0,0 +1,542 @@
+#include "systemrdl_fanout.h"
+
+#include "systemrdl_link.h"
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace systemrdl {
+namespace fanout {
+
+namespace {
+
+// Root-level addrmap definitions, later files hiding earlier ones like in the elaborator
+void collect_addrmaps(
+    SystemRDLParser::RootContext                                         *root,
+    std::map<std::string, SystemRDLParser::Component_named_defContext *> &addrmaps)
+{
+    for (auto root_elem : root->root_elem()) {
+        auto comp_def  = root_elem->component_def();
+        auto named_def = comp_def ? comp_def->component_named_def() : nullptr;
+        auto primary   = named_def ? named_def->component_type()->component_type_primary()
+                                   : nullptr;
+        if (primary && primary->getText() == "addrmap") {
+            addrmaps[named_def->ID()->getText()] = named_def;
+        }
+    }
+}
+
+SystemRDLParser::Component_named_defContext *find_top(
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots,
+    const std::string                                 &top)
+{
+    // Same search order as SystemRDLElaborator: main file, then the latest included file
+    std::vector<SystemRDLParser::RootContext *> roots{ast_root};
+    roots.insert(roots.end(), library_roots.rbegin(), library_roots.rend());
+    for (auto root : roots) {
+        for (auto root_elem : root->root_elem()) {
+            auto comp_def  = root_elem->component_def();
+            auto named_def = comp_def ? comp_def->component_named_def() : nullptr;
+            auto primary   = named_def ? named_def->component_type()->component_type_primary()
+                                       : nullptr;
+            if (primary && primary->getText() == "addrmap"
+                && (top.empty() || named_def->ID()->getText() == top)) {
+                return named_def;
+            }
+        }
+    }
+    return nullptr;
+}
+
+#if !defined(_WIN32)
+
+// Ignores SIGPIPE while alive, so a worker that died cannot take the parent down, and then
+// restores the caller's handler with its flags and mask
+class SigpipeGuard
+{
+public:
+    SigpipeGuard()
+    {
+        struct sigaction ignore = {};
+        ignore.sa_handler       = SIG_IGN;
+        sigemptyset(&ignore.sa_mask);
+        saved_ = sigaction(SIGPIPE, &ignore, &previous_) == 0;
+    }
+
+    ~SigpipeGuard()
+    {
+        if (saved_) {
+            sigaction(SIGPIPE, &previous_, nullptr);
+        }
+    }
+
+    SigpipeGuard(const SigpipeGuard &)            = delete;
+    SigpipeGuard &operator=(const SigpipeGuard &) = delete;
+
+private:
+    struct sigaction previous_ = {};
+    bool             saved_    = false;
+};
+
+bool write_all(int fd, const void *data, size_t size)
+{
+    auto bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool read_all(int fd, void *data, size_t size)
+{
+    auto bytes = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t count = ::read(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// Messages are a status byte, a 64-bit length and the payload, in host byte order
+bool write_message(int fd, uint8_t status, const std::string &payload)
+{
+    uint64_t size = payload.size();
+    return write_all(fd, &status, sizeof(status)) && write_all(fd, &size, sizeof(size))
+           && write_all(fd, payload.data(), payload.size());
+}
+
+bool read_message(int fd, uint8_t &status, std::string &payload)
+{
+    uint64_t size = 0;
+    if (!read_all(fd, &status, sizeof(status)) || !read_all(fd, &size, sizeof(size))) {
+        return false;
+    }
+    payload.resize(size);
+    return read_all(fd, &payload[0], size);
+}
+
+enum Status : uint8_t { TASK = 0, MODEL = 1, ERRORS = 2 };
+
+// Text of one tab-separated error column, without tabs or line breaks
+std::string error_column(std::string text)
+{
+    std::replace(text.begin(), text.end(), '\n', ' ');
+    std::replace(text.begin(), text.end(), '\t', ' ');
+    return text;
+}
+
+// One error per line: line, column, count, file, code and message separated by tabs
+std::string encode_errors(const std::vector<SystemRDLElaborator::ElaborationError> &errors)
+{
+    std::ostringstream oss;
+    for (const auto &error : errors) {
+        oss << error.line << '\t' << error.column << '\t' << error.count << '\t'
+            << error_column(error.file) << '\t' << error_column(error.code) << '\t'
+            << error_column(error.message) << '\n';
+    }
+    return oss.str();
+}
+
+std::vector<SystemRDLElaborator::ElaborationError> decode_errors(const std::string &text)
+{
+    std::vector<SystemRDLElaborator::ElaborationError> errors;
+    std::istringstream                                 lines(text);
+    std::string                                        line;
+    while (std::getline(lines, line)) {
+        SystemRDLElaborator::ElaborationError error;
+        std::istringstream                    fields(line);
+        std::string                           value;
+        std::getline(fields, value, '\t');
+        error.line = std::strtoul(value.c_str(), nullptr, 10);
+        std::getline(fields, value, '\t');
+        error.column = std::strtoul(value.c_str(), nullptr, 10);
+        std::getline(fields, value, '\t');
+        error.count = std::max<size_t>(1, std::strtoul(value.c_str(), nullptr, 10));
+        std::getline(fields, error.file, '\t');
+        std::getline(fields, error.code, '\t');
+        std::getline(fields, error.message);
+        errors.push_back(std::move(error));
+    }
+    return errors;
+}
+
+// Worker process: elaborate each requested addrmap and send back its model until the queue closes
+[[noreturn]] void worker_main(
+    int                                                task_fd,
+    int                                                result_fd,
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots,
+    SystemRDLElaborator::Options                       options)
+{
+    options.linked_blocks.clear();
+    options.external_blocks.clear();
+    options.stream_sink = nullptr;
+    options.lazy        = false;
+
+    uint8_t     status = 0;
+    std::string name;
+    while (read_message(task_fd, status, name)) {
+        options.top = name;
+
+        SystemRDLElaborator elaborator;
+        elaborator.set_options(options);
+        elaborator.set_library_roots(library_roots);
+        auto model = elaborator.elaborate(ast_root);
+
+        bool sent;
+        if (elaborator.has_errors() || !model) {
+            sent = write_message(result_fd, ERRORS, encode_errors(elaborator.get_errors()));
+        } else {
+            sent = write_message(result_fd, MODEL, link::serialize_model(*model));
+        }
+        if (!sent) {
+            break;
+        }
+    }
+    // Skip the parent's atexit handlers and static destructors (trace session, caches)
+    _exit(0);
+}
+
+#endif
+
+} // namespace
+
+std::vector<std::string> partition(
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots,
+    const std::string                                 &top)
+{
+    auto top_def = ast_root ? find_top(ast_root, library_roots, top) : nullptr;
+    if (!top_def || !top_def->component_body()) {
+        return {};
+    }
+
+    std::map<std::string, SystemRDLParser::Component_named_defContext *> addrmaps;
+    for (auto root : library_roots) {
+        collect_addrmaps(root, addrmaps);
+    }
+    collect_addrmaps(ast_root, addrmaps);
+
+    std::vector<std::string>           units;
+    std::map<std::string, std::string> instance_types; // Instance name -> unit
+    std::set<std::string>              local;          // Definitions nested in the top body
+    std::set<std::string>              excluded;
+
+    auto body_elems = top_def->component_body()->component_body_elem();
+    for (auto body_elem : body_elems) {
+        auto comp_def  = body_elem->component_def();
+        auto named_def = comp_def ? comp_def->component_named_def() : nullptr;
+        if (named_def) {
+            local.insert(named_def->ID()->getText());
+        }
+    }
+
+    for (auto body_elem : body_elems) {
+        auto inst = body_elem->explicit_component_inst();
+        if (!inst) {
+            continue;
+        }
+        std::string type_name = inst->ID()->getText();
+        if (!addrmaps.count(type_name) || local.count(type_name)
+            || addrmaps[type_name] == top_def) {
+            continue;
+        }
+        if (inst->component_insts()->param_inst()) {
+            excluded.insert(type_name);
+            continue;
+        }
+        for (auto component_inst : inst->component_insts()->component_inst()) {
+            instance_types[component_inst->ID()->getText()] = type_name;
+        }
+        if (std::find(units.begin(), units.end(), type_name) == units.end()) {
+            units.push_back(type_name);
+        }
+    }
+
+    // Assignments below a block's instance need its children during the top's elaboration
+    for (auto body_elem : body_elems) {
+        auto assignment = body_elem->dynamic_property_assignment();
+        if (!assignment) {
+            continue;
+        }
+        auto elements = assignment->instance_ref()->instance_ref_element();
+        auto it       = instance_types.find(elements.front()->ID()->getText());
+        if (elements.size() > 1 && it != instance_types.end()) {
+            excluded.insert(it->second);
+        }
+    }
+
+    units.erase(
+        std::remove_if(
+            units.begin(),
+            units.end(),
+            [&](const std::string &unit) { return excluded.count(unit) > 0; }),
+        units.end());
+    return units;
+}
+
+Driver::Driver(SystemRDLElaborator::Options options, size_t jobs)
+    : options_(std::move(options))
+    , jobs_(jobs ? jobs : std::max(1u, std::thread::hardware_concurrency()))
+{}
+
+void Driver::add_error(const std::string &message, const char *code)
+{
+    SystemRDLElaborator::ElaborationError error;
+    error.message = message;
+    error.code    = code;
+    errors_.push_back(std::move(error));
+}
+
+// Workers elaborating the same definition report its errors again; count them on one entry
+void Driver::merge_error(SystemRDLElaborator::ElaborationError error)
+{
+    for (auto &existing : errors_) {
+        if (existing.line != 0 && existing.file == error.file && existing.line == error.line
+            && existing.column == error.column && existing.code == error.code) {
+            existing.count += error.count;
+            return;
+        }
+    }
+    errors_.push_back(std::move(error));
+}
+
+bool Driver::run_workers(
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots,
+    const std::vector<std::string>                    &units,
+    std::vector<std::string>                          &models)
+{
+#if defined(_WIN32)
+    (void) ast_root;
+    (void) library_roots;
+    (void) units;
+    (void) models;
+    return false;
+#else
+    struct Worker
+    {
+        pid_t       pid       = -1;
+        int         task_fd   = -1;
+        int         result_fd = -1;
+        std::string unit; // Unit in progress, empty when idle
+    };
+
+    trace::Span span("fanout", "elaborate");
+    if (span.active()) {
+        span.add_arg("units", std::to_string(units.size()));
+    }
+
+    SigpipeGuard sigpipe_guard;
+
+    std::vector<Worker> workers;
+    for (size_t i = 0; i < std::min(jobs_, units.size()); i++) {
+        int task_pipe[2];
+        int result_pipe[2];
+        if (pipe(task_pipe) != 0) {
+            break;
+        }
+        if (pipe(result_pipe) != 0) {
+            close(task_pipe[0]);
+            close(task_pipe[1]);
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(task_pipe[1]);
+            close(result_pipe[0]);
+            for (const auto &worker : workers) {
+                close(worker.task_fd);
+                close(worker.result_fd);
+            }
+            worker_main(task_pipe[0], result_pipe[1], ast_root, library_roots, options_);
+        }
+
+        close(task_pipe[0]);
+        close(result_pipe[1]);
+        if (pid < 0) {
+            close(task_pipe[1]);
+            close(result_pipe[0]);
+            break;
+        }
+        workers.push_back({pid, task_pipe[1], result_pipe[0], ""});
+    }
+    worker_count_ = workers.size();
+
+    bool   ok   = !workers.empty();
+    size_t next = 0;
+    auto   dispatch = [&](Worker &worker) {
+        if (next < units.size() && write_message(worker.task_fd, TASK, units[next])) {
+            worker.unit = units[next++];
+        }
+    };
+    for (auto &worker : workers) {
+        dispatch(worker);
+    }
+
+    for (;;) {
+        std::vector<pollfd>   fds;
+        std::vector<Worker *> busy;
+        for (auto &worker : workers) {
+            if (!worker.unit.empty()) {
+                fds.push_back({worker.result_fd, POLLIN, 0});
+                busy.push_back(&worker);
+            }
+        }
+        if (busy.empty()) {
+            break;
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            add_error("Cannot wait for elaboration workers", "fanout");
+            ok = false;
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (!fds[i].revents) {
+                continue;
+            }
+            Worker     &worker = *busy[i];
+            uint8_t     status = 0;
+            std::string payload;
+            if (!read_message(worker.result_fd, status, payload)) {
+                add_error(
+                    "Elaboration worker for '" + worker.unit + "' exited unexpectedly", "fanout");
+                ok          = false;
+                worker.unit = "";
+                close(worker.task_fd);
+                worker.task_fd = -1;
+                continue;
+            }
+
+            if (status == MODEL) {
+                models.push_back(std::move(payload));
+            } else {
+                for (auto &error : decode_errors(payload)) {
+                    merge_error(std::move(error));
+                }
+                ok = false;
+            }
+            worker.unit = "";
+            if (ok) {
+                dispatch(worker);
+            }
+        }
+    }
+    if (ok && next < units.size()) {
+        add_error("Not every block could be sent to a worker", "fanout");
+        ok = false;
+    }
+
+    // Closing the queue ends the workers
+    for (auto &worker : workers) {
+        if (worker.task_fd >= 0) {
+            close(worker.task_fd);
+        }
+        close(worker.result_fd);
+        int status = 0;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+        }
+    }
+    return ok;
+#endif
+}
+
+std::unique_ptr<ElaboratedAddrmap> Driver::elaborate(
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots)
+{
+    errors_.clear();
+    unit_count_   = 0;
+    worker_count_ = 0;
+
+    auto                     linked = linker_.linked_blocks();
+    std::vector<std::string> units  = partition(ast_root, library_roots, options_.top);
+    for (auto it = units.begin(); it != units.end();) {
+        // Blocks already provided as linked models are not elaborated again
+        it = linked.count(*it) ? units.erase(it) : it + 1;
+    }
+
+    std::vector<std::string> models;
+    if (!units.empty() && jobs_ > 1) {
+        if (!run_workers(ast_root, library_roots, units, models)) {
+            if (!errors_.empty()) {
+                return nullptr;
+            }
+            models.clear(); // No worker could be started: elaborate everything here
+        }
+        for (auto &model : models) {
+            std::string error;
+            if (!linker_.add_model(std::move(model), &error)) {
+                add_error("Invalid model from elaboration worker: " + error, "fanout");
+                return nullptr;
+            }
+        }
+        unit_count_ = models.size();
+    }
+
+    // Models passed in are placed at their saved size; blocks from workers are placed as the
+    // in-process elaboration would place them, so the merged model is the same
+    SystemRDLElaborator::Options options = options_;
+    for (const auto &block : linker_.linked_blocks()) {
+        if (linked.count(block.first)) {
+            options.linked_blocks[block.first] = block.second;
+        } else {
+            options.external_blocks.insert(block.first);
+        }
+    }
+
+    SystemRDLElaborator elaborator;
+    elaborator.set_options(options);
+    elaborator.set_library_roots(library_roots);
+    auto top = elaborator.elaborate(ast_root);
+    if (elaborator.has_errors() || !top) {
+        errors_ = elaborator.get_errors();
+        return nullptr;
+    }
+
+    // In-process elaboration only checks overlaps within each container, and across the map
+    // when models are linked; blocks from workers alone must not add the global check
+    bool link = !options.linked_blocks.empty() || !options.external_blocks.empty();
+    if (link && !linker_.link(*top, !options.linked_blocks.empty())) {
+        errors_ = linker_.get_errors();
+        return nullptr;
+    }
+    return top;
+}
+
+} // namespace fanout
+} // namespace systemrdl
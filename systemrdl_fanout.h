@@ -0,0 +1,94 @@
+#pragma once
+
+#include "elaborator.h"
+#include "systemrdl_link.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Multi-process elaboration of large designs
+ *
+ * The top-level addrmap is split into the addrmap definitions it instantiates
+ * directly. Each of them is elaborated in a forked worker process, which sends
+ * back the serialized model (see systemrdl_link.h) over a pipe and releases
+ * its memory. The parent elaborates the top level without the bodies of those
+ * blocks, placing them as an in-process elaboration would, and links the models
+ * into it. The result equals elaborating in one process, yet no single process
+ * holds the elaboration state of the whole design.
+ *
+ * Workers take units from a queue in the parent as they finish, so large and
+ * small blocks balance across processes. Only POSIX fork() and pipes are used;
+ * on other platforms the driver elaborates in-process.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::fanout::Driver driver(options, 8);
+ * auto model = driver.elaborate(ast_root, library_roots);
+ * ```
+ */
+namespace fanout {
+
+/**
+ * @brief Addrmap definitions to elaborate separately for a top level
+ *
+ * Named addrmaps defined at the root of the file or an included file and
+ * instantiated directly in the top without parameters, in instantiation
+ * order. Blocks whose inner instances are the target of dynamic property
+ * assignments in the top are left to the parent.
+ */
+std::vector<std::string> partition(
+    SystemRDLParser::RootContext                      *ast_root,
+    const std::vector<SystemRDLParser::RootContext *> &library_roots,
+    const std::string                                 &top);
+
+class Driver
+{
+public:
+    // jobs = 0 uses one worker per hardware thread
+    explicit Driver(SystemRDLElaborator::Options options, size_t jobs = 0);
+
+    /**
+     * @brief Elaborate the top level with its sub-addrmaps fanned out to workers
+     * @return nullptr on errors (see get_errors())
+     */
+    std::unique_ptr<ElaboratedAddrmap> elaborate(
+        SystemRDLParser::RootContext                      *ast_root,
+        const std::vector<SystemRDLParser::RootContext *> &library_roots = {});
+
+    // Models of blocks elaborated elsewhere; they are linked as well and not sent to workers
+    link::Linker &linker() { return linker_; }
+
+    const std::vector<SystemRDLElaborator::ElaborationError> &get_errors() const
+    {
+        return errors_;
+    }
+
+    // Blocks elaborated by workers and the number of worker processes used in the last run
+    size_t get_unit_count() const { return unit_count_; }
+    size_t get_worker_count() const { return worker_count_; }
+
+private:
+    bool run_workers(
+        SystemRDLParser::RootContext                      *ast_root,
+        const std::vector<SystemRDLParser::RootContext *> &library_roots,
+        const std::vector<std::string>                    &units,
+        std::vector<std::string>                          &models);
+
+    void add_error(const std::string &message, const char *code);
+    void merge_error(SystemRDLElaborator::ElaborationError error);
+
+    SystemRDLElaborator::Options                       options_;
+    size_t                                             jobs_;
+    link::Linker                                       linker_;
+    std::vector<SystemRDLElaborator::ElaborationError> errors_;
+    size_t                                             unit_count_   = 0;
+    size_t                                             worker_count_ = 0;
+};
+
+} // namespace fanout
+
+} // namespace systemrdl
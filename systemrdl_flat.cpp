@@ -0,0 +1,210 @@
+#include "systemrdl_flat.h"
+
+#include "systemrdl_path.h"
+#include "systemrdl_trace.h"
+#include <algorithm>
+
+namespace systemrdl {
+
+namespace {
+
+size_t count_nodes(const ElaboratedNode &node)
+{
+    size_t count = 1;
+    for (const auto &child : node.children) {
+        count += count_nodes(*child);
+    }
+    return count;
+}
+
+// sw/hw property of a field, falling back to the field's access member
+FlatModel::Access field_access(const ElaboratedField &field, const char *property, bool software)
+{
+    auto it = field.properties.find(property);
+    if (it == field.properties.end() || it->second.type != PropertyValue::STRING) {
+        return software ? field.sw_access : field.hw_access;
+    }
+
+    const std::string &value = it->second.string_val;
+    if (value == "rw" || value == "wr" || value == "rw1" || value == "w1r") {
+        return ElaboratedField::RW;
+    } else if (value == "r") {
+        return ElaboratedField::R;
+    } else if (value == "w" || value == "w1") {
+        return ElaboratedField::W;
+    } else if (value == "na") {
+        return ElaboratedField::NA;
+    }
+    return software ? field.sw_access : field.hw_access;
+}
+
+} // namespace
+
+FlatModel::FlatModel(const ElaboratedNode &root)
+{
+    trace::Span span("build_flat_model", "output");
+
+    const size_t rows = count_nodes(root);
+    address_.reserve(rows);
+    size_.reserve(rows);
+    width_.reserve(rows);
+    parent_.reserve(rows);
+    name_.reserve(rows);
+    kind_.reserve(rows);
+    sw_.reserve(rows);
+    hw_.reserve(rows);
+    lsb_.reserve(rows);
+    msb_.reserve(rows);
+    reset_.reserve(rows);
+
+    std::unordered_map<std::string, uint32_t> name_ids;
+    add(root, NONE, name_ids);
+
+    if (span.active()) {
+        span.add_arg("rows", std::to_string(rows));
+        span.add_arg("names", std::to_string(names_.size()));
+    }
+}
+
+void FlatModel::add(
+    const ElaboratedNode                      &node,
+    uint32_t                                   parent,
+    std::unordered_map<std::string, uint32_t> &name_ids)
+{
+    const uint32_t row = static_cast<uint32_t>(kind_.size());
+
+    auto name = name_ids.emplace(node.inst_name, static_cast<uint32_t>(names_.size()));
+    if (name.second) {
+        names_.push_back(node.inst_name);
+    }
+
+    Kind     kind  = ADDRMAP;
+    uint32_t width = 0;
+    Access   sw    = ElaboratedField::NA;
+    Access   hw    = ElaboratedField::NA;
+    uint32_t lsb   = 0;
+    uint32_t msb   = 0;
+    uint64_t reset = 0;
+    if (dynamic_cast<const ElaboratedRegfile *>(&node)) {
+        kind = REGFILE;
+    } else if (auto reg = dynamic_cast<const ElaboratedReg *>(&node)) {
+        kind  = REG;
+        width = reg->register_width;
+        reset = reg->reset_low64();
+    } else if (auto field = dynamic_cast<const ElaboratedField *>(&node)) {
+        kind  = FIELD;
+        width = static_cast<uint32_t>(field->width);
+        sw    = field_access(*field, "sw", true);
+        hw    = field_access(*field, "hw", false);
+        lsb   = static_cast<uint32_t>(field->lsb);
+        msb   = static_cast<uint32_t>(field->msb);
+        reset = field->reset_value;
+    } else if (auto mem = dynamic_cast<const ElaboratedMem *>(&node)) {
+        kind  = MEM;
+        width = static_cast<uint32_t>(mem->data_width);
+    }
+
+    address_.push_back(node.absolute_address);
+    size_.push_back(node.size);
+    width_.push_back(width);
+    parent_.push_back(parent);
+    name_.push_back(name.first->second);
+    kind_.push_back(kind);
+    sw_.push_back(sw);
+    hw_.push_back(hw);
+    lsb_.push_back(lsb);
+    msb_.push_back(msb);
+    reset_.push_back(reset);
+
+    for (const auto &child : node.children) {
+        add(*child, row, name_ids);
+    }
+}
+
+const char *FlatModel::kind_name(Kind kind)
+{
+    switch (kind) {
+    case ADDRMAP:
+        return "addrmap";
+    case REGFILE:
+        return "regfile";
+    case REG:
+        return "reg";
+    case FIELD:
+        return "field";
+    case MEM:
+        return "mem";
+    default:
+        return "unknown";
+    }
+}
+
+std::string FlatModel::path(uint32_t row, const std::string &separator) const
+{
+    return join_path(
+        row,
+        NONE,
+        [this](uint32_t up) -> const std::string & { return name_of(up); },
+        [this](uint32_t up) { return parent_[up]; },
+        separator);
+}
+
+std::vector<uint32_t> FlatModel::select(Kind kind) const
+{
+    const Kind *kinds = kind_.data();
+    return filter([kinds, kind](uint32_t row) { return kinds[row] == kind; });
+}
+
+std::vector<uint32_t> FlatModel::select_address_range(Kind kind, Address begin, Address end) const
+{
+    const Kind    *kinds     = kind_.data();
+    const Address *addresses = address_.data();
+    return filter([=](uint32_t row) {
+        return (kinds[row] == kind) & (addresses[row] >= begin) & (addresses[row] < end);
+    });
+}
+
+size_t FlatModel::count(Kind kind) const
+{
+    size_t      count = 0;
+    const Kind *kinds = kind_.data();
+    for (size_t row = 0; row < kind_.size(); row++) {
+        count += kinds[row] == kind;
+    }
+    return count;
+}
+
+std::vector<size_t> FlatModel::width_histogram(Kind kind) const
+{
+    std::vector<size_t> histogram;
+    for (size_t row = 0; row < kind_.size(); row++) {
+        if (kind_[row] != kind) {
+            continue;
+        }
+        if (width_[row] >= histogram.size()) {
+            histogram.resize(width_[row] + 1, 0);
+        }
+        histogram[width_[row]]++;
+    }
+    return histogram;
+}
+
+std::array<size_t, FlatModel::ACCESS_COUNT> FlatModel::access_counts(bool software) const
+{
+    std::array<size_t, ACCESS_COUNT> counts{};
+    const std::vector<Access>       &access = software ? sw_ : hw_;
+    for (size_t row = 0; row < kind_.size(); row++) {
+        counts[access[row]] += kind_[row] == FIELD;
+    }
+    return counts;
+}
+
+std::vector<uint32_t> FlatModel::sorted_by_address(std::vector<uint32_t> rows) const
+{
+    std::stable_sort(rows.begin(), rows.end(), [this](uint32_t a, uint32_t b) {
+        return address_[a] < address_[b];
+    });
+    return rows;
+}
+
+} // namespace systemrdl
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "elaborator.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Struct-of-arrays view of an elaborated model
+ *
+ * Every node of the tree becomes a row, in preorder, and each attribute is
+ * stored in its own contiguous column: address, size, width, parent row,
+ * kind, software and hardware access, lsb/msb and reset. Names are indexes
+ * into a deduplicated name table. Scans over one or two columns (counting
+ * registers, histograms of widths, selecting an address range) touch only
+ * the bytes they need and compile to tight loops the compiler can
+ * vectorize. The view is a copy: it stays valid after the tree is released.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::FlatModel flat(*model);
+ * auto registers = flat.select(systemrdl::FlatModel::REG);
+ * auto widths    = flat.width_histogram(systemrdl::FlatModel::FIELD);
+ * auto sorted    = flat.sorted_by_address(registers);
+ * std::cout << flat.path(sorted.front()) << std::endl;
+ * ```
+ */
+class FlatModel
+{
+public:
+    enum Kind : uint8_t { ADDRMAP, REGFILE, REG, FIELD, MEM, KIND_COUNT };
+
+    // Values of ElaboratedField::AccessType; rows other than fields are NA
+    using Access                           = uint8_t;
+    static constexpr size_t   ACCESS_COUNT = ElaboratedField::NA + 1;
+    static constexpr uint32_t NONE         = UINT32_MAX;
+
+    FlatModel() = default;
+    explicit FlatModel(const ElaboratedNode &root);
+
+    size_t size() const { return kind_.size(); }
+
+    // Columns, indexed by row. width is the register width, the field width or the memory data
+    // width; parent is NONE for the root; name indexes names(); lsb and msb are set for fields;
+    // reset is a field's reset value or the low 64 bits of a register's
+    const std::vector<Address>  &address() const { return address_; }
+    const std::vector<Size>     &size_column() const { return size_; }
+    const std::vector<uint32_t> &width() const { return width_; }
+    const std::vector<uint32_t> &parent() const { return parent_; }
+    const std::vector<uint32_t> &name() const { return name_; }
+    const std::vector<Kind>     &kind() const { return kind_; }
+    const std::vector<Access>   &sw() const { return sw_; }
+    const std::vector<Access>   &hw() const { return hw_; }
+    const std::vector<uint32_t> &lsb() const { return lsb_; }
+    const std::vector<uint32_t> &msb() const { return msb_; }
+    const std::vector<uint64_t> &reset() const { return reset_; }
+
+    const std::vector<std::string> &names() const { return names_; }
+    const std::string              &name_of(uint32_t row) const { return names_[name_[row]]; }
+
+    static const char *kind_name(Kind kind);
+
+    // Dotted instance path of a row, e.g. "top.uart[0].ctrl"
+    std::string path(uint32_t row, const std::string &separator = ".") const;
+
+    // Rows for which pred(row) is true, in row order; the loop is branch-free
+    template <typename Pred> std::vector<uint32_t> filter(Pred pred) const
+    {
+        std::vector<uint32_t> rows(size());
+        size_t                count = 0;
+        for (uint32_t row = 0; row < rows.size(); row++) {
+            rows[count] = row;
+            count += pred(row) ? 1 : 0;
+        }
+        rows.resize(count);
+        return rows;
+    }
+
+    std::vector<uint32_t> select(Kind kind) const;
+    std::vector<uint32_t> select_address_range(Kind kind, Address begin, Address end) const;
+
+    size_t count(Kind kind) const;
+
+    // Number of rows of a kind for each width, indexed by width
+    std::vector<size_t> width_histogram(Kind kind) const;
+
+    // Number of field rows for each access type
+    std::array<size_t, ACCESS_COUNT> access_counts(bool software) const;
+
+    // The rows ordered by address; rows at the same address keep their order (parents first)
+    std::vector<uint32_t> sorted_by_address(std::vector<uint32_t> rows) const;
+
+private:
+    void add(
+        const ElaboratedNode                      &node,
+        uint32_t                                   parent,
+        std::unordered_map<std::string, uint32_t> &name_ids);
+
+    std::vector<Address>     address_;
+    std::vector<Size>        size_;
+    std::vector<uint32_t>    width_;
+    std::vector<uint32_t>    parent_;
+    std::vector<uint32_t>    name_;
+    std::vector<Kind>        kind_;
+    std::vector<Access>      sw_;
+    std::vector<Access>      hw_;
+    std::vector<uint32_t>    lsb_;
+    std::vector<uint32_t>    msb_;
+    std::vector<uint64_t>    reset_;
+    std::vector<std::string> names_;
+};
+
+} // namespace systemrdl
@@ -0,0 +1,303 @@
+#include "systemrdl_include.h"
+
+#include "SystemRDLLexer.h"
+#include "antlr4-runtime.h"
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace systemrdl {
+namespace include {
+
+namespace {
+
+// Collects syntax errors of one included file
+class DiagnosticListener : public antlr4::BaseErrorListener
+{
+public:
+    explicit DiagnosticListener(std::vector<Diagnostic> &diagnostics)
+        : diagnostics_(diagnostics)
+    {}
+
+    void syntaxError(
+        antlr4::Recognizer * /*recognizer*/,
+        antlr4::Token * /*offendingSymbol*/,
+        size_t             line,
+        size_t             column,
+        const std::string &msg,
+        std::exception_ptr /*e*/) override
+    {
+        Diagnostic diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.line     = line;
+        diagnostic.column   = column;
+        diagnostic.code     = "syntax";
+        diagnostic.message  = msg;
+        diagnostics_.push_back(std::move(diagnostic));
+    }
+
+private:
+    std::vector<Diagnostic> &diagnostics_;
+};
+
+Diagnostic make_error(const std::string &file, size_t line, const char *code, std::string msg)
+{
+    Diagnostic diagnostic;
+    diagnostic.severity = Diagnostic::Severity::Error;
+    diagnostic.file     = file;
+    diagnostic.line     = line;
+    diagnostic.code     = code;
+    diagnostic.message  = std::move(msg);
+    return diagnostic;
+}
+
+// Locate an included file: next to the including file, then in the search paths
+std::string find_include(
+    const std::string &name, const std::string &from, const std::vector<std::string> &search_paths)
+{
+    std::error_code ec;
+    fs::path        requested(name);
+    if (requested.is_absolute()) {
+        return fs::is_regular_file(requested, ec) ? requested.string() : std::string();
+    }
+
+    std::vector<fs::path> candidates;
+    candidates.push_back(from.empty() ? requested : fs::path(from).parent_path() / requested);
+    for (const auto &dir : search_paths) {
+        candidates.push_back(fs::path(dir) / requested);
+    }
+
+    for (const auto &candidate : candidates) {
+        if (fs::is_regular_file(candidate, ec)) {
+            return candidate.string();
+        }
+    }
+    return "";
+}
+
+std::string canonical_path(const std::string &path)
+{
+    std::error_code ec;
+    fs::path        canonical = fs::weakly_canonical(path, ec);
+    return ec ? path : canonical.string();
+}
+
+} // namespace
+
+struct ParsedFile::Storage
+{
+    std::unique_ptr<DiagnosticListener>        listener;
+    std::unique_ptr<antlr4::ANTLRInputStream>  input;
+    std::unique_ptr<SystemRDLLexer>            lexer;
+    std::unique_ptr<antlr4::CommonTokenStream> tokens;
+    std::unique_ptr<SystemRDLParser>           parser;
+};
+
+ParsedFile::ParsedFile()  = default;
+ParsedFile::~ParsedFile() = default;
+
+uint64_t content_hash(const std::string &content)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+ParseCache &ParseCache::global()
+{
+    static ParseCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ParsedFile> ParseCache::load(
+    const std::string &path, Visit &visit, std::string &error)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open include file: " + path;
+        return nullptr;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Nested includes are loaded as their directives are reached, with the macros seen so far
+    std::vector<Directive> directives;
+    preprocess::Output     expanded;
+    {
+        trace::Span span("preprocess_include", "parse");
+        if (span.active()) {
+            span.add_arg("file", path);
+        }
+        expanded = preprocess::run(
+            content, visit.macros, [&](const std::string &name, size_t line) {
+                directives.push_back({name, line});
+                include_file(name, line, path, visit);
+            });
+    }
+    for (auto &diagnostic : expanded.diagnostics) {
+        diagnostic.file = path;
+        visit.diagnostics.push_back(std::move(diagnostic));
+    }
+
+    uint64_t hash = content_hash(content);
+
+    std::promise<std::shared_ptr<const ParsedFile>> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto                         it = entries_.find(path);
+        if (it != entries_.end() && it->second.hash == hash) {
+            auto pending = it->second.file;
+            lock.unlock();
+            return pending.get(); // Waits if another thread is still parsing the file
+        }
+        entries_[path] = Entry{hash, promise.get_future().share()};
+        parse_count_++;
+    }
+
+    trace::Span span("parse_include", "parse");
+    if (span.active()) {
+        span.add_arg("file", path);
+        span.add_arg("bytes", std::to_string(content.size()));
+    }
+
+    auto parsed        = std::make_shared<ParsedFile>();
+    parsed->path       = path;
+    parsed->hash       = hash;
+    parsed->directives = std::move(directives);
+    parsed->storage_   = std::make_unique<ParsedFile::Storage>();
+
+    std::istringstream content_stream(content);
+
+    auto &storage    = *parsed->storage_;
+    storage.listener = std::make_unique<DiagnosticListener>(parsed->diagnostics);
+    storage.input    = std::make_unique<antlr4::ANTLRInputStream>(content_stream);
+    storage.lexer    = std::make_unique<SystemRDLLexer>(storage.input.get());
+    storage.tokens   = std::make_unique<antlr4::CommonTokenStream>(storage.lexer.get());
+    storage.parser   = std::make_unique<SystemRDLParser>(storage.tokens.get());
+
+    // Tokens name their file, so elaboration errors in it do too
+    storage.input->name = path;
+
+    storage.lexer->removeErrorListeners();
+    storage.lexer->addErrorListener(storage.listener.get());
+    storage.parser->removeErrorListeners();
+    storage.parser->addErrorListener(storage.listener.get());
+
+    parsed->root = storage.parser->root();
+    for (auto &diagnostic : parsed->diagnostics) {
+        diagnostic.file   = path;
+        diagnostic.column = expanded.line_map.source_column(diagnostic.line, diagnostic.column);
+    }
+
+    promise.set_value(parsed);
+    return parsed;
+}
+
+void ParseCache::include_file(
+    const std::string &name, size_t line, const std::string &includer, Visit &visit)
+{
+    std::string found = find_include(name, includer, visit.search_paths);
+    if (found.empty()) {
+        visit.diagnostics.push_back(
+            make_error(includer, line, "include", "Cannot find include file '" + name + "'"));
+        return;
+    }
+
+    std::string path = canonical_path(found);
+    if (std::find(visit.stack.begin(), visit.stack.end(), path) != visit.stack.end()) {
+        visit.diagnostics.push_back(make_error(
+            includer, line, "include-cycle", "Include cycle: '" + name + "' includes itself"));
+        return;
+    }
+    if (visit.done.count(path)) {
+        return;
+    }
+
+    // Depth-first, so every file is emitted after the files it includes
+    std::string error;
+    visit.stack.push_back(path);
+    auto parsed = load(path, visit, error);
+    visit.stack.pop_back();
+    if (!parsed) {
+        visit.diagnostics.push_back(make_error(includer, line, "io", error));
+        return;
+    }
+
+    visit.done.insert(path);
+    visit.diagnostics.insert(
+        visit.diagnostics.end(), parsed->diagnostics.begin(), parsed->diagnostics.end());
+    visit.ordered.push_back(std::move(parsed));
+}
+
+std::vector<std::shared_ptr<const ParsedFile>> ParseCache::resolve(
+    const std::vector<Directive>   &directives,
+    const std::string              &from,
+    const std::vector<std::string> &search_paths,
+    std::vector<Diagnostic>        &diagnostics,
+    preprocess::MacroTable         *macros)
+{
+    preprocess::MacroTable no_macros;
+    Visit visit{search_paths, macros ? *macros : no_macros, diagnostics, {}, {}, {}};
+    if (!from.empty()) {
+        visit.stack.push_back(canonical_path(from));
+    }
+    for (const auto &directive : directives) {
+        include_file(directive.path, directive.line, from, visit);
+    }
+    return std::move(visit.ordered);
+}
+
+std::vector<std::shared_ptr<const ParsedFile>> ParseCache::preprocess_buffer(
+    std::string                    &content,
+    const std::string              &from,
+    const std::vector<std::string> &search_paths,
+    preprocess::MacroTable         &macros,
+    std::vector<Diagnostic>        &diagnostics,
+    preprocess::LineMap            *line_map)
+{
+    trace::Span span("preprocess", "parse");
+
+    Visit visit{search_paths, macros, diagnostics, {}, {}, {}};
+    if (!from.empty()) {
+        visit.stack.push_back(canonical_path(from));
+    }
+    auto expanded = preprocess::run(content, macros, [&](const std::string &name, size_t line) {
+        include_file(name, line, from, visit);
+    });
+    for (auto &diagnostic : expanded.diagnostics) {
+        diagnostic.file = from;
+        diagnostics.push_back(std::move(diagnostic));
+    }
+    if (line_map) {
+        *line_map = std::move(expanded.line_map);
+    }
+    return std::move(visit.ordered);
+}
+
+void ParseCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+size_t ParseCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ParseCache::parse_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return parse_count_;
+}
+
+} // namespace include
+} // namespace systemrdl
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "SystemRDLParser.h"
+#include "systemrdl_api.h"
+#include "systemrdl_preprocessor.h"
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief `include handling with a shared per-file parse cache
+ *
+ * The grammar parses a single buffer, so included files are never expanded into
+ * the including text. Each buffer goes through preprocess::run(), which blanks
+ * its directives (keeping line and column numbers) and calls the include
+ * handler where each active `include appears; the included file is then
+ * preprocessed with the macros seen so far and parsed on its own. Parsed files
+ * are immutable and cached by canonical path and the hash of their
+ * preprocessed text, so a library included by many top-level files, or by
+ * parallel jobs, is lexed and parsed once per cache as long as it and the
+ * macros it sees are unchanged.
+ *
+ * @example
+ * ```cpp
+ * std::string                        content = read_file("soc.rdl");
+ * systemrdl::preprocess::MacroTable  macros;
+ * std::vector<systemrdl::Diagnostic> diagnostics;
+ * auto libraries = systemrdl::include::ParseCache::global().preprocess_buffer(
+ *     content, "soc.rdl", {"rdl/common"}, macros, diagnostics);
+ * ```
+ */
+namespace include {
+
+/**
+ * @brief One `include directive found in a source buffer
+ */
+struct Directive
+{
+    std::string path;
+    size_t      line = 0; // 1-based line of the directive
+};
+
+/**
+ * @brief FNV-1a hash of a file's content, used to detect edited files
+ */
+uint64_t content_hash(const std::string &content);
+
+/**
+ * @brief An included file after parsing; shared between all users of the cache
+ */
+struct ParsedFile
+{
+    ParsedFile();
+    ~ParsedFile();
+
+    ParsedFile(const ParsedFile &)            = delete;
+    ParsedFile &operator=(const ParsedFile &) = delete;
+
+    std::string path; // Canonical path
+    uint64_t    hash = 0; // Of the preprocessed text
+
+    // `include directives of this file; resolved again on every lookup, so an
+    // edited nested file is picked up even when this one is unchanged
+    std::vector<Directive> directives;
+
+    SystemRDLParser::RootContext *root = nullptr;
+
+    // Syntax errors, with file set to path and columns of the source
+    std::vector<Diagnostic> diagnostics;
+
+    bool has_errors() const { return !diagnostics.empty(); }
+
+private:
+    friend class ParseCache;
+
+    struct Storage;
+    std::unique_ptr<Storage> storage_; // Input stream, lexer, token stream and parser
+};
+
+/**
+ * @brief Thread-safe cache of parsed include files
+ *
+ * Concurrent requests for the same file wait for a single parse. An entry is
+ * reused while the file's content hash is unchanged; an edited file is parsed
+ * again and replaces the old entry (holders of the old one keep it alive).
+ */
+class ParseCache
+{
+public:
+    // Process-wide cache used by the API and command line tools
+    static ParseCache &global();
+
+    /**
+     * @brief Resolve and parse the given directives, recursively
+     *
+     * A relative path is looked up next to the including file first, then in
+     * each of search_paths. Errors (missing files, include cycles, syntax
+     * errors in included files) are appended to diagnostics.
+     *
+     * @param from File containing the directives, empty for an in-memory buffer
+     * @param macros Macros defined before the first directive (e.g. -D defines); receives
+     *        the macros the files define. Without it, files start with no macros.
+     * @return Included files in elaboration order: every file after the files it
+     *         includes, each file once
+     */
+    std::vector<std::shared_ptr<const ParsedFile>> resolve(
+        const std::vector<Directive>   &directives,
+        const std::string              &from,
+        const std::vector<std::string> &search_paths,
+        std::vector<Diagnostic>        &diagnostics,
+        preprocess::MacroTable         *macros = nullptr);
+
+    /**
+     * @brief Preprocess a top-level buffer in place and parse the files it includes
+     *
+     * Each included file is loaded where its directive appears and preprocessed
+     * with the macros defined up to that point; the macros it defines apply to
+     * the rest of the buffer. Preprocessor errors of the buffer itself get file
+     * set to from.
+     *
+     * @param line_map Receives the column map of the buffer's macro expansions
+     * @return Included files in elaboration order, as for resolve()
+     */
+    std::vector<std::shared_ptr<const ParsedFile>> preprocess_buffer(
+        std::string                    &content,
+        const std::string              &from,
+        const std::vector<std::string> &search_paths,
+        preprocess::MacroTable         &macros,
+        std::vector<Diagnostic>        &diagnostics,
+        preprocess::LineMap            *line_map = nullptr);
+
+    // Drop all entries; files still in use stay alive until released
+    void clear();
+
+    size_t size() const;
+
+    // Number of files actually lexed and parsed (cache misses)
+    size_t parse_count() const;
+
+private:
+    struct Entry
+    {
+        uint64_t                                              hash = 0;
+        std::shared_future<std::shared_ptr<const ParsedFile>> file;
+    };
+
+    // State of one resolve() or preprocess_buffer() call
+    struct Visit
+    {
+        const std::vector<std::string>                &search_paths;
+        preprocess::MacroTable                        &macros;
+        std::vector<Diagnostic>                       &diagnostics;
+        std::vector<std::shared_ptr<const ParsedFile>> ordered;
+        std::set<std::string>                          done;
+        std::vector<std::string>                       stack; // Files being preprocessed
+    };
+
+    void include_file(
+        const std::string &name, size_t line, const std::string &includer, Visit &visit);
+
+    // Preprocess and parse a file (canonical path), or return the cached parse of the same text
+    std::shared_ptr<const ParsedFile> load(
+        const std::string &path, Visit &visit, std::string &error);
+
+    mutable std::mutex           mutex_;
+    std::map<std::string, Entry> entries_; // By canonical path
+    size_t                       parse_count_ = 0;
+};
+
+} // namespace include
+
+} // namespace systemrdl
@@ -0,0 +1,354 @@
+#include "systemrdl_index.h"
+
+#include "systemrdl_include.h"
+#include "systemrdl_preprocessor.h"
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace systemrdl {
+
+namespace {
+
+const std::string INDEX_HEADER = "SystemRDL definition index ";
+
+bool is_ident_start(char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_ident(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Root-level definitions of preprocessed text: a definition keyword and a name outside braces
+void scan_definitions(
+    const std::string &text, const std::string &file, std::vector<DefinitionIndex::Entry> &found)
+{
+    static const std::set<std::string> kinds = {
+        "addrmap", "regfile", "reg", "field", "mem", "signal", "enum", "struct"};
+
+    size_t      depth = 0;
+    size_t      line  = 1;
+    std::string kind; // Keyword waiting for its name
+    size_t      kind_line = 0;
+
+    for (size_t i = 0; i < text.size();) {
+        char c = text[i];
+        if (c == '\n') {
+            line++;
+            i++;
+        } else if (c == '/' && i + 1 < text.size() && text[i + 1] == '/') {
+            i = std::min(text.size(), text.find('\n', i));
+        } else if (c == '/' && i + 1 < text.size() && text[i + 1] == '*') {
+            size_t end = text.find("*/", i + 2);
+            end        = end == std::string::npos ? text.size() : end + 2;
+            line += std::count(text.begin() + i, text.begin() + end, '\n');
+            i = end;
+        } else if (c == '"') {
+            size_t end = i + 1;
+            while (end < text.size() && text[end] != '"') {
+                end += (text[end] == '\\') ? 2 : 1;
+            }
+            end = std::min(text.size(), end + 1);
+            line += std::count(text.begin() + i, text.begin() + end, '\n');
+            i = end;
+        } else if (is_ident_start(c)) {
+            size_t end = i;
+            while (end < text.size() && is_ident(text[end])) {
+                end++;
+            }
+            std::string word = text.substr(i, end - i);
+            if (depth == 0 && !kind.empty()) {
+                found.push_back({kind, word, file, kind_line});
+                kind.clear();
+            } else if (depth == 0 && kinds.count(word)) {
+                kind      = word;
+                kind_line = line;
+            }
+            i = end;
+        } else {
+            if (c == '{') {
+                depth++;
+                kind.clear(); // Anonymous definition
+            } else if (c == '}' && depth > 0) {
+                depth--;
+            } else if (c == ';') {
+                kind.clear();
+            }
+            i++;
+        }
+    }
+}
+
+// Names of the root-level definitions of a parsed file
+std::vector<std::string> root_definition_names(SystemRDLParser::RootContext *root)
+{
+    std::vector<std::string> names;
+    for (auto root_elem : root->root_elem()) {
+        if (auto comp_def = root_elem->component_def()) {
+            if (auto named_def = comp_def->component_named_def()) {
+                names.push_back(named_def->ID()->getText());
+            }
+        } else if (auto enum_def = root_elem->enum_def()) {
+            names.push_back(enum_def->ID()->getText());
+        } else if (auto struct_def = root_elem->struct_def()) {
+            if (!struct_def->ID().empty()) {
+                names.push_back(struct_def->ID(0)->getText());
+            }
+        }
+    }
+    return names;
+}
+
+std::string absolute_path(const fs::path &path)
+{
+    std::error_code ec;
+    fs::path        canonical = fs::weakly_canonical(fs::absolute(path, ec), ec);
+    return ec ? path.string() : canonical.string();
+}
+
+} // namespace
+
+DefinitionIndex::DefinitionIndex()  = default;
+DefinitionIndex::~DefinitionIndex() = default;
+
+void DefinitionIndex::add(Entry entry, std::vector<Diagnostic> *diagnostics)
+{
+    auto it = index_.find(entry.name);
+    if (it != index_.end()) {
+        if (diagnostics) {
+            const Entry &first = entries_[it->second];
+            Diagnostic   diagnostic;
+            diagnostic.severity = Diagnostic::Severity::Warning;
+            diagnostic.file     = entry.file;
+            diagnostic.line     = entry.line;
+            diagnostic.code     = "duplicate-definition";
+            diagnostic.message  = "'" + entry.name + "' is already defined in " + first.file
+                                 + ":" + std::to_string(first.line) + "; this one is not indexed";
+            diagnostics->push_back(std::move(diagnostic));
+        }
+        return;
+    }
+    index_[entry.name] = entries_.size();
+    entries_.push_back(std::move(entry));
+}
+
+std::shared_ptr<DefinitionIndex> DefinitionIndex::build(
+    const std::vector<std::string>           &paths,
+    std::vector<Diagnostic>                  &diagnostics,
+    const std::map<std::string, std::string> &defines)
+{
+    trace::Span span("build_index", "library");
+
+    std::vector<std::string> files;
+    for (const auto &path : paths) {
+        std::error_code ec;
+        if (fs::is_directory(path, ec)) {
+            for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end;
+                 it.increment(ec)) {
+                if (it->is_regular_file(ec) && it->path().extension() == ".rdl") {
+                    files.push_back(absolute_path(it->path()));
+                }
+            }
+            if (ec) {
+                Diagnostic diagnostic;
+                diagnostic.severity = Diagnostic::Severity::Error;
+                diagnostic.file     = path;
+                diagnostic.code     = "io";
+                diagnostic.message  = "Cannot read directory " + path + ": " + ec.message();
+                diagnostics.push_back(std::move(diagnostic));
+            }
+        } else {
+            files.push_back(absolute_path(path));
+        }
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    auto index      = std::make_shared<DefinitionIndex>();
+    index->defines_ = defines;
+    for (const auto &file : files) {
+        std::ifstream input(file);
+        if (!input.is_open()) {
+            Diagnostic diagnostic;
+            diagnostic.severity = Diagnostic::Severity::Error;
+            diagnostic.file     = file;
+            diagnostic.code     = "io";
+            diagnostic.message  = "Cannot open file: " + file;
+            diagnostics.push_back(std::move(diagnostic));
+            continue;
+        }
+        std::string content(
+            (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+        // Directives and inactive `ifdef branches must not look like definitions
+        preprocess::MacroTable macros;
+        for (const auto &define : defines) {
+            macros.define(define.first, define.second);
+        }
+        preprocess::run(content, macros);
+
+        std::vector<Entry> found;
+        scan_definitions(content, file, found);
+        for (auto &entry : found) {
+            index->add(std::move(entry), &diagnostics);
+        }
+    }
+
+    if (span.active()) {
+        span.add_arg("files", std::to_string(files.size()));
+        span.add_arg("definitions", std::to_string(index->entries_.size()));
+    }
+    return index;
+}
+
+std::shared_ptr<DefinitionIndex> DefinitionIndex::load(const std::string &path, std::string *error)
+{
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        if (error) {
+            *error = "Cannot open index file: " + path;
+        }
+        return nullptr;
+    }
+
+    std::string header;
+    std::getline(input, header);
+    if (header.compare(0, INDEX_HEADER.size(), INDEX_HEADER) != 0) {
+        if (error) {
+            *error = path + ": not a SystemRDL definition index";
+        }
+        return nullptr;
+    }
+    std::string version = header.substr(INDEX_HEADER.size());
+    if (version != std::to_string(FORMAT_VERSION)) {
+        if (error) {
+            *error = path + ": unsupported index format version " + version + " (expected "
+                     + std::to_string(FORMAT_VERSION) + ")";
+        }
+        return nullptr;
+    }
+
+    auto        index = std::make_shared<DefinitionIndex>();
+    fs::path    base  = fs::path(absolute_path(path)).parent_path();
+    std::string line;
+    size_t      line_number = 1;
+    while (std::getline(input, line)) {
+        line_number++;
+        if (line.empty()) {
+            continue;
+        }
+
+        // kind, name, line and file separated by tabs; the file may contain anything else
+        Entry              entry;
+        std::string        source_line;
+        std::istringstream fields(line);
+        std::getline(fields, entry.kind, '\t');
+        std::getline(fields, entry.name, '\t');
+        std::getline(fields, source_line, '\t');
+        std::getline(fields, entry.file);
+        if (entry.name.empty() || entry.file.empty()) {
+            if (error) {
+                *error = path + ":" + std::to_string(line_number) + ": malformed entry";
+            }
+            return nullptr;
+        }
+        entry.line = std::strtoul(source_line.c_str(), nullptr, 10);
+        entry.file = absolute_path(base / entry.file);
+        index->add(std::move(entry), nullptr);
+    }
+    return index;
+}
+
+bool DefinitionIndex::save(const std::string &path, std::string *error) const
+{
+    std::ofstream output(path);
+    if (!output.is_open()) {
+        if (error) {
+            *error = "Cannot write index file: " + path;
+        }
+        return false;
+    }
+
+    fs::path base = fs::path(absolute_path(path)).parent_path();
+    output << INDEX_HEADER << FORMAT_VERSION << "\n";
+    for (const auto &entry : entries_) {
+        fs::path file = fs::path(entry.file).lexically_relative(base);
+        output << entry.kind << '\t' << entry.name << '\t' << entry.line << '\t'
+               << (file.empty() ? entry.file : file.generic_string()) << "\n";
+    }
+    return static_cast<bool>(output);
+}
+
+const DefinitionIndex::Entry *DefinitionIndex::find(const std::string &name) const
+{
+    auto it = index_.find(name);
+    return it != index_.end() ? &entries_[it->second] : nullptr;
+}
+
+size_t DefinitionIndex::parsed_file_count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::count_if(files_.begin(), files_.end(), [](const auto &file) {
+        return file.second != nullptr;
+    });
+}
+
+std::vector<Diagnostic> DefinitionIndex::parse_errors() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return parse_errors_;
+}
+
+SystemRDLParser::RootContext *DefinitionIndex::find_definition(const std::string &name) const
+{
+    const Entry                *entry = find(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entry) {
+        // Definitions of files included by a parsed indexed file are not in the index
+        auto included = included_.find(name);
+        return included != included_.end() ? included->second->root : nullptr;
+    }
+
+    auto it = files_.find(entry->file);
+    if (it == files_.end()) {
+        trace::Span span("load_indexed_file", "library");
+        if (span.active()) {
+            span.add_arg("file", entry->file);
+            span.add_arg("definition", name);
+        }
+
+        preprocess::MacroTable macros;
+        for (const auto &define : defines_) {
+            macros.define(define.first, define.second);
+        }
+
+        // Parsed like an include, so files shared with the design are parsed once
+        std::vector<Diagnostic> diagnostics;
+        auto                    parsed = include::ParseCache::global().resolve(
+            {{entry->file, 0}}, "", include_paths_, diagnostics, &macros);
+
+        std::shared_ptr<const include::ParsedFile> file;
+        if (diagnostics.empty() && !parsed.empty()) {
+            file = parsed.back(); // After the files it includes
+            for (const auto &included : parsed) {
+                for (const auto &defined : root_definition_names(included->root)) {
+                    included_.emplace(defined, included);
+                }
+            }
+        }
+        parse_errors_.insert(parse_errors_.end(), diagnostics.begin(), diagnostics.end());
+        it = files_.emplace(entry->file, std::move(file)).first;
+    }
+    return it->second ? it->second->root : nullptr;
+}
+
+} // namespace systemrdl
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "elaborator.h"
+#include "systemrdl_api.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+namespace include {
+struct ParsedFile;
+}
+
+/**
+ * @brief Index of which file defines which named component, enum and struct
+ *
+ * Building the index only scans the text of each file for root-level
+ * definitions; nothing is parsed. During elaboration a name the design does
+ * not define is looked up in the index and only the file defining it is
+ * parsed (through the shared include::ParseCache), so a library of thousands
+ * of files costs one parse per file actually used. Names defined by the files
+ * an indexed file `includes are found once that file has been parsed.
+ *
+ * @example
+ * ```cpp
+ * std::vector<systemrdl::Diagnostic> diagnostics;
+ * auto index = systemrdl::DefinitionIndex::build({"rdl/corporate"}, diagnostics);
+ * index->save("corporate.rdlidx");
+ *
+ * systemrdl::SystemRDLElaborator::Options options;
+ * options.definition_libraries.push_back(systemrdl::DefinitionIndex::load("corporate.rdlidx"));
+ * ```
+ */
+class DefinitionIndex : public DefinitionProvider
+{
+public:
+    // Bumped whenever the file layout changes; other versions are rejected by load()
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct Entry
+    {
+        std::string kind; // addrmap, regfile, reg, field, mem, signal, enum or struct
+        std::string name;
+        std::string file; // Absolute path
+        size_t      line = 0;
+    };
+
+    DefinitionIndex();
+    ~DefinitionIndex() override;
+
+    DefinitionIndex(const DefinitionIndex &)            = delete;
+    DefinitionIndex &operator=(const DefinitionIndex &) = delete;
+
+    /**
+     * @brief Scan RDL files; directories are searched recursively for *.rdl files
+     *
+     * Files are scanned in sorted path order. When several files define the same
+     * name the first one is kept and a warning is added to diagnostics. The defines
+     * select the `ifdef branches that are scanned; they should be the ones the
+     * elaborations using the index predefine (see set_defines()).
+     */
+    static std::shared_ptr<DefinitionIndex> build(
+        const std::vector<std::string>           &paths,
+        std::vector<Diagnostic>                  &diagnostics,
+        const std::map<std::string, std::string> &defines = {});
+
+    // File paths are stored relative to the index file and resolved again on load
+    static std::shared_ptr<DefinitionIndex> load(
+        const std::string &path, std::string *error = nullptr);
+
+    bool save(const std::string &path, std::string *error = nullptr) const;
+
+    // Search paths for the `include directives of indexed files
+    void set_include_paths(std::vector<std::string> paths) { include_paths_ = std::move(paths); }
+
+    // Macros predefined in every indexed file, as if by `define NAME value (e.g. -D defines)
+    void set_defines(std::map<std::string, std::string> defines) { defines_ = std::move(defines); }
+
+    const std::vector<Entry> &entries() const { return entries_; }
+
+    const Entry *find(const std::string &name) const;
+
+    // Indexed files parsed so far, and the errors found parsing them
+    size_t                  parsed_file_count() const;
+    std::vector<Diagnostic> parse_errors() const;
+
+    SystemRDLParser::RootContext *find_definition(const std::string &name) const override;
+
+private:
+    void add(Entry entry, std::vector<Diagnostic> *diagnostics);
+
+    std::vector<Entry>                      entries_;
+    std::unordered_map<std::string, size_t> index_; // Name -> entries_ index
+    std::vector<std::string>                include_paths_;
+    std::map<std::string, std::string>      defines_;
+
+    // Parsed indexed files by path, nullptr for a file that failed to parse
+    mutable std::mutex                                                        mutex_;
+    mutable std::map<std::string, std::shared_ptr<const include::ParsedFile>> files_;
+    mutable std::vector<Diagnostic>                                           parse_errors_;
+
+    // Root-level definitions of parsed indexed files and the files they include, by name
+    mutable std::unordered_map<std::string, std::shared_ptr<const include::ParsedFile>>
+        included_;
+};
+
+} // namespace systemrdl
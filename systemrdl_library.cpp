@@ -0,0 +1,433 @@
+#include "systemrdl_library.h"
+
+#include "SystemRDLLexer.h"
+#include "antlr4-runtime.h"
+#include "systemrdl_include.h"
+#include "systemrdl_trace.h"
+#include "systemrdl_version.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace systemrdl {
+
+namespace {
+
+const char LIBRARY_MAGIC[8] = {'S', 'R', 'D', 'L', 'L', 'I', 'B', '\0'};
+
+// Little-endian encoder for the library file
+class Writer
+{
+public:
+    void u32(uint32_t value)
+    {
+        for (int i = 0; i < 4; i++) {
+            buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void u64(uint64_t value)
+    {
+        for (int i = 0; i < 8; i++) {
+            buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void str(const std::string &value)
+    {
+        u32(static_cast<uint32_t>(value.size()));
+        buffer_ += value;
+    }
+
+    void raw(const char *data, size_t size) { buffer_.append(data, size); }
+
+    const std::string &data() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+// Bounds-checked decoder; throws std::runtime_error on truncated input
+class Reader
+{
+public:
+    explicit Reader(const std::string &data)
+        : data_(data)
+    {}
+
+    uint32_t u32()
+    {
+        need(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data_[pos_++])) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t u64()
+    {
+        need(8);
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_++])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string str()
+    {
+        uint32_t size = u32();
+        need(size);
+        std::string value = data_.substr(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    bool bytes_equal(const char *expected, size_t size)
+    {
+        need(size);
+        bool equal = std::memcmp(data_.data() + pos_, expected, size) == 0;
+        pos_ += size;
+        return equal;
+    }
+
+private:
+    void need(size_t size) const
+    {
+        if (size > data_.size() - pos_) {
+            throw std::runtime_error("truncated library file");
+        }
+    }
+
+    const std::string &data_;
+    size_t             pos_ = 0;
+};
+
+// Source text of a rule, including the whitespace and comments between its tokens
+std::string source_text(antlr4::ParserRuleContext *ctx)
+{
+    if (!ctx || !ctx->getStart() || !ctx->getStop()) {
+        return "";
+    }
+    size_t start = ctx->getStart()->getStartIndex();
+    size_t stop  = ctx->getStop()->getStopIndex();
+    if (stop < start) {
+        return "";
+    }
+    return ctx->getStart()->getInputStream()->getText(antlr4::misc::Interval(start, stop));
+}
+
+// Names of the definitions nested in a component body, recursively
+void collect_nested_names(
+    SystemRDLParser::Component_bodyContext *body, std::vector<std::string> &names)
+{
+    for (auto body_elem : body->component_body_elem()) {
+        if (auto comp_def = body_elem->component_def()) {
+            if (auto named_def = comp_def->component_named_def()) {
+                names.push_back(named_def->ID()->getText());
+                if (auto nested_body = named_def->component_body()) {
+                    collect_nested_names(nested_body, names);
+                }
+            } else if (auto anon_def = comp_def->component_anon_def()) {
+                if (auto nested_body = anon_def->component_body()) {
+                    collect_nested_names(nested_body, names);
+                }
+            }
+        } else if (auto enum_def = body_elem->enum_def()) {
+            names.push_back(enum_def->ID()->getText());
+        } else if (auto struct_def = body_elem->struct_def()) {
+            if (!struct_def->ID().empty()) {
+                names.push_back(struct_def->ID(0)->getText());
+            }
+        }
+    }
+}
+
+// Silently counts syntax errors while a stored definition is parsed
+class CountingErrorListener : public antlr4::BaseErrorListener
+{
+public:
+    void syntaxError(
+        antlr4::Recognizer * /*recognizer*/,
+        antlr4::Token * /*offendingSymbol*/,
+        size_t /*line*/,
+        size_t /*column*/,
+        const std::string & /*msg*/,
+        std::exception_ptr /*e*/) override
+    {
+        errors++;
+    }
+
+    size_t errors = 0;
+};
+
+} // namespace
+
+struct ComponentLibrary::ParsedDefinition
+{
+    std::once_flag                             once;
+    CountingErrorListener                      listener;
+    std::unique_ptr<antlr4::ANTLRInputStream>  input;
+    std::unique_ptr<SystemRDLLexer>            lexer;
+    std::unique_ptr<antlr4::CommonTokenStream> tokens;
+    std::unique_ptr<SystemRDLParser>           parser;
+    SystemRDLParser::RootContext              *root = nullptr;
+};
+
+ComponentLibrary::ComponentLibrary()  = default;
+ComponentLibrary::~ComponentLibrary() = default;
+
+void ComponentLibrary::add(Definition definition)
+{
+    size_t index            = definitions_.size();
+    index_[definition.name] = index;
+    for (const auto &nested : definition.nested) {
+        index_[nested] = index;
+    }
+    source_hash_ = (source_hash_ ^ include::content_hash(definition.source)) * 1099511628211ull;
+    definitions_.push_back(std::move(definition));
+}
+
+std::shared_ptr<ComponentLibrary> ComponentLibrary::compile(
+    const std::string                        &rdl_file,
+    const std::vector<std::string>           &include_paths,
+    std::vector<Diagnostic>                  &diagnostics,
+    const std::map<std::string, std::string> &defines)
+{
+    trace::Span span("compile_library", "library");
+
+    preprocess::MacroTable macros;
+    for (const auto &define : defines) {
+        macros.define(define.first, define.second);
+    }
+
+    // The file itself is resolved like an include, so it is parsed with the same cache
+    const size_t errors_before = diagnostics.size();
+    auto         files         = include::ParseCache::global().resolve(
+        {{rdl_file, 0}}, "", include_paths, diagnostics, &macros);
+    if (diagnostics.size() != errors_before || files.empty()) {
+        return nullptr;
+    }
+
+    auto library = std::make_shared<ComponentLibrary>();
+    for (const auto &file : files) {
+        for (auto root_elem : file->root->root_elem()) {
+            Definition definition;
+            definition.file = file->path;
+
+            antlr4::ParserRuleContext *ctx = nullptr;
+            if (auto comp_def = root_elem->component_def()) {
+                auto named_def = comp_def->component_named_def();
+                if (!named_def) {
+                    continue; // Anonymous definitions are instances, not library content
+                }
+                ctx             = named_def;
+                definition.kind = named_def->component_type()->getText();
+                definition.name = named_def->ID()->getText();
+                if (auto param_def = named_def->param_def()) {
+                    for (auto elem : param_def->param_def_elem()) {
+                        Parameter parameter;
+                        parameter.name = elem->ID()->getText();
+                        parameter.type = source_text(elem->data_type());
+                        if (elem->array_type_suffix()) {
+                            parameter.type += "[]";
+                        }
+                        parameter.default_value = source_text(elem->expr());
+                        definition.parameters.push_back(std::move(parameter));
+                    }
+                }
+                if (auto body = named_def->component_body()) {
+                    collect_nested_names(body, definition.nested);
+                }
+            } else if (auto enum_def = root_elem->enum_def()) {
+                ctx             = enum_def;
+                definition.kind = "enum";
+                definition.name = enum_def->ID()->getText();
+            } else if (auto struct_def = root_elem->struct_def()) {
+                if (struct_def->ID().empty()) {
+                    continue;
+                }
+                ctx             = struct_def;
+                definition.kind = "struct";
+                definition.name = struct_def->ID(0)->getText();
+            } else {
+                continue; // Root-level instances and property assignments are not kept
+            }
+
+            definition.line   = ctx->getStart()->getLine();
+            definition.column = ctx->getStart()->getCharPositionInLine();
+            definition.source = source_text(ctx);
+            library->add(std::move(definition));
+        }
+    }
+    return library;
+}
+
+bool ComponentLibrary::save(const std::string &path, std::string *error) const
+{
+    Writer writer;
+    writer.raw(LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC));
+    writer.u32(FORMAT_VERSION);
+    writer.str(get_version());
+    writer.u64(source_hash_);
+    writer.u32(static_cast<uint32_t>(definitions_.size()));
+    for (const auto &definition : definitions_) {
+        writer.str(definition.kind);
+        writer.str(definition.name);
+        writer.str(definition.file);
+        writer.u32(static_cast<uint32_t>(definition.line));
+        writer.u32(static_cast<uint32_t>(definition.column));
+        writer.u32(static_cast<uint32_t>(definition.parameters.size()));
+        for (const auto &parameter : definition.parameters) {
+            writer.str(parameter.name);
+            writer.str(parameter.type);
+            writer.str(parameter.default_value);
+        }
+        writer.u32(static_cast<uint32_t>(definition.nested.size()));
+        for (const auto &nested : definition.nested) {
+            writer.str(nested);
+        }
+        writer.str(definition.source);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot write library file: " + path;
+        }
+        return false;
+    }
+    file.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+    return static_cast<bool>(file);
+}
+
+std::shared_ptr<ComponentLibrary> ComponentLibrary::load(
+    const std::string &path, std::string *error)
+{
+    trace::Span span("load_library", "library");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot open library file: " + path;
+        }
+        return nullptr;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    auto library = std::make_shared<ComponentLibrary>();
+    try {
+        Reader reader(data);
+        if (!reader.bytes_equal(LIBRARY_MAGIC, sizeof(LIBRARY_MAGIC))) {
+            throw std::runtime_error("not a SystemRDL component library");
+        }
+        uint32_t version = reader.u32();
+        if (version != FORMAT_VERSION) {
+            throw std::runtime_error(
+                "unsupported library format version " + std::to_string(version) + " (expected "
+                + std::to_string(FORMAT_VERSION) + ")");
+        }
+        reader.str(); // Toolkit version that wrote the file, informational only
+        uint64_t stored_hash = reader.u64();
+
+        uint32_t count = reader.u32();
+        for (uint32_t i = 0; i < count; i++) {
+            Definition definition;
+            definition.kind   = reader.str();
+            definition.name   = reader.str();
+            definition.file   = reader.str();
+            definition.line   = reader.u32();
+            definition.column = reader.u32();
+
+            uint32_t parameters = reader.u32();
+            for (uint32_t p = 0; p < parameters; p++) {
+                Parameter parameter;
+                parameter.name          = reader.str();
+                parameter.type          = reader.str();
+                parameter.default_value = reader.str();
+                definition.parameters.push_back(std::move(parameter));
+            }
+            uint32_t nested = reader.u32();
+            for (uint32_t n = 0; n < nested; n++) {
+                definition.nested.push_back(reader.str());
+            }
+            definition.source = reader.str();
+            library->add(std::move(definition));
+        }
+
+        if (library->source_hash_ != stored_hash) {
+            throw std::runtime_error("corrupt library file (hash mismatch)");
+        }
+    } catch (const std::exception &e) {
+        if (error) {
+            *error = path + ": " + e.what();
+        }
+        return nullptr;
+    }
+    return library;
+}
+
+const ComponentLibrary::Definition *ComponentLibrary::find(const std::string &name) const
+{
+    auto it = index_.find(name);
+    return it != index_.end() ? &definitions_[it->second] : nullptr;
+}
+
+size_t ComponentLibrary::parsed_count() const
+{
+    return parsed_count_.load();
+}
+
+SystemRDLParser::RootContext *ComponentLibrary::find_definition(const std::string &name) const
+{
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+
+    ParsedDefinition *entry = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto                       &parsed = parsed_[it->second];
+        if (!parsed) {
+            parsed = std::make_unique<ParsedDefinition>();
+        }
+        entry = parsed.get();
+    }
+
+    // Lookups of the same definition wait here for the first one; others go on in parallel
+    std::call_once(entry->once, [&] {
+        const Definition &definition = definitions_[it->second];
+        trace::Span       span("parse_library_definition", "parse");
+        if (span.active()) {
+            span.add_arg("name", definition.name);
+        }
+
+        // Pad to the original position so diagnostics point into the library's source file
+        std::string text = std::string(definition.line > 0 ? definition.line - 1 : 0, '\n')
+                           + std::string(definition.column, ' ') + definition.source + ";";
+        std::istringstream stream(text);
+
+        entry->input  = std::make_unique<antlr4::ANTLRInputStream>(stream);
+        entry->lexer  = std::make_unique<SystemRDLLexer>(entry->input.get());
+        entry->tokens = std::make_unique<antlr4::CommonTokenStream>(entry->lexer.get());
+        entry->parser = std::make_unique<SystemRDLParser>(entry->tokens.get());
+        entry->lexer->removeErrorListeners();
+        entry->lexer->addErrorListener(&entry->listener);
+        entry->parser->removeErrorListeners();
+        entry->parser->addErrorListener(&entry->listener);
+        entry->input->name = definition.file; // Padded above, so errors point into this file
+        entry->root        = entry->parser->root();
+
+        // The source was valid when compiled; a damaged entry is treated as missing
+        if (entry->listener.errors > 0) {
+            entry->root = nullptr;
+        }
+        parsed_count_++;
+    });
+    return entry->root;
+}
+
+} // namespace systemrdl
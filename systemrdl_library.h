@@ -0,0 +1,120 @@
+#pragma once
+
+#include "elaborator.h"
+#include "systemrdl_api.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Precompiled component library (.rdlib) for separate compilation
+ *
+ * A library holds the top-level component, enum and struct definitions of an
+ * RDL file and of the files it includes, each with its parameter list, the
+ * names of its nested definitions and its source text. Loading a library only
+ * reads the index; a definition is parsed the first time an elaboration looks
+ * up one of its names, and the parse is shared by later elaborations.
+ *
+ * A library does not save parse cost. It stores source text, not parse trees,
+ * so every process that loads it lexes and parses each definition it uses, as
+ * if from source. It only saves reading and preprocessing the files, and
+ * parsing the definitions a design never uses. Definitions are parsed outside
+ * the library lock, so threads looking up different names parse in parallel.
+ *
+ * @example
+ * ```cpp
+ * std::vector<systemrdl::Diagnostic> diagnostics;
+ * auto library = systemrdl::ComponentLibrary::compile("ip_blocks.rdl", {}, diagnostics);
+ * library->save("ip_blocks.rdlib");
+ *
+ * systemrdl::ElaborateOptions options;
+ * options.libraries.push_back(systemrdl::ComponentLibrary::load("ip_blocks.rdlib"));
+ * auto result = systemrdl::file::elaborate("soc.rdl", options);
+ * ```
+ */
+class ComponentLibrary : public DefinitionProvider
+{
+public:
+    // Bumped whenever the file layout changes; other versions are rejected by load()
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct Parameter
+    {
+        std::string name;
+        std::string type;          // Data type as written, e.g. "longint unsigned"
+        std::string default_value; // Default expression as written, empty if none
+    };
+
+    struct Definition
+    {
+        std::string              kind; // addrmap, regfile, reg, field, mem, signal, enum or struct
+        std::string              name;
+        std::string              file; // Source file the definition was compiled from
+        size_t                   line   = 0;
+        size_t                   column = 0;
+        std::vector<Parameter>   parameters;
+        std::vector<std::string> nested; // Definitions inside the body, visible by name as well
+        std::string              source; // Definition text without the terminating ';'
+    };
+
+    ComponentLibrary();
+    ~ComponentLibrary() override;
+
+    ComponentLibrary(const ComponentLibrary &)            = delete;
+    ComponentLibrary &operator=(const ComponentLibrary &) = delete;
+
+    /**
+     * @brief Collect the definitions of an RDL file and the files it includes
+     *
+     * The files are preprocessed with defines predefined, as if by `define NAME value; the
+     * stored definitions are the expanded text, so the defines are fixed in the library.
+     *
+     * @return nullptr if the file or one of its includes has errors (see diagnostics)
+     */
+    static std::shared_ptr<ComponentLibrary> compile(
+        const std::string                        &rdl_file,
+        const std::vector<std::string>           &include_paths,
+        std::vector<Diagnostic>                  &diagnostics,
+        const std::map<std::string, std::string> &defines = {});
+
+    static std::shared_ptr<ComponentLibrary> load(
+        const std::string &path, std::string *error = nullptr);
+
+    bool save(const std::string &path, std::string *error = nullptr) const;
+
+    const std::vector<Definition> &definitions() const { return definitions_; }
+
+    // Definition by its own or a nested name; a later definition hides an earlier one
+    const Definition *find(const std::string &name) const;
+
+    // Hash of all definition sources, to tell whether a library is out of date
+    uint64_t source_hash() const { return source_hash_; }
+
+    // Definitions parsed so far
+    size_t parsed_count() const;
+
+    SystemRDLParser::RootContext *find_definition(const std::string &name) const override;
+
+private:
+    void add(Definition definition);
+
+    std::vector<Definition>                 definitions_;
+    std::unordered_map<std::string, size_t> index_; // Name -> definitions_ index
+    uint64_t                                source_hash_ = 0;
+
+    // Entries are created under mutex_ and parsed once, outside of it
+    struct ParsedDefinition;
+    mutable std::mutex                                                    mutex_;
+    mutable std::unordered_map<size_t, std::unique_ptr<ParsedDefinition>> parsed_;
+    mutable std::atomic<size_t>                                           parsed_count_{0};
+};
+
+} // namespace systemrdl
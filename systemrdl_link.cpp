@@ -0,0 +1,623 @@
+#include "systemrdl_link.h"
+
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace systemrdl {
+namespace link {
+
+namespace {
+
+const char MODEL_MAGIC[8] = {'S', 'R', 'D', 'L', 'M', 'D', 'L', '\0'};
+
+enum NodeKind : uint8_t { ADDRMAP = 0, REGFILE = 1, REG = 2, FIELD = 3, MEM = 4 };
+
+class Encoder
+{
+public:
+    void byte(uint8_t value) { body_ += static_cast<char>(value); }
+
+    void varint(uint64_t value)
+    {
+        while (value >= 0x80) {
+            body_ += static_cast<char>((value & 0x7f) | 0x80);
+            value >>= 7;
+        }
+        body_ += static_cast<char>(value);
+    }
+
+    void svarint(int64_t value)
+    {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    // Strings are written as an index into the string table
+    void string(const std::string &value)
+    {
+        auto it = index_.find(value);
+        if (it == index_.end()) {
+            it = index_.emplace(value, strings_.size()).first;
+            strings_.push_back(&it->first);
+        }
+        varint(it->second);
+    }
+
+    void sizes(const std::vector<size_t> &values)
+    {
+        varint(values.size());
+        for (size_t value : values) {
+            varint(value);
+        }
+    }
+
+    // Header, string table and body
+    std::string finish(const std::string &name, Size extent)
+    {
+        Encoder header;
+        header.body_.append(MODEL_MAGIC, sizeof(MODEL_MAGIC));
+        header.varint(MODEL_FORMAT_VERSION);
+        header.raw_string(name);
+        header.varint(extent);
+        header.varint(strings_.size());
+        for (const auto *value : strings_) {
+            header.raw_string(*value);
+        }
+        return header.body_ + body_;
+    }
+
+private:
+    void raw_string(const std::string &value)
+    {
+        varint(value.size());
+        body_ += value;
+    }
+
+    std::string                          body_;
+    std::map<std::string, size_t>        index_;
+    std::vector<const std::string *>     strings_;
+};
+
+class Decoder
+{
+public:
+    explicit Decoder(const std::string &data)
+        : data_(data)
+    {}
+
+    uint8_t byte()
+    {
+        need(1);
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint64_t varint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            value |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("malformed integer");
+    }
+
+    int64_t svarint()
+    {
+        uint64_t value = varint();
+        return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+    std::string raw_string()
+    {
+        uint64_t size = varint();
+        need(size);
+        std::string value = data_.substr(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    const std::string &string()
+    {
+        uint64_t index = varint();
+        if (index >= strings_.size()) {
+            throw std::runtime_error("string index out of range");
+        }
+        return strings_[index];
+    }
+
+    std::vector<size_t> sizes()
+    {
+        std::vector<size_t> values(bounded(varint()));
+        for (auto &value : values) {
+            value = varint();
+        }
+        return values;
+    }
+
+    bool magic()
+    {
+        need(sizeof(MODEL_MAGIC));
+        bool ok = std::memcmp(data_.data() + pos_, MODEL_MAGIC, sizeof(MODEL_MAGIC)) == 0;
+        pos_ += sizeof(MODEL_MAGIC);
+        return ok;
+    }
+
+    // Guard element counts against corrupt input before allocating for them
+    size_t bounded(uint64_t count) const
+    {
+        if (count > data_.size() - pos_) {
+            throw std::runtime_error("element count out of range");
+        }
+        return static_cast<size_t>(count);
+    }
+
+    std::vector<std::string> strings_;
+
+private:
+    void need(uint64_t size) const
+    {
+        if (size > data_.size() - pos_) {
+            throw std::runtime_error("truncated model");
+        }
+    }
+
+    const std::string &data_;
+    size_t             pos_ = 0;
+};
+
+// Furthest byte used below the root, relative to the root address
+Size model_extent(const ElaboratedNode &node, Address base)
+{
+    Size extent = 0;
+    for (const auto &child : node.children) {
+        if (child->absolute_address >= base) {
+            extent = std::max(extent, child->absolute_address - base + child->size);
+        }
+        extent = std::max(extent, model_extent(*child, base));
+    }
+    return extent;
+}
+
+void encode_node(Encoder &out, const ElaboratedNode &node, Address base)
+{
+    uint8_t kind = ADDRMAP;
+    if (dynamic_cast<const ElaboratedRegfile *>(&node)) {
+        kind = REGFILE;
+    } else if (dynamic_cast<const ElaboratedReg *>(&node)) {
+        kind = REG;
+    } else if (dynamic_cast<const ElaboratedField *>(&node)) {
+        kind = FIELD;
+    } else if (dynamic_cast<const ElaboratedMem *>(&node)) {
+        kind = MEM;
+    }
+
+    out.byte(kind);
+    out.string(node.inst_name);
+    out.string(node.type_name);
+    out.varint(node.absolute_address - base);
+    out.varint(node.size);
+    out.sizes(node.array_dimensions);
+    out.sizes(std::vector<size_t>(node.array_strides.begin(), node.array_strides.end()));
+    out.sizes(node.array_indices);
+
+    // Sorted, so a model always encodes to the same bytes
+    std::vector<const std::pair<const std::string, PropertyValue> *> properties;
+    for (const auto &property : node.properties) {
+        properties.push_back(&property);
+    }
+    std::sort(properties.begin(), properties.end(), [](const auto *a, const auto *b) {
+        return a->first < b->first;
+    });
+    out.varint(properties.size());
+    for (const auto *property : properties) {
+        const PropertyValue &value = property->second;
+        out.string(property->first);
+        out.byte(static_cast<uint8_t>(value.type));
+        out.string(value.string_val);
+        out.svarint(value.int_val);
+        out.byte(value.bool_val ? 1 : 0);
+    }
+
+    if (auto regfile = dynamic_cast<const ElaboratedRegfile *>(&node)) {
+        out.varint(regfile->alignment);
+    } else if (auto reg = dynamic_cast<const ElaboratedReg *>(&node)) {
+        out.varint(reg->register_width);
+        out.string(reg->register_reset_hex);
+    } else if (auto field = dynamic_cast<const ElaboratedField *>(&node)) {
+        out.varint(field->msb);
+        out.varint(field->lsb);
+        out.varint(field->width);
+        out.varint(field->reset_value);
+        out.byte(static_cast<uint8_t>(field->sw_access));
+        out.byte(static_cast<uint8_t>(field->hw_access));
+    } else if (auto mem = dynamic_cast<const ElaboratedMem *>(&node)) {
+        out.varint(mem->memory_size);
+        out.varint(mem->data_width);
+        out.varint(mem->address_width);
+        out.string(mem->memory_type);
+    }
+
+    out.varint(node.children.size());
+    for (const auto &child : node.children) {
+        encode_node(out, *child, base);
+    }
+}
+
+std::unique_ptr<ElaboratedNode> decode_node(Decoder &in, Address base, size_t depth)
+{
+    if (depth > 1024) {
+        throw std::runtime_error("hierarchy too deep");
+    }
+
+    std::unique_ptr<ElaboratedNode> node;
+    uint8_t                         kind = in.byte();
+    switch (kind) {
+    case ADDRMAP:
+        node = std::make_unique<ElaboratedAddrmap>();
+        break;
+    case REGFILE:
+        node = std::make_unique<ElaboratedRegfile>();
+        break;
+    case REG:
+        node = std::make_unique<ElaboratedReg>();
+        break;
+    case FIELD:
+        node = std::make_unique<ElaboratedField>();
+        break;
+    case MEM:
+        node = std::make_unique<ElaboratedMem>();
+        break;
+    default:
+        throw std::runtime_error("unknown node kind " + std::to_string(kind));
+    }
+
+    node->inst_name        = in.string();
+    node->type_name        = in.string();
+    node->absolute_address = base + in.varint();
+    node->size             = in.varint();
+    node->array_dimensions = in.sizes();
+    auto strides           = in.sizes();
+    node->array_strides.assign(strides.begin(), strides.end());
+    node->array_indices = in.sizes();
+
+    size_t properties = in.bounded(in.varint());
+    for (size_t i = 0; i < properties; i++) {
+        std::string   key = in.string();
+        PropertyValue value;
+        uint8_t       type = in.byte();
+        if (type > PropertyValue::ENUM) {
+            throw std::runtime_error("unknown property type");
+        }
+        value.type       = static_cast<PropertyValue::Type>(type);
+        value.string_val = in.string();
+        value.int_val    = in.svarint();
+        value.bool_val   = in.byte() != 0;
+        node->properties.emplace(std::move(key), std::move(value));
+    }
+
+    if (auto regfile = dynamic_cast<ElaboratedRegfile *>(node.get())) {
+        regfile->alignment = in.varint();
+    } else if (auto reg = dynamic_cast<ElaboratedReg *>(node.get())) {
+        reg->register_width     = static_cast<uint32_t>(in.varint());
+        reg->register_reset_hex = in.string();
+    } else if (auto field = dynamic_cast<ElaboratedField *>(node.get())) {
+        field->msb         = in.varint();
+        field->lsb         = in.varint();
+        field->width       = in.varint();
+        field->reset_value = in.varint();
+        uint8_t sw         = in.byte();
+        uint8_t hw         = in.byte();
+        if (sw > ElaboratedField::NA || hw > ElaboratedField::NA) {
+            throw std::runtime_error("unknown access type");
+        }
+        field->sw_access = static_cast<ElaboratedField::AccessType>(sw);
+        field->hw_access = static_cast<ElaboratedField::AccessType>(hw);
+    } else if (auto mem = dynamic_cast<ElaboratedMem *>(node.get())) {
+        mem->memory_size   = in.varint();
+        mem->data_width    = in.varint();
+        mem->address_width = in.varint();
+        mem->memory_type   = in.string();
+    }
+
+    size_t children = in.bounded(in.varint());
+    node->children.reserve(children);
+    for (size_t i = 0; i < children; i++) {
+        node->add_child(decode_node(in, base, depth + 1));
+    }
+    return node;
+}
+
+struct Header
+{
+    std::string name;
+    Size        extent = 0;
+};
+
+// Decode a model with its root placed at base; throws std::runtime_error on bad input
+std::unique_ptr<ElaboratedAddrmap> decode_model(
+    const std::string &data, Address base, Header *header = nullptr)
+{
+    Decoder in(data);
+    if (!in.magic()) {
+        throw std::runtime_error("not a SystemRDL model file");
+    }
+    uint64_t version = in.varint();
+    if (version != MODEL_FORMAT_VERSION) {
+        throw std::runtime_error(
+            "unsupported model format version " + std::to_string(version) + " (expected "
+            + std::to_string(MODEL_FORMAT_VERSION) + ")");
+    }
+
+    Header info;
+    info.name   = in.raw_string();
+    info.extent = in.varint();
+
+    size_t strings = in.bounded(in.varint());
+    in.strings_.reserve(strings);
+    for (size_t i = 0; i < strings; i++) {
+        in.strings_.push_back(in.raw_string());
+    }
+    if (header) {
+        *header = info;
+    }
+
+    auto root = decode_node(in, base, 0);
+    if (!dynamic_cast<ElaboratedAddrmap *>(root.get())) {
+        throw std::runtime_error("model root is not an addrmap");
+    }
+    return std::unique_ptr<ElaboratedAddrmap>(static_cast<ElaboratedAddrmap *>(root.release()));
+}
+
+bool read_file(const std::string &path, std::string &data, std::string *error)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot open model file: " + path;
+        }
+        return false;
+    }
+    data.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+struct LeafRange
+{
+    Address               start;
+    Address               end; // Inclusive
+    const ElaboratedNode *node;
+};
+
+void collect_leaf_ranges(const ElaboratedNode &node, std::vector<LeafRange> &ranges)
+{
+    for (const auto &child : node.children) {
+        bool leaf = dynamic_cast<const ElaboratedReg *>(child.get())
+                    || dynamic_cast<const ElaboratedMem *>(child.get());
+        if (leaf) {
+            if (child->size > 0) {
+                ranges.push_back(
+                    {child->absolute_address,
+                     child->absolute_address + child->size - 1,
+                     child.get()});
+            }
+        } else {
+            collect_leaf_ranges(*child, ranges);
+        }
+    }
+}
+
+} // namespace
+
+std::string serialize_model(const ElaboratedAddrmap &root)
+{
+    trace::Span span("serialize_model", "link");
+
+    Encoder out;
+    encode_node(out, root, root.absolute_address);
+    return out.finish(root.inst_name, model_extent(root, root.absolute_address));
+}
+
+bool save_model(const ElaboratedAddrmap &root, const std::string &path, std::string *error)
+{
+    std::string   data = serialize_model(root);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot write model file: " + path;
+        }
+        return false;
+    }
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+std::unique_ptr<ElaboratedAddrmap> deserialize_model(const std::string &data, std::string *error)
+{
+    try {
+        return decode_model(data, 0);
+    } catch (const std::exception &e) {
+        if (error) {
+            *error = e.what();
+        }
+        return nullptr;
+    }
+}
+
+std::unique_ptr<ElaboratedAddrmap> load_model(const std::string &path, std::string *error)
+{
+    std::string data;
+    if (!read_file(path, data, error)) {
+        return nullptr;
+    }
+    auto model = deserialize_model(data, error);
+    if (!model && error) {
+        *error = path + ": " + *error;
+    }
+    return model;
+}
+
+bool Linker::add_model(std::string data, std::string *error)
+{
+    Header header;
+    try {
+        // Full decode once, so a corrupt model is rejected before it is placed anywhere
+        decode_model(data, 0, &header);
+    } catch (const std::exception &e) {
+        if (error) {
+            *error = e.what();
+        }
+        return false;
+    }
+
+    if (models_.count(header.name)) {
+        if (error) {
+            *error = "Duplicate model for addrmap '" + header.name + "'";
+        }
+        return false;
+    }
+    models_[header.name] = Model{std::move(data), header.extent};
+    return true;
+}
+
+bool Linker::add_model_file(const std::string &path, std::string *error)
+{
+    std::string data;
+    if (!read_file(path, data, error)) {
+        return false;
+    }
+    if (!add_model(std::move(data), error)) {
+        if (error) {
+            *error = path + ": " + *error;
+        }
+        return false;
+    }
+    return true;
+}
+
+std::unordered_map<std::string, Size> Linker::linked_blocks() const
+{
+    std::unordered_map<std::string, Size> blocks;
+    for (const auto &entry : models_) {
+        blocks[entry.first] = entry.second.size;
+    }
+    return blocks;
+}
+
+void Linker::add_error(const std::string &message, const ElaboratedNode *node, const char *code)
+{
+    SystemRDLElaborator::ElaborationError error;
+    error.message = message;
+    error.code    = code;
+    if (node && node->source_ctx && node->source_ctx->getStart()) {
+        error.line   = node->source_ctx->getStart()->getLine();
+        error.column = node->source_ctx->getStart()->getCharPositionInLine();
+    }
+    errors_.push_back(std::move(error));
+}
+
+void Linker::link_node(ElaboratedNode &node)
+{
+    auto linked = node.get_property("linked_block");
+    if (!linked) {
+        for (auto &child : node.children) {
+            link_node(*child);
+        }
+        return;
+    }
+
+    auto it = models_.find(linked->string_val);
+    if (it == models_.end()) {
+        add_error("No model for linked block '" + linked->string_val + "'", &node, "link");
+        return;
+    }
+
+    trace::Span span("link_block", "link");
+    if (span.active()) {
+        span.add_arg("path", node.get_hierarchical_path());
+    }
+
+    // The marker has done its job; the linked node carries the block's own properties
+    node.properties.erase("linked_block");
+    auto model = decode_model(it->second.data, node.absolute_address);
+    for (auto &property : model->properties) {
+        node.properties.emplace(property.first, std::move(property.second));
+    }
+    for (auto &child : model->children) {
+        node.add_child(std::move(child));
+    }
+    linked_count_++;
+}
+
+void Linker::check_global_overlaps(ElaboratedAddrmap &top)
+{
+    trace::Span span("check_global_overlaps", "link");
+
+    std::vector<LeafRange> ranges;
+    collect_leaf_ranges(top, ranges);
+    std::sort(ranges.begin(), ranges.end(), [](const LeafRange &a, const LeafRange &b) {
+        return a.start < b.start || (a.start == b.start && a.end < b.end);
+    });
+
+    // Sweep: compare each range with the one reaching furthest so far
+    const LeafRange *furthest = nullptr;
+    for (const auto &range : ranges) {
+        if (furthest && range.start <= furthest->end) {
+            std::ostringstream oss;
+            oss << "Address overlap after linking: '" << furthest->node->get_hierarchical_path()
+                << "' at 0x" << std::hex << std::uppercase << furthest->start << "-0x"
+                << furthest->end << " overlaps with '" << range.node->get_hierarchical_path()
+                << "' at 0x" << range.start << "-0x" << range.end;
+            add_error(oss.str(), range.node, "address-overlap");
+        }
+        if (!furthest || range.end > furthest->end) {
+            furthest = &range;
+        }
+    }
+}
+
+bool Linker::link(ElaboratedAddrmap &top, bool check_overlaps)
+{
+    trace::Span span("link", "link");
+
+    errors_.clear();
+    linked_count_ = 0;
+    try {
+        link_node(top);
+    } catch (const std::exception &e) {
+        add_error(std::string("Cannot link model: ") + e.what(), nullptr, "link");
+    }
+    if (check_overlaps) {
+        check_global_overlaps(top);
+    }
+    return errors_.empty();
+}
+
+std::unique_ptr<ElaboratedAddrmap> Linker::elaborate_and_link(
+    SystemRDLParser::RootContext *ast_root, SystemRDLElaborator::Options options)
+{
+    for (const auto &block : linked_blocks()) {
+        options.linked_blocks.emplace(block);
+    }
+
+    SystemRDLElaborator elaborator;
+    elaborator.set_options(options);
+    auto top = elaborator.elaborate(ast_root);
+    if (elaborator.has_errors() || !top) {
+        errors_ = elaborator.get_errors();
+        return nullptr;
+    }
+    if (!link(*top)) {
+        return nullptr;
+    }
+    return top;
+}
+
+} // namespace link
+} // namespace systemrdl
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "elaborator.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Linking of separately elaborated addrmaps
+ *
+ * Each IP addrmap is elaborated on its own, possibly on another machine, and
+ * saved as a compact model. The SoC's top-level RDL instantiates the IPs by
+ * definition name. The linker elaborates the top level with every IP as a
+ * placeholder of the saved size, copies each saved model into its
+ * placeholders at the instance's base address, and checks the registers and
+ * memories of the whole map for overlaps.
+ *
+ * @example
+ * ```cpp
+ * // Per IP, e.g. in parallel build jobs
+ * systemrdl::link::save_model(*dma_model, "dma_ip.rdlm");
+ *
+ * // SoC
+ * systemrdl::link::Linker linker;
+ * linker.add_model_file("dma_ip.rdlm");
+ * auto soc = linker.elaborate_and_link(soc_tree);
+ * ```
+ */
+namespace link {
+
+/**
+ * @brief Model format version; bumped whenever the encoding changes
+ */
+constexpr uint32_t MODEL_FORMAT_VERSION = 1;
+
+/**
+ * @brief Encode an elaborated addrmap and its subtree
+ *
+ * Names and property keys go through a string table and integers are LEB128
+ * encoded; addresses are stored relative to the root. Parse-tree references
+ * (source_ctx) are not kept.
+ */
+std::string serialize_model(const ElaboratedAddrmap &root);
+
+bool save_model(
+    const ElaboratedAddrmap &root, const std::string &path, std::string *error = nullptr);
+
+std::unique_ptr<ElaboratedAddrmap> deserialize_model(
+    const std::string &data, std::string *error = nullptr);
+
+std::unique_ptr<ElaboratedAddrmap> load_model(
+    const std::string &path, std::string *error = nullptr);
+
+/**
+ * @brief Places saved models into an elaborated top level
+ */
+class Linker
+{
+public:
+    // Register a serialized model under its root name; fails on malformed data or duplicates
+    bool add_model(std::string data, std::string *error = nullptr);
+    bool add_model_file(const std::string &path, std::string *error = nullptr);
+
+    // Name -> size of every registered model, for SystemRDLElaborator::Options::linked_blocks
+    std::unordered_map<std::string, Size> linked_blocks() const;
+
+    /**
+     * @brief Fill the linked-block placeholders of an elaborated top level
+     *
+     * Each placeholder receives the children and the properties (where the instance
+     * does not set them) of its model, relocated to the placeholder's address. Then,
+     * unless check_overlaps is false, all registers and memories are checked for
+     * overlaps across the whole map.
+     *
+     * @return false if errors were found (see get_errors())
+     */
+    bool link(ElaboratedAddrmap &top, bool check_overlaps = true);
+
+    /**
+     * @brief Elaborate a top-level RDL with the registered models as linked blocks and link it
+     * @return nullptr if elaboration or linking failed
+     */
+    std::unique_ptr<ElaboratedAddrmap> elaborate_and_link(
+        SystemRDLParser::RootContext *ast_root, SystemRDLElaborator::Options options = {});
+
+    const std::vector<SystemRDLElaborator::ElaborationError> &get_errors() const
+    {
+        return errors_;
+    }
+
+    // Placeholders filled by the last link()
+    size_t get_linked_count() const { return linked_count_; }
+
+private:
+    struct Model
+    {
+        std::string data; // Serialized model
+        Size        size = 0;
+    };
+
+    void link_node(ElaboratedNode &node);
+    void check_global_overlaps(ElaboratedAddrmap &top);
+    void add_error(const std::string &message, const ElaboratedNode *node, const char *code);
+
+    std::unordered_map<std::string, Model>             models_;
+    std::vector<SystemRDLElaborator::ElaborationError> errors_;
+    size_t                                             linked_count_ = 0;
+};
+
+} // namespace link
+
+} // namespace systemrdl
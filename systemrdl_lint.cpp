@@ -0,0 +1,552 @@
+#include "systemrdl_lint.h"
+
+#include "systemrdl_trace.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <future>
+#include <iterator>
+#include <regex>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace systemrdl {
+namespace lint {
+
+namespace {
+
+constexpr size_t KIND_COUNT = 5;
+
+using DispatchTable = std::array<std::vector<const LintRule *>, KIND_COUNT>;
+
+size_t kind_index(uint32_t kind)
+{
+    size_t index = 0;
+    while (kind > 1) {
+        kind >>= 1;
+        index++;
+    }
+    return index;
+}
+
+const PropertyValue *find_property(const ElaboratedNode &node, const char *name)
+{
+    auto it = node.properties.find(name);
+    return it != node.properties.end() ? &it->second : nullptr;
+}
+
+bool is_reserved_field(const ElaboratedField &field)
+{
+    const PropertyValue *reserved = find_property(field, "reserved");
+    if (reserved && reserved->type == PropertyValue::BOOLEAN && reserved->bool_val) {
+        return true;
+    }
+
+    std::string name = field.inst_name.substr(0, 8);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return name == "reserved" || name.compare(0, 4, "rsvd") == 0;
+}
+
+// Declared fields carry their access in the sw property; sw_access is only set for generated ones
+bool is_software_writable(const ElaboratedField &field)
+{
+    const PropertyValue *sw = find_property(field, "sw");
+    if (sw && sw->type == PropertyValue::STRING) {
+        return sw->string_val != "r" && sw->string_val != "na";
+    }
+    return field.sw_access != ElaboratedField::R && field.sw_access != ElaboratedField::NA;
+}
+
+size_t count_nodes(const ElaboratedNode &node)
+{
+    size_t count = 1;
+    for (const auto &child : node.children) {
+        count += count_nodes(*child);
+    }
+    return count;
+}
+
+/**
+ * @brief A piece of the model checked by one worker
+ *
+ * Containers near the root are split so that large designs yield enough
+ * units to keep every worker busy; a split container is checked on its own
+ * (recurse = false) and its children become separate units.
+ */
+struct WorkUnit
+{
+    ElaboratedNode *node;
+    bool            recurse;
+};
+
+void split_work(ElaboratedNode &node, size_t depth, std::vector<WorkUnit> &units)
+{
+    constexpr size_t max_split_depth = 3;
+
+    bool container = node_kind(node) & (ADDRMAP | REGFILE);
+    if (!container || depth >= max_split_depth || node.children.empty()) {
+        units.push_back({&node, true});
+        return;
+    }
+
+    units.push_back({&node, false});
+    for (const auto &child : node.children) {
+        split_work(*child, depth + 1, units);
+    }
+}
+
+// Built-in rules
+
+class NamingRule : public LintRule
+{
+public:
+    explicit NamingRule(const std::string &pattern)
+        : pattern_text_(pattern)
+        , pattern_(pattern, std::regex::ECMAScript | std::regex::optimize)
+    {}
+
+    const char *id() const override { return "naming-convention"; }
+    const char *description() const override
+    {
+        return "Instance names must match the naming pattern";
+    }
+    uint32_t node_kinds() const override { return ALL; }
+
+    void check(const ElaboratedNode &node, LintContext &context) const override
+    {
+        // Array instances carry their index in the name, e.g. "regs[3]"
+        std::string name = node.inst_name.substr(0, node.inst_name.find('['));
+        if (!name.empty() && !std::regex_match(name, pattern_)) {
+            context.report(
+                node, "Name '" + name + "' does not match naming pattern " + pattern_text_);
+        }
+    }
+
+private:
+    std::string pattern_text_;
+    std::regex  pattern_;
+};
+
+class AlignmentRule : public LintRule
+{
+public:
+    const char *id() const override { return "address-alignment"; }
+    const char *description() const override
+    {
+        return "Registers and register files must be naturally aligned";
+    }
+    uint32_t node_kinds() const override { return REG | REGFILE; }
+
+    void check(const ElaboratedNode &node, LintContext &context) const override
+    {
+        Address alignment = 0;
+        if (auto reg = dynamic_cast<const ElaboratedReg *>(&node)) {
+            alignment = reg->register_width / 8;
+        } else {
+            alignment = required_regfile_alignment(node);
+        }
+
+        if (alignment > 1 && node.absolute_address % alignment != 0) {
+            context.report(
+                node,
+                "Address 0x" + to_hex(node.absolute_address) + " is not aligned to "
+                    + std::to_string(alignment) + " bytes");
+        }
+    }
+
+private:
+    static Address required_regfile_alignment(const ElaboratedNode &node)
+    {
+        const PropertyValue *alignment = find_property(node, "alignment");
+        if (alignment && alignment->type == PropertyValue::INTEGER && alignment->int_val > 0) {
+            return static_cast<Address>(alignment->int_val);
+        }
+
+        // Without an explicit alignment, use the widest register directly inside
+        Address widest = 0;
+        for (const auto &child : node.children) {
+            if (auto reg = dynamic_cast<const ElaboratedReg *>(child.get())) {
+                widest = std::max<Address>(widest, reg->register_width / 8);
+            }
+        }
+        return widest;
+    }
+
+    static std::string to_hex(Address value)
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string       text;
+        do {
+            text.insert(text.begin(), digits[value & 0xf]);
+            value >>= 4;
+        } while (value != 0);
+        return text;
+    }
+};
+
+class ReservedFieldRule : public LintRule
+{
+public:
+    const char *id() const override { return "reserved-field"; }
+    const char *description() const override
+    {
+        return "Reserved fields must not be software writable and must reset to 0";
+    }
+    uint32_t node_kinds() const override { return FIELD; }
+
+    void check(const ElaboratedNode &node, LintContext &context) const override
+    {
+        auto field = dynamic_cast<const ElaboratedField *>(&node);
+        if (!field || !is_reserved_field(*field)) {
+            return;
+        }
+
+        if (is_software_writable(*field)) {
+            context.report(node, "Reserved field '" + field->inst_name + "' is software writable");
+        }
+        const PropertyValue *reset = find_property(*field, "reset");
+        if (field->reset_value != 0
+            || (reset && reset->type == PropertyValue::INTEGER && reset->int_val != 0)) {
+            context.report(node, "Reserved field '" + field->inst_name + "' resets to non-zero");
+        }
+    }
+};
+
+class ResetConsistencyRule : public LintRule
+{
+public:
+    const char *id() const override { return "reset-consistency"; }
+    const char *description() const override
+    {
+        return "Either all fields of a register define a reset value or none do";
+    }
+    uint32_t node_kinds() const override { return REG; }
+
+    void check(const ElaboratedNode &node, LintContext &context) const override
+    {
+        size_t                   with_reset = 0;
+        std::vector<std::string> without_reset;
+        for (const auto &child : node.children) {
+            auto field = dynamic_cast<const ElaboratedField *>(child.get());
+            if (!field || is_reserved_field(*field)) {
+                continue;
+            }
+            if (find_property(*field, "reset")) {
+                with_reset++;
+            } else {
+                without_reset.push_back(field->inst_name);
+            }
+        }
+
+        if (with_reset == 0 || without_reset.empty()) {
+            return;
+        }
+
+        std::string names;
+        for (const auto &name : without_reset) {
+            names += (names.empty() ? "" : ", ") + name;
+        }
+        context.report(node, "Fields without reset value in a register with resets: " + names);
+    }
+};
+
+class DescriptionRule : public LintRule
+{
+public:
+    const char *id() const override { return "missing-description"; }
+    const char *description() const override
+    {
+        return "Address maps, register files, registers and memories need a desc";
+    }
+    uint32_t node_kinds() const override { return ADDRMAP | REGFILE | REG | MEM; }
+
+    Diagnostic::Severity default_severity() const override { return Diagnostic::Severity::Note; }
+
+    void check(const ElaboratedNode &node, LintContext &context) const override
+    {
+        const PropertyValue *desc = find_property(node, "desc");
+        if (!desc || (desc->type == PropertyValue::STRING && desc->string_val.empty())) {
+            context.report(node, node.get_node_type() + " '" + node.inst_name + "' has no desc");
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Fused traversal: every node is visited once and handed to all rules of its kind
+ */
+class LintTraverser : public ElaboratedModelTraverser
+{
+public:
+    LintTraverser(const DispatchTable &dispatch, LintContext &context)
+        : dispatch_(dispatch)
+        , context_(context)
+    {}
+
+    void check_node(ElaboratedNode &node)
+    {
+        uint32_t kind = node_kind(node);
+        if (kind == 0) {
+            return;
+        }
+        for (const LintRule *rule : dispatch_[kind_index(kind)]) {
+            context_.rule_     = rule->id();
+            context_.severity_ = rule->default_severity();
+            rule->check(node, context_);
+        }
+    }
+
+protected:
+    void pre_visit(ElaboratedNode &node) override { check_node(node); }
+
+private:
+    const DispatchTable &dispatch_;
+    LintContext         &context_;
+};
+
+uint32_t node_kind(const ElaboratedNode &node)
+{
+    if (dynamic_cast<const ElaboratedField *>(&node)) {
+        return FIELD;
+    }
+    if (dynamic_cast<const ElaboratedReg *>(&node)) {
+        return REG;
+    }
+    if (dynamic_cast<const ElaboratedRegfile *>(&node)) {
+        return REGFILE;
+    }
+    if (dynamic_cast<const ElaboratedAddrmap *>(&node)) {
+        return ADDRMAP;
+    }
+    if (dynamic_cast<const ElaboratedMem *>(&node)) {
+        return MEM;
+    }
+    return 0;
+}
+
+Diagnostic LintFinding::to_diagnostic(const std::string &file) const
+{
+    Diagnostic diagnostic;
+    diagnostic.severity = severity;
+    diagnostic.file     = file;
+    diagnostic.line     = line;
+    diagnostic.column   = column;
+    diagnostic.code     = rule;
+    diagnostic.message  = path.empty() ? message : path + ": " + message;
+    return diagnostic;
+}
+
+void LintContext::report(const ElaboratedNode &node, const std::string &message)
+{
+    LintFinding finding;
+    finding.rule     = rule_;
+    finding.severity = severity_;
+    finding.path     = node.get_hierarchical_path();
+    finding.message  = message;
+    if (node.source_ctx && node.source_ctx->getStart()) {
+        finding.line   = node.source_ctx->getStart()->getLine();
+        finding.column = node.source_ctx->getStart()->getCharPositionInLine();
+    }
+    findings_.push_back(std::move(finding));
+}
+
+std::unique_ptr<LintRule> make_naming_rule(const std::string &pattern)
+{
+    return std::make_unique<NamingRule>(pattern);
+}
+
+std::unique_ptr<LintRule> make_alignment_rule()
+{
+    return std::make_unique<AlignmentRule>();
+}
+
+std::unique_ptr<LintRule> make_reserved_field_rule()
+{
+    return std::make_unique<ReservedFieldRule>();
+}
+
+std::unique_ptr<LintRule> make_reset_consistency_rule()
+{
+    return std::make_unique<ResetConsistencyRule>();
+}
+
+std::unique_ptr<LintRule> make_description_rule()
+{
+    return std::make_unique<DescriptionRule>();
+}
+
+LintEngine::LintEngine() = default;
+
+LintEngine::~LintEngine()
+{
+    // Plugin rules have their code in the plugin, so they must go before it is unloaded
+    rules_.clear();
+    for (void *handle : plugin_handles_) {
+#if defined(_WIN32)
+        FreeLibrary(static_cast<HMODULE>(handle));
+#else
+        dlclose(handle);
+#endif
+    }
+}
+
+void LintEngine::add_rule(std::unique_ptr<LintRule> rule)
+{
+    if (rule) {
+        rules_.push_back(std::move(rule));
+    }
+}
+
+void LintEngine::add_builtin_rules()
+{
+    add_rule(make_naming_rule());
+    add_rule(make_alignment_rule());
+    add_rule(make_reserved_field_rule());
+    add_rule(make_reset_consistency_rule());
+    add_rule(make_description_rule());
+}
+
+bool LintEngine::disable_rule(const std::string &id)
+{
+    auto it = std::find_if(rules_.begin(), rules_.end(), [&](const auto &rule) {
+        return id == rule->id();
+    });
+    if (it == rules_.end()) {
+        return false;
+    }
+    rules_.erase(it);
+    return true;
+}
+
+bool LintEngine::load_plugin(const std::string &path, std::string *error)
+{
+    using AbiVersionFunc = int (*)();
+    using RegisterFunc   = void (*)(LintEngine &);
+
+    auto fail = [&](const std::string &message) {
+        if (error) {
+            *error = path + ": " + message;
+        }
+        return false;
+    };
+
+#if defined(_WIN32)
+    HMODULE handle = LoadLibraryA(path.c_str());
+    if (!handle) {
+        return fail("cannot load plugin (error " + std::to_string(GetLastError()) + ")");
+    }
+    auto close  = [&]() { FreeLibrary(handle); };
+    auto lookup = [&](const char *name) {
+        return reinterpret_cast<void *>(GetProcAddress(handle, name));
+    };
+#else
+    void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char *message = dlerror();
+        return fail(message ? message : "cannot load plugin");
+    }
+    auto close  = [&]() { dlclose(handle); };
+    auto lookup = [&](const char *name) { return dlsym(handle, name); };
+#endif
+
+    auto abi_version    = reinterpret_cast<AbiVersionFunc>(
+        lookup("systemrdl_lint_plugin_abi_version"));
+    auto register_rules = reinterpret_cast<RegisterFunc>(lookup("systemrdl_lint_register_rules"));
+    if (!abi_version || !register_rules) {
+        close();
+        return fail("not a lint plugin (missing SYSTEMRDL_LINT_PLUGIN_ENTRY)");
+    }
+    if (abi_version() != PLUGIN_ABI_VERSION) {
+        close();
+        return fail(
+            "plugin ABI version " + std::to_string(abi_version()) + " does not match "
+            + std::to_string(PLUGIN_ABI_VERSION));
+    }
+
+    plugin_handles_.push_back(reinterpret_cast<void *>(handle));
+    register_rules(*this);
+    return true;
+}
+
+std::vector<LintFinding> LintEngine::run(ElaboratedNode &root) const
+{
+    trace::Span span("lint", "lint");
+
+    DispatchTable dispatch;
+    for (const auto &rule : rules_) {
+        for (size_t i = 0; i < KIND_COUNT; ++i) {
+            if (rule->node_kinds() & (1u << i)) {
+                dispatch[i].push_back(rule.get());
+            }
+        }
+    }
+
+    std::vector<WorkUnit> units;
+    split_work(root, 0, units);
+
+    // Below this many nodes thread start-up costs more than it saves
+    constexpr size_t parallel_threshold = 2048;
+
+    size_t workers = threads_ > 0 ? threads_ : std::thread::hardware_concurrency();
+    workers        = std::min(workers, units.size());
+
+    std::vector<LintContext> contexts(units.size());
+    auto                     check_unit = [&](size_t i) {
+        LintTraverser traverser(dispatch, contexts[i]);
+        if (units[i].recurse) {
+            traverser.traverse(*units[i].node);
+        } else {
+            traverser.check_node(*units[i].node);
+        }
+    };
+
+    if (workers <= 1 || count_nodes(root) < parallel_threshold) {
+        for (size_t i = 0; i < units.size(); ++i) {
+            check_unit(i);
+        }
+    } else {
+        std::atomic<size_t> next_unit{0};
+        auto                worker = [&]() {
+            trace::Span span("lint_subtrees", "lint");
+            size_t      checked = 0;
+            for (size_t i = next_unit++; i < units.size(); i = next_unit++) {
+                check_unit(i);
+                checked++;
+            }
+            span.add_arg("subtrees", std::to_string(checked));
+        };
+
+        std::vector<std::future<void>> helpers;
+        for (size_t w = 1; w < workers; ++w) {
+            helpers.push_back(std::async(std::launch::async, worker));
+        }
+        worker();
+        for (auto &helper : helpers) {
+            helper.get();
+        }
+    }
+
+    // Units are in pre-order, so concatenating them keeps the sequential order
+    std::vector<LintFinding> findings;
+    for (auto &context : contexts) {
+        std::move(
+            context.findings_.begin(), context.findings_.end(), std::back_inserter(findings));
+    }
+    span.add_arg("findings", std::to_string(findings.size()));
+    return findings;
+}
+
+} // namespace lint
+} // namespace systemrdl
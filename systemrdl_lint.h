@@ -0,0 +1,222 @@
+#pragma once
+
+#include "elaborator.h"
+#include "systemrdl_api.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Rule-based checks over an elaborated model
+ *
+ * Rules register against the node kinds they inspect. The engine builds a
+ * per-kind dispatch table and runs every rule in a single traversal, splitting
+ * the model into subtrees that are checked concurrently. Findings are merged
+ * back in pre-order, so the output does not depend on the thread count.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::lint::LintEngine engine;
+ * engine.add_builtin_rules();
+ * for (const auto &finding : engine.run(*model)) {
+ *     std::cerr << finding.to_diagnostic("design.rdl").to_string() << std::endl;
+ * }
+ * ```
+ */
+namespace lint {
+
+/**
+ * @brief Node kinds a rule can register for (bit mask)
+ */
+enum NodeKind : uint32_t {
+    ADDRMAP = 1u << 0,
+    REGFILE = 1u << 1,
+    REG     = 1u << 2,
+    FIELD   = 1u << 3,
+    MEM     = 1u << 4,
+    ALL     = ADDRMAP | REGFILE | REG | FIELD | MEM
+};
+
+/**
+ * @brief Kind of an elaborated node, 0 for unknown node types
+ */
+uint32_t node_kind(const ElaboratedNode &node);
+
+/**
+ * @brief One rule violation
+ */
+struct LintFinding
+{
+    std::string          rule;     // Rule id, e.g. "naming-convention"
+    Diagnostic::Severity severity = Diagnostic::Severity::Warning;
+    std::string          path;     // Hierarchical instance path
+    std::string          message;
+    size_t               line   = 0; // 1-based source line, 0 if unknown
+    size_t               column = 0; // 0-based source column
+
+    // Convert to the shared diagnostic format (code = rule id)
+    Diagnostic to_diagnostic(const std::string &file = "") const;
+};
+
+/**
+ * @brief Collects findings for the rule currently being run
+ *
+ * Each worker thread owns its own context, so reporting takes no locks.
+ */
+class LintContext
+{
+public:
+    void report(const ElaboratedNode &node, const std::string &message);
+
+    const std::vector<LintFinding> &findings() const { return findings_; }
+
+private:
+    friend class LintEngine;
+    friend class LintTraverser;
+
+    std::vector<LintFinding> findings_;
+    const char              *rule_     = "";
+    Diagnostic::Severity     severity_ = Diagnostic::Severity::Warning;
+};
+
+/**
+ * @brief Base class for lint rules
+ *
+ * check() is called concurrently for different nodes and must not modify
+ * shared state; configuration should be fixed before the engine runs.
+ */
+class LintRule
+{
+public:
+    virtual ~LintRule() = default;
+
+    // Stable identifier used in reports and for enabling/disabling the rule
+    virtual const char *id() const          = 0;
+    virtual const char *description() const = 0;
+
+    // NodeKind mask of the nodes passed to check()
+    virtual uint32_t node_kinds() const = 0;
+
+    virtual Diagnostic::Severity default_severity() const
+    {
+        return Diagnostic::Severity::Warning;
+    }
+
+    virtual void check(const ElaboratedNode &node, LintContext &context) const = 0;
+};
+
+/**
+ * @brief Built-in rule: instance names must match a pattern
+ *
+ * The default accepts lower_snake_case and UPPER_SNAKE_CASE. Array suffixes
+ * are ignored.
+ */
+std::unique_ptr<LintRule> make_naming_rule(
+    const std::string &pattern = "^([a-z][a-z0-9_]*|[A-Z][A-Z0-9_]*)$");
+
+/**
+ * @brief Built-in rule: registers and register files must be naturally aligned
+ */
+std::unique_ptr<LintRule> make_alignment_rule();
+
+/**
+ * @brief Built-in rule: reserved fields must not be software writable and must reset to 0
+ */
+std::unique_ptr<LintRule> make_reserved_field_rule();
+
+/**
+ * @brief Built-in rule: either all fields of a register define a reset value or none do
+ */
+std::unique_ptr<LintRule> make_reset_consistency_rule();
+
+/**
+ * @brief Built-in rule: addrmaps, register files, registers and memories need a desc
+ */
+std::unique_ptr<LintRule> make_description_rule();
+
+/**
+ * @brief Runs a set of rules over an elaborated model
+ */
+class LintEngine
+{
+public:
+    LintEngine();
+    ~LintEngine();
+
+    LintEngine(const LintEngine &)            = delete;
+    LintEngine &operator=(const LintEngine &) = delete;
+
+    void add_rule(std::unique_ptr<LintRule> rule);
+
+    // Register all built-in rules with their default configuration
+    void add_builtin_rules();
+
+    /**
+     * @brief Load rules from a shared library
+     *
+     * The library must export the C functions declared by
+     * SYSTEMRDL_LINT_PLUGIN_ENTRY (see below). It stays loaded until the engine
+     * is destroyed.
+     *
+     * @return true on success; on failure *error (if given) describes the problem
+     */
+    bool load_plugin(const std::string &path, std::string *error = nullptr);
+
+    // Disable a rule by id; returns false if no such rule is registered
+    bool disable_rule(const std::string &id);
+
+    // Worker threads for run(), 0 = hardware concurrency
+    void   set_threads(size_t threads) { threads_ = threads; }
+    size_t get_threads() const { return threads_; }
+
+    const std::vector<std::unique_ptr<LintRule>> &rules() const { return rules_; }
+
+    /**
+     * @brief Run all enabled rules over the model
+     * @return Findings in pre-order of the nodes, then in rule registration order
+     */
+    std::vector<LintFinding> run(ElaboratedNode &root) const;
+
+private:
+    std::vector<std::unique_ptr<LintRule>> rules_;
+    std::vector<void *>                    plugin_handles_;
+    size_t                                 threads_ = 0;
+};
+
+/**
+ * @brief Plugin ABI version; bumped whenever LintRule or LintEngine change layout
+ */
+constexpr int PLUGIN_ABI_VERSION = 1;
+
+} // namespace lint
+
+} // namespace systemrdl
+
+/**
+ * @brief Define the entry points of a lint plugin
+ *
+ * @example
+ * ```cpp
+ * SYSTEMRDL_LINT_PLUGIN_ENTRY(engine)
+ * {
+ *     engine.add_rule(std::make_unique<MyRule>());
+ * }
+ * ```
+ */
+#if defined(_WIN32)
+#define SYSTEMRDL_LINT_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define SYSTEMRDL_LINT_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define SYSTEMRDL_LINT_PLUGIN_ENTRY(engine)                                                        \
+    SYSTEMRDL_LINT_PLUGIN_EXPORT int systemrdl_lint_plugin_abi_version()                           \
+    {                                                                                              \
+        return systemrdl::lint::PLUGIN_ABI_VERSION;                                                \
+    }                                                                                              \
+    SYSTEMRDL_LINT_PLUGIN_EXPORT void systemrdl_lint_register_rules(                               \
+        systemrdl::lint::LintEngine &engine)
@@ -0,0 +1,399 @@
+#include "systemrdl_memory.h"
+#include "elaborator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace systemrdl {
+namespace memory {
+
+namespace {
+
+struct Counters
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> bytes_allocated{0};
+    std::atomic<uint64_t> bytes_freed{0};
+    std::atomic<uint64_t> live_bytes{0};
+    std::atomic<uint64_t> peak_live_bytes{0};
+};
+
+// Constant-initialized so it is usable by allocations made during static initialization
+Counters g_counters;
+
+} // namespace
+
+#ifdef SYSTEMRDL_ALLOC_TRACKING
+namespace {
+
+// Each allocation is prefixed with its size so unsized delete can account for it.
+// The header keeps the default new alignment for the returned pointer.
+constexpr std::size_t kHeaderSize = alignof(std::max_align_t) > sizeof(std::size_t)
+                                        ? alignof(std::max_align_t)
+                                        : sizeof(std::size_t);
+
+void record_allocation(std::size_t size)
+{
+    g_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    g_counters.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    const uint64_t live = g_counters.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t       peak = g_counters.peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak
+           && !g_counters.peak_live_bytes.compare_exchange_weak(
+               peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void *tracked_alloc(std::size_t size) noexcept
+{
+    void *block = std::malloc(size + kHeaderSize);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    *static_cast<std::size_t *>(block) = size;
+    record_allocation(size);
+    return static_cast<char *>(block) + kHeaderSize;
+}
+
+void *tracked_alloc_or_throw(std::size_t size)
+{
+    for (;;) {
+        if (void *ptr = tracked_alloc(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void tracked_free(void *ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    void       *block = static_cast<char *>(ptr) - kHeaderSize;
+    std::size_t size  = *static_cast<std::size_t *>(block);
+    g_counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+    g_counters.bytes_freed.fetch_add(size, std::memory_order_relaxed);
+    g_counters.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+#endif
+
+bool allocation_tracking_available()
+{
+#ifdef SYSTEMRDL_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t live_bytes()
+{
+    return g_counters.live_bytes.load(std::memory_order_relaxed);
+}
+
+uint64_t current_rss_bytes()
+{
+#if defined(__linux__)
+    if (FILE *statm = std::fopen("/proc/self/statm", "r")) {
+        unsigned long pages    = 0;
+        unsigned long resident = 0;
+        int           matched  = std::fscanf(statm, "%lu %lu", &pages, &resident);
+        std::fclose(statm);
+        if (matched == 2) {
+            return static_cast<uint64_t>(resident) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t peak_rss_bytes()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage
+    {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss); // Already in bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // Kilobytes
+#endif
+#else
+    return 0;
+#endif
+}
+
+uint64_t MemoryStats::model_bytes() const
+{
+    uint64_t total = 0;
+    for (const auto &kind : node_kinds) {
+        total += kind.total_bytes();
+    }
+    return total;
+}
+
+uint64_t MemoryStats::property_map_bytes() const
+{
+    uint64_t total = 0;
+    for (const auto &kind : node_kinds) {
+        total += kind.property_map_bytes;
+    }
+    return total;
+}
+
+PhaseScope::PhaseScope(MemoryStats *stats, const char *name)
+    : stats_(stats)
+    , name_(name)
+    , allocations_(g_counters.allocations.load(std::memory_order_relaxed))
+    , deallocations_(g_counters.deallocations.load(std::memory_order_relaxed))
+    , bytes_allocated_(g_counters.bytes_allocated.load(std::memory_order_relaxed))
+    , bytes_freed_(g_counters.bytes_freed.load(std::memory_order_relaxed))
+    , live_bytes_(g_counters.live_bytes.load(std::memory_order_relaxed))
+    , outer_peak_(0)
+{
+    // Restart the high-water mark for this phase; the enclosing value is restored on exit
+    if (stats_) {
+        outer_peak_ = g_counters.peak_live_bytes.exchange(live_bytes_, std::memory_order_relaxed);
+    }
+}
+
+PhaseScope::~PhaseScope()
+{
+    if (!stats_) {
+        return;
+    }
+
+    PhaseStats phase;
+    phase.name            = name_;
+    phase.allocations     = g_counters.allocations.load(std::memory_order_relaxed) - allocations_;
+    phase.deallocations   = g_counters.deallocations.load(std::memory_order_relaxed)
+                          - deallocations_;
+    phase.bytes_allocated = g_counters.bytes_allocated.load(std::memory_order_relaxed)
+                            - bytes_allocated_;
+    phase.bytes_freed     = g_counters.bytes_freed.load(std::memory_order_relaxed) - bytes_freed_;
+    phase.peak_live_bytes = g_counters.peak_live_bytes.load(std::memory_order_relaxed);
+
+    const uint64_t live  = g_counters.live_bytes.load(std::memory_order_relaxed);
+    phase.retained_bytes = live > live_bytes_ ? live - live_bytes_ : 0;
+    phase.rss_bytes      = current_rss_bytes();
+
+    g_counters.peak_live_bytes.store(
+        std::max(outer_peak_, phase.peak_live_bytes), std::memory_order_relaxed);
+
+    stats_->phases.push_back(std::move(phase));
+    stats_->peak_rss_bytes = std::max(stats_->peak_rss_bytes, peak_rss_bytes());
+}
+
+namespace {
+
+// Heap bytes owned by a string beyond its inline (small string) buffer
+uint64_t string_heap_bytes(const std::string &value)
+{
+    static const size_t inline_capacity = std::string().capacity();
+    return value.capacity() > inline_capacity ? value.capacity() + 1 : 0;
+}
+
+template <typename T> uint64_t vector_heap_bytes(const std::vector<T> &values)
+{
+    return values.capacity() * sizeof(T);
+}
+
+uint64_t node_object_size(const ElaboratedNode &node)
+{
+    if (dynamic_cast<const ElaboratedField *>(&node))
+        return sizeof(ElaboratedField);
+    if (dynamic_cast<const ElaboratedReg *>(&node))
+        return sizeof(ElaboratedReg);
+    if (dynamic_cast<const ElaboratedRegfile *>(&node))
+        return sizeof(ElaboratedRegfile);
+    if (dynamic_cast<const ElaboratedMem *>(&node))
+        return sizeof(ElaboratedMem);
+    if (dynamic_cast<const ElaboratedAddrmap *>(&node))
+        return sizeof(ElaboratedAddrmap);
+    return sizeof(ElaboratedNode);
+}
+
+void accumulate_node(const ElaboratedNode &node, std::map<std::string, NodeKindStats> &kinds)
+{
+    NodeKindStats &stats = kinds[node.get_node_type()];
+    stats.count++;
+    stats.object_bytes += node_object_size(node);
+    stats.string_bytes += string_heap_bytes(node.inst_name) + string_heap_bytes(node.type_name);
+    if (auto reg = dynamic_cast<const ElaboratedReg *>(&node)) {
+        stats.string_bytes += string_heap_bytes(reg->register_reset_hex);
+    }
+    stats.container_bytes += vector_heap_bytes(node.array_dimensions)
+                             + vector_heap_bytes(node.array_strides)
+                             + vector_heap_bytes(node.array_indices)
+                             + vector_heap_bytes(node.children);
+
+    // unordered_map: bucket array plus one heap node per entry (value, next pointer, cached hash)
+    const auto &props = node.properties;
+    stats.property_count += props.size();
+    stats.property_map_bytes += props.bucket_count() * sizeof(void *);
+    for (const auto &entry : props) {
+        stats.property_map_bytes += sizeof(entry) + sizeof(void *) + sizeof(size_t)
+                                    + string_heap_bytes(entry.first)
+                                    + string_heap_bytes(entry.second.string_val);
+    }
+
+    for (const auto &child : node.children) {
+        accumulate_node(*child, kinds);
+    }
+}
+
+std::string format_bytes(uint64_t bytes)
+{
+    char buffer[32];
+    if (bytes >= 1024ULL * 1024 * 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f GiB", bytes / (1024.0 * 1024 * 1024));
+    } else if (bytes >= 1024ULL * 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f MiB", bytes / (1024.0 * 1024));
+    } else if (bytes >= 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.2f KiB", bytes / 1024.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%llu B", static_cast<unsigned long long>(bytes));
+    }
+    return buffer;
+}
+
+} // namespace
+
+void estimate_model_footprint(const ElaboratedNode &root, MemoryStats &stats)
+{
+    std::map<std::string, NodeKindStats> kinds;
+    for (const auto &existing : stats.node_kinds) {
+        kinds[existing.kind] = existing;
+    }
+
+    accumulate_node(root, kinds);
+
+    stats.node_kinds.clear();
+    for (auto &entry : kinds) {
+        entry.second.kind = entry.first;
+        stats.node_kinds.push_back(std::move(entry.second));
+    }
+}
+
+void print_report(const MemoryStats &stats, std::ostream &output)
+{
+    output << "[MEM] Memory statistics" << std::endl;
+    output << "  Peak RSS: " << format_bytes(stats.peak_rss_bytes) << std::endl;
+
+    if (!stats.phases.empty()) {
+        output << "  Phases:" << std::endl;
+        if (!stats.allocation_tracking) {
+            output << "    (allocation counters unavailable, rebuild with "
+                      "SYSTEMRDL_ENABLE_ALLOC_TRACKING=ON)"
+                   << std::endl;
+        }
+        for (const auto &phase : stats.phases) {
+            output << "    " << std::left << std::setw(22) << phase.name << std::right;
+            if (stats.allocation_tracking) {
+                output << " allocs " << std::setw(9) << phase.allocations << "  allocated "
+                       << std::setw(11) << format_bytes(phase.bytes_allocated) << "  peak "
+                       << std::setw(11) << format_bytes(phase.peak_live_bytes) << "  retained "
+                       << std::setw(11) << format_bytes(phase.retained_bytes);
+            }
+            output << "  rss " << format_bytes(phase.rss_bytes) << std::endl;
+        }
+    }
+
+    if (!stats.node_kinds.empty()) {
+        output << "  Elaborated model (estimated):" << std::endl;
+        for (const auto &kind : stats.node_kinds) {
+            const uint64_t per_node = kind.count ? kind.total_bytes() / kind.count : 0;
+            output << "    " << std::left << std::setw(9) << kind.kind << std::right << std::setw(9)
+                   << kind.count << " nodes  " << std::setw(11) << format_bytes(kind.total_bytes())
+                   << "  (" << per_node << " B/node, properties "
+                   << format_bytes(kind.property_map_bytes) << ")" << std::endl;
+        }
+        output << "    total              " << format_bytes(stats.model_bytes())
+               << "  (property maps " << format_bytes(stats.property_map_bytes()) << ")"
+               << std::endl;
+    }
+
+    if (stats.json_dom_bytes > 0 || stats.json_text_bytes > 0) {
+        output << "  JSON DOM (estimated): " << format_bytes(stats.json_dom_bytes)
+               << ", serialized text: " << format_bytes(stats.json_text_bytes) << std::endl;
+    }
+}
+
+} // namespace memory
+} // namespace systemrdl
+
+#ifdef SYSTEMRDL_ALLOC_TRACKING
+// Replacement global allocation functions. The aligned (std::align_val_t) forms
+// are left to the runtime, so over-aligned types are not counted.
+void *operator new(std::size_t size)
+{
+    return systemrdl::memory::tracked_alloc_or_throw(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return systemrdl::memory::tracked_alloc_or_throw(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return systemrdl::memory::tracked_alloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return systemrdl::memory::tracked_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    systemrdl::memory::tracked_free(ptr);
+}
+#endif
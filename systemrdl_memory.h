@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace systemrdl {
+
+class ElaboratedNode;
+
+/**
+ * @brief Memory accounting for the parse/elaborate/output pipeline
+ *
+ * Three independent sources of information are combined:
+ * - Allocation counters from replaced global operator new/delete. These are only
+ *   compiled in when the library is built with SYSTEMRDL_ENABLE_ALLOC_TRACKING=ON,
+ *   so regular builds pay nothing for them.
+ * - Process resident set size (current and peak) from the operating system.
+ * - Structural estimates of the elaborated model and JSON DOM, which are always
+ *   available because they walk the data instead of hooking the allocator.
+ */
+namespace memory {
+
+/**
+ * @brief Allocation activity attributed to one pipeline phase
+ */
+struct PhaseStats
+{
+    std::string name;
+    uint64_t    allocations     = 0; // operator new calls during the phase
+    uint64_t    deallocations   = 0; // operator delete calls during the phase
+    uint64_t    bytes_allocated = 0; // Bytes requested during the phase
+    uint64_t    bytes_freed     = 0; // Bytes released during the phase
+    uint64_t    peak_live_bytes = 0; // Live heap high-water mark reached during the phase
+    uint64_t    retained_bytes  = 0; // Bytes still live at the end that were not live before
+    uint64_t    rss_bytes       = 0; // Resident set size at the end of the phase
+};
+
+/**
+ * @brief Estimated footprint of one elaborated node kind (addrmap, reg, field, ...)
+ */
+struct NodeKindStats
+{
+    std::string kind;
+    uint64_t    count              = 0;
+    uint64_t    object_bytes       = 0; // sizeof() of the node objects themselves
+    uint64_t    string_bytes       = 0; // Heap storage of names and string members
+    uint64_t    container_bytes    = 0; // Array metadata and children vectors
+    uint64_t    property_count     = 0;
+    uint64_t    property_map_bytes = 0; // Buckets, hash nodes and heap strings of properties
+
+    uint64_t total_bytes() const
+    {
+        return object_bytes + string_bytes + container_bytes + property_map_bytes;
+    }
+};
+
+/**
+ * @brief Aggregated memory report
+ */
+struct MemoryStats
+{
+    bool                       allocation_tracking = false; // Phase allocation counters are valid
+    std::vector<PhaseStats>    phases;
+    std::vector<NodeKindStats> node_kinds;
+    uint64_t                   json_dom_bytes  = 0; // Estimated in-memory size of the JSON DOM
+    uint64_t                   json_text_bytes = 0; // Size of the serialized JSON text
+    uint64_t                   peak_rss_bytes  = 0;
+
+    uint64_t model_bytes() const;
+    uint64_t property_map_bytes() const;
+};
+
+/**
+ * @brief Check whether the allocation hooks are compiled into this library
+ */
+bool allocation_tracking_available();
+
+/**
+ * @brief Bytes currently allocated through operator new (0 without tracking)
+ */
+uint64_t live_bytes();
+
+/**
+ * @brief Current resident set size of the process, 0 if unavailable
+ */
+uint64_t current_rss_bytes();
+
+/**
+ * @brief Peak resident set size of the process, 0 if unavailable
+ */
+uint64_t peak_rss_bytes();
+
+/**
+ * @brief Attributes allocations made during its lifetime to a named phase
+ *
+ * Phases may nest; a nested phase's allocations are also counted in the
+ * enclosing one. Counters are process-wide, so concurrent work on other
+ * threads is attributed to whichever phases are open.
+ */
+class PhaseScope
+{
+public:
+    PhaseScope(MemoryStats *stats, const char *name);
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope &)            = delete;
+    PhaseScope &operator=(const PhaseScope &) = delete;
+
+private:
+    MemoryStats *stats_;
+    const char  *name_;
+    uint64_t     allocations_;
+    uint64_t     deallocations_;
+    uint64_t     bytes_allocated_;
+    uint64_t     bytes_freed_;
+    uint64_t     live_bytes_;
+    uint64_t     outer_peak_;
+};
+
+/**
+ * @brief Estimate per-kind memory footprint of an elaborated model
+ *
+ * Results are merged into stats.node_kinds (sorted by kind name).
+ */
+void estimate_model_footprint(const ElaboratedNode &root, MemoryStats &stats);
+
+/**
+ * @brief Write a human-readable report
+ */
+void print_report(const MemoryStats &stats, std::ostream &output);
+
+} // namespace memory
+
+} // namespace systemrdl
@@ -0,0 +1,122 @@
+#include "systemrdl_ndjson.h"
+
+#include <cstdio>
+#include <nlohmann/json.hpp>
+
+namespace systemrdl {
+
+namespace {
+
+nlohmann::json property_to_json(const PropertyValue &value)
+{
+    switch (value.type) {
+    case PropertyValue::INTEGER:
+        return value.int_val;
+    case PropertyValue::BOOLEAN:
+        return value.bool_val;
+    default:
+        return value.string_val;
+    }
+}
+
+std::string hex_address(Address address)
+{
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(address));
+    return buffer;
+}
+
+void add_name_and_desc(const ElaboratedNode &node, nlohmann::json &object)
+{
+    for (const char *key : {"name", "desc"}) {
+        auto it = node.properties.find(key);
+        if (it != node.properties.end()) {
+            object[key] = property_to_json(it->second);
+        }
+    }
+}
+
+// Field object as in the simplified JSON registers
+nlohmann::json field_to_json(const ElaboratedNode &field)
+{
+    nlohmann::json object;
+    object["inst_name"] = field.inst_name;
+    object["name"]      = field.inst_name;
+    add_name_and_desc(field, object);
+    for (const char *key :
+         {"lsb", "msb", "width", "sw", "hw", "reserved", "reset", "onwrite", "onread"}) {
+        auto it = field.properties.find(key);
+        if (it != field.properties.end()) {
+            object[key] = property_to_json(it->second);
+        }
+    }
+    object["absolute_address"] = hex_address(field.absolute_address);
+    return object;
+}
+
+} // namespace
+
+void NdjsonWriter::visit(ElaboratedAddrmap &node)
+{
+    write_line(node);
+    visit_children(node);
+}
+
+void NdjsonWriter::visit(ElaboratedRegfile &node)
+{
+    write_line(node);
+    visit_children(node);
+}
+
+void NdjsonWriter::visit(ElaboratedReg &node)
+{
+    write_line(node);
+}
+
+void NdjsonWriter::visit(ElaboratedMem &node)
+{
+    write_line(node);
+    visit_children(node);
+}
+
+void NdjsonWriter::visit_children(ElaboratedNode &node)
+{
+    for (auto &child : node.children) {
+        child->accept_visitor(*this);
+    }
+}
+
+void NdjsonWriter::write_line(ElaboratedNode &node)
+{
+    nlohmann::json line;
+    line["type"]      = node.get_node_type();
+    line["path"]      = node.get_hierarchical_path();
+    line["inst_name"] = node.inst_name;
+    add_name_and_desc(node, line);
+    line["absolute_address"] = hex_address(node.absolute_address);
+    line["size"]             = node.size;
+
+    if (auto reg = dynamic_cast<ElaboratedReg *>(&node)) {
+        line["register_width"] = reg->register_width;
+        if (!reg->register_reset_hex.empty()) {
+            line["register_reset_value"] = reg->register_reset_hex;
+        }
+        nlohmann::json fields = nlohmann::json::array();
+        for (const auto &child : node.children) {
+            if (dynamic_cast<const ElaboratedField *>(child.get())) {
+                fields.push_back(field_to_json(*child));
+            }
+        }
+        line["fields"] = std::move(fields);
+    } else if (auto mem = dynamic_cast<ElaboratedMem *>(&node)) {
+        line["memory_size"]   = mem->memory_size;
+        line["data_width"]    = mem->data_width;
+        line["address_width"] = mem->address_width;
+        line["memory_type"]   = mem->memory_type;
+    }
+
+    output_ << line.dump() << '\n';
+    line_count_++;
+}
+
+} // namespace systemrdl
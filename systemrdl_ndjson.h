@@ -0,0 +1,54 @@
+#pragma once
+
+#include "elaborator.h"
+
+#include <ostream>
+
+namespace systemrdl {
+
+/**
+ * @brief JSON Lines (NDJSON) writer for elaborated models
+ *
+ * Writes one self-contained JSON object per line for every addrmap, regfile,
+ * register and memory. Each object carries its "type", dotted "path",
+ * "absolute_address" and "size"; registers also carry their "fields" in the
+ * simplified-JSON layout. Lines do not refer to each other, so consumers can
+ * split the file at any line and process the parts in parallel.
+ *
+ * The writer is a visitor: write_model() walks a model in preorder. As a
+ * streaming sink it writes each register or memory as the elaborator
+ * finalizes it; write_model() on the returned model then adds the lines of
+ * the addrmaps and regfiles, which are only complete at that point.
+ *
+ * @example
+ * ```cpp
+ * std::ofstream           output("soc.ndjson");
+ * systemrdl::NdjsonWriter writer(output);
+ * writer.write_model(*model);
+ * ```
+ */
+class NdjsonWriter : public ElaboratedNodeVisitor
+{
+public:
+    explicit NdjsonWriter(std::ostream &output)
+        : output_(output)
+    {}
+
+    void   write_model(ElaboratedNode &root) { root.accept_visitor(*this); }
+    size_t line_count() const { return line_count_; }
+
+    void visit(ElaboratedAddrmap &node) override;
+    void visit(ElaboratedRegfile &node) override;
+    void visit(ElaboratedReg &node) override;
+    void visit(ElaboratedField &node) override {}
+    void visit(ElaboratedMem &node) override;
+
+private:
+    void write_line(ElaboratedNode &node);
+    void visit_children(ElaboratedNode &node);
+
+    std::ostream &output_;
+    size_t        line_count_ = 0;
+};
+
+} // namespace systemrdl
@@ -0,0 +1,75 @@
+#include "systemrdl_path.h"
+
+#include "systemrdl_trace.h"
+
+namespace systemrdl {
+
+PathTable::PathTable(const ElaboratedNode &root, const Filter &include)
+{
+    trace::Span span("build_path_table", "output");
+
+    add(root, NONE, [&](const ElaboratedNode &node) {
+        return &node == &root || !include || include(node);
+    });
+
+    if (span.active()) {
+        span.add_arg("entries", std::to_string(entries_.size()));
+        span.add_arg("segments", std::to_string(segments_.size()));
+    }
+}
+
+void PathTable::add(const ElaboratedNode &node, uint32_t parent, const Filter &include)
+{
+    uint32_t id = parent;
+    if (include(node)) {
+        auto segment = segment_ids_.emplace(
+            node.inst_name, static_cast<uint32_t>(segments_.size()));
+        if (segment.second) {
+            segments_.push_back(node.inst_name);
+        }
+        id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back({parent, segment.first->second, &node});
+        ids_.emplace(&node, id);
+    }
+    for (const auto &child : node.children) {
+        add(*child, id, include);
+    }
+}
+
+uint32_t PathTable::find(const ElaboratedNode *node) const
+{
+    auto it = ids_.find(node);
+    return it != ids_.end() ? it->second : NONE;
+}
+
+uint32_t PathTable::find_enclosing(const ElaboratedNode *node) const
+{
+    for (; node; node = node->parent) {
+        uint32_t id = find(node);
+        if (id != NONE) {
+            return id;
+        }
+    }
+    return NONE;
+}
+
+size_t PathTable::depth(uint32_t id) const
+{
+    size_t depth = 0;
+    for (; entries_[id].parent != NONE; id = entries_[id].parent) {
+        depth++;
+    }
+    return depth;
+}
+
+std::string PathTable::join(uint32_t id, const std::string &separator) const
+{
+    return join_path(
+        id,
+        NONE,
+        [this](uint32_t up) -> const std::string & { return segment(up); },
+        [this](uint32_t up) { return parent(up); },
+        separator);
+}
+
+} // namespace systemrdl
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "elaborator.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace systemrdl {
+
+// Join a path from its last segment up: segment(id) is the name of id and parent(id) the id
+// above it, none past the root. Sized first and filled from the end, so one allocation.
+template <typename Id, typename Segment, typename Parent>
+std::string join_path(
+    Id id, Id none, Segment &&segment, Parent &&parent, const std::string &separator = ".")
+{
+    size_t length = segment(id).size();
+    for (Id up = parent(id); up != none; up = parent(up)) {
+        length += segment(up).size() + separator.size();
+    }
+
+    std::string path(length, ' ');
+    size_t      end = length;
+    for (Id up = id; up != none; up = parent(up)) {
+        const std::string &name = segment(up);
+        end -= name.size();
+        path.replace(end, name.size(), name);
+        if (parent(up) != none) {
+            end -= separator.size();
+            path.replace(end, separator.size(), separator);
+        }
+    }
+    return path;
+}
+
+/**
+ * @brief Instance paths of an elaborated model
+ *
+ * Every node gets an entry holding its name segment and the index of its
+ * parent's entry; names shared by many instances (field names, register
+ * names repeated in every block) are stored once. A path is available as a
+ * chain of segments without any allocation and is only joined into a string
+ * on request. The table refers to the model, which must not change while it
+ * is in use.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::PathTable paths(*model);
+ * uint32_t             id = paths.find(reg_node);
+ * paths.for_each_segment(id, [](const std::string &segment) { ... });
+ * std::string dotted = paths.join(id); // "top.uart[0].ctrl"
+ * ```
+ */
+class PathTable
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // Include filter: nodes rejected are skipped and their children attached to the nearest
+    // included ancestor; the root is always included
+    using Filter = std::function<bool(const ElaboratedNode &)>;
+
+    explicit PathTable(const ElaboratedNode &root, const Filter &include = {});
+
+    size_t size() const { return entries_.size(); }
+    size_t segment_count() const { return segments_.size(); }
+
+    // Entry of a node, or NONE if it is not in the table
+    uint32_t find(const ElaboratedNode *node) const;
+
+    // Entry of the node or, if it is filtered out, of its nearest included ancestor
+    uint32_t find_enclosing(const ElaboratedNode *node) const;
+
+    uint32_t              parent(uint32_t id) const { return entries_[id].parent; }
+    const std::string    &segment(uint32_t id) const { return segments_[entries_[id].segment]; }
+    const ElaboratedNode *node(uint32_t id) const { return entries_[id].node; }
+    size_t                depth(uint32_t id) const;
+
+    // Calls f with each segment from the root down to the entry
+    template <typename F> void for_each_segment(uint32_t id, F &&f) const
+    {
+        if (entries_[id].parent != NONE) {
+            for_each_segment(entries_[id].parent, f);
+        }
+        f(segment(id));
+    }
+
+    std::string join(uint32_t id, const std::string &separator = ".") const;
+
+private:
+    struct Entry
+    {
+        uint32_t              parent;
+        uint32_t              segment;
+        const ElaboratedNode *node;
+    };
+
+    void add(const ElaboratedNode &node, uint32_t parent, const Filter &include);
+
+    std::vector<Entry>                                   entries_; // Preorder
+    std::vector<std::string>                             segments_;
+    std::unordered_map<std::string, uint32_t>            segment_ids_;
+    std::unordered_map<const ElaboratedNode *, uint32_t> ids_;
+};
+
+} // namespace systemrdl
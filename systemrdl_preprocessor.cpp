@@ -0,0 +1,575 @@
+#include "systemrdl_preprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+
+namespace systemrdl {
+namespace preprocess {
+
+namespace {
+
+constexpr size_t MAX_EXPANSION_DEPTH = 64;
+
+bool is_ident_start(char c)
+{
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool is_ident(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::string trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Index after the string literal starting at pos (the opening quote)
+size_t skip_string(const std::string &text, size_t pos)
+{
+    pos++;
+    while (pos < text.size() && text[pos] != '"') {
+        pos += (text[pos] == '\\') ? 2 : 1;
+    }
+    return std::min(text.size(), pos + 1);
+}
+
+size_t read_ident(const std::string &text, size_t pos)
+{
+    while (pos < text.size() && is_ident(text[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// Parse "(a, b(c, d), {e, f})" starting at the '('; pos ends after the ')'
+bool parse_args(
+    const std::string &text, size_t &pos, std::vector<std::string> &args, std::string &error)
+{
+    std::vector<char> nesting;
+    std::string       current;
+    for (size_t i = pos + 1; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') {
+            size_t end = skip_string(text, i);
+            current += text.substr(i, end - i);
+            i = end - 1;
+        } else if (c == '(' || c == '[' || c == '{') {
+            nesting.push_back(c == '(' ? ')' : c == '[' ? ']' : '}');
+            current += c;
+        } else if (!nesting.empty() && c == nesting.back()) {
+            nesting.pop_back();
+            current += c;
+        } else if (nesting.empty() && c == ',') {
+            args.push_back(trim(current));
+            current.clear();
+        } else if (nesting.empty() && c == ')') {
+            args.push_back(trim(current));
+            pos = i + 1;
+            return true;
+        } else {
+            current += c;
+        }
+    }
+    error = "Unterminated macro argument list";
+    return false;
+}
+
+// A name right after a single backtick is a macro reference; after `` it is pasted text
+bool is_macro_reference(const std::string &text, size_t pos)
+{
+    return pos > 0 && text[pos - 1] == '`' && (pos == 1 || text[pos - 2] != '`');
+}
+
+// Replace parameter names in a macro body and apply `` token pasting
+std::string substitute(const Macro &macro, const std::vector<std::string> &args)
+{
+    std::string result;
+    for (size_t i = 0; i < macro.body.size();) {
+        char c = macro.body[i];
+        if (c == '"') {
+            size_t end = skip_string(macro.body, i);
+            result += macro.body.substr(i, end - i);
+            i = end;
+        } else if (is_ident_start(c) && !is_macro_reference(macro.body, i)) {
+            size_t      end  = read_ident(macro.body, i);
+            std::string word = macro.body.substr(i, end - i);
+            auto        it   = std::find(macro.params.begin(), macro.params.end(), word);
+            result += (it != macro.params.end()) ? args[it - macro.params.begin()] : word;
+            i = end;
+        } else {
+            result += c;
+            i++;
+        }
+    }
+
+    for (size_t paste = result.find("``"); paste != std::string::npos;
+         paste        = result.find("``", paste)) {
+        result.erase(paste, 2);
+    }
+    return result;
+}
+
+class Processor
+{
+public:
+    Processor(const std::string &input, MacroTable &macros, const IncludeHandler &on_include)
+        : in_(input)
+        , macros_(macros)
+        , on_include_(on_include)
+    {}
+
+    std::string run(Output &output)
+    {
+        output_ = &output;
+        out_.reserve(in_.size());
+
+        while (pos_ < in_.size()) {
+            char c = in_[pos_];
+            if (c == '/' && peek(1) == '/') {
+                size_t end = in_.find('\n', pos_);
+                copy_to(end == std::string::npos ? in_.size() : end);
+            } else if (c == '/' && peek(1) == '*') {
+                size_t end = in_.find("*/", pos_ + 2);
+                copy_to(end == std::string::npos ? in_.size() : end + 2);
+            } else if (c == '"') {
+                copy_to(skip_string(in_, pos_));
+            } else if (c == '`' && is_ident_start(peek(1))) {
+                directive();
+            } else {
+                copy_to(pos_ + 1);
+            }
+        }
+
+        if (!branches_.empty()) {
+            error("Missing `endif for `ifdef/`ifndef", branches_.back().line, 0);
+        }
+        return std::move(out_);
+    }
+
+private:
+    struct Branch
+    {
+        bool   active;        // Text of the current branch is kept
+        bool   taken;         // An earlier or the current branch was selected
+        bool   parent_active; // The enclosing region is kept
+        bool   seen_else;
+        size_t line;
+    };
+
+    char peek(size_t offset) const
+    {
+        return pos_ + offset < in_.size() ? in_[pos_ + offset] : '\0';
+    }
+
+    bool active() const { return branches_.empty() || branches_.back().active; }
+
+    size_t column(size_t pos) const { return pos - line_start_; }
+
+    size_t out_column() const { return out_.size() - out_line_start_; }
+
+    void newline(size_t next)
+    {
+        out_ += '\n';
+        out_line_start_ = out_.size();
+        line_++;
+        line_start_ = next;
+    }
+
+    // Emit input up to end, blanked in inactive regions
+    void copy_to(size_t end)
+    {
+        bool keep = active();
+        for (; pos_ < end; pos_++) {
+            if (in_[pos_] == '\n') {
+                newline(pos_ + 1);
+            } else {
+                out_ += keep ? in_[pos_] : ' ';
+            }
+        }
+    }
+
+    // Replace input up to end by blanks, keeping line breaks
+    void blank_to(size_t end)
+    {
+        for (; pos_ < end; pos_++) {
+            if (in_[pos_] == '\n') {
+                newline(pos_ + 1);
+            } else {
+                out_ += ' ';
+            }
+        }
+    }
+
+    void error(const std::string &message, size_t line, size_t column)
+    {
+        Diagnostic diagnostic;
+        diagnostic.severity = Diagnostic::Severity::Error;
+        diagnostic.line     = line;
+        diagnostic.column   = column;
+        diagnostic.code     = "preprocessor";
+        diagnostic.message  = message;
+        output_->diagnostics.push_back(std::move(diagnostic));
+    }
+
+    size_t skip_blanks(size_t pos) const
+    {
+        while (pos < in_.size() && (in_[pos] == ' ' || in_[pos] == '\t')) {
+            pos++;
+        }
+        return pos;
+    }
+
+    // End of the line, excluding the newline
+    size_t line_end(size_t pos) const
+    {
+        size_t end = in_.find('\n', pos);
+        return end == std::string::npos ? in_.size() : end;
+    }
+
+    void directive()
+    {
+        size_t      start = pos_;
+        size_t      end   = read_ident(in_, pos_ + 1);
+        std::string name  = in_.substr(pos_ + 1, end - pos_ - 1);
+
+        if (name == "ifdef" || name == "ifndef" || name == "elsif" || name == "else"
+            || name == "endif") {
+            conditional(name, end);
+        } else if (!active()) {
+            blank_to(end);
+        } else if (name == "include") {
+            include(end);
+        } else if (name == "define") {
+            define(end);
+        } else if (name == "undef") {
+            size_t name_start = skip_blanks(end);
+            size_t name_end   = read_ident(in_, name_start);
+            if (name_end == name_start) {
+                error("Missing macro name after `undef", line_, column(start));
+            }
+            macros_.undef(in_.substr(name_start, name_end - name_start));
+            blank_to(name_end);
+        } else {
+            expand_use(name, start, end);
+        }
+    }
+
+    void conditional(const std::string &name, size_t end)
+    {
+        size_t      start = pos_;
+        std::string macro;
+        if (name == "ifdef" || name == "ifndef" || name == "elsif") {
+            size_t macro_start = skip_blanks(end);
+            end                = read_ident(in_, macro_start);
+            macro              = in_.substr(macro_start, end - macro_start);
+            if (macro.empty()) {
+                error("Missing macro name after `" + name, line_, column(start));
+            }
+        }
+        bool defined = macros_.find(macro) != nullptr;
+
+        if (name == "ifdef" || name == "ifndef") {
+            bool selected = (name == "ifdef") == defined;
+            bool parent   = active();
+            branches_.push_back({parent && selected, selected, parent, false, line_});
+        } else if (branches_.empty()) {
+            error("`" + name + " without `ifdef/`ifndef", line_, column(start));
+        } else if (name == "endif") {
+            branches_.pop_back();
+        } else {
+            Branch &branch = branches_.back();
+            if (branch.seen_else) {
+                error("`" + name + " after `else", line_, column(start));
+            }
+            bool selected = !branch.taken && (name == "else" || defined);
+            branch.active    = branch.parent_active && selected;
+            branch.taken     = branch.taken || selected;
+            branch.seen_else = branch.seen_else || name == "else";
+        }
+        blank_to(end);
+    }
+
+    void include(size_t end)
+    {
+        size_t start = pos_;
+        size_t open  = skip_blanks(end);
+        char   close = 0;
+        if (open < in_.size() && (in_[open] == '"' || in_[open] == '<')) {
+            close = in_[open] == '"' ? '"' : '>';
+        }
+        size_t path_end = close ? in_.find(close, open + 1) : std::string::npos;
+        if (path_end == std::string::npos || path_end > line_end(open)) {
+            error("Malformed `include directive", line_, column(start));
+            blank_to(end);
+            return;
+        }
+
+        size_t line = line_;
+        blank_to(path_end + 1);
+        if (on_include_) {
+            on_include_(in_.substr(open + 1, path_end - open - 1), line);
+        }
+    }
+
+    void define(size_t end)
+    {
+        size_t start      = pos_;
+        size_t name_start = skip_blanks(end);
+        size_t pos        = read_ident(in_, name_start);
+        if (pos == name_start) {
+            error("Missing macro name after `define", line_, column(start));
+            blank_to(end);
+            return;
+        }
+
+        std::string name = in_.substr(name_start, pos - name_start);
+        Macro       macro;
+        if (pos < in_.size() && in_[pos] == '(') {
+            // Function-like only when the parenthesis follows the name directly
+            macro.function_like = true;
+            size_t close        = in_.find(')', pos);
+            if (close == std::string::npos || close > line_end(pos)) {
+                error("Unterminated parameter list of macro `" + name, line_, column(start));
+                blank_to(line_end(pos));
+                return;
+            }
+            std::string list = in_.substr(pos + 1, close - pos - 1);
+            for (size_t begin = 0; begin <= list.size();) {
+                size_t comma = list.find(',', begin);
+                comma        = comma == std::string::npos ? list.size() : comma;
+                std::string param = trim(list.substr(begin, comma - begin));
+                if (!param.empty()) {
+                    macro.params.push_back(param);
+                }
+                begin = comma + 1;
+            }
+            pos = close + 1;
+        }
+
+        // Body up to the end of the line; a trailing backslash continues it
+        bool in_comment = false;
+        for (; pos < in_.size() && in_[pos] != '\n'; pos++) {
+            if (in_[pos] == '\\' && (peek_at(pos + 1) == '\n' || peek_at(pos + 1) == '\r')) {
+                size_t next = in_.find('\n', pos);
+                if (next == std::string::npos) {
+                    break;
+                }
+                pos = next;
+                macro.body += ' ';
+                in_comment = false;
+            } else if (in_[pos] == '/' && peek_at(pos + 1) == '/') {
+                in_comment = true;
+            } else if (!in_comment) {
+                macro.body += in_[pos] == '\r' ? ' ' : in_[pos];
+            }
+        }
+        macro.body = trim(macro.body);
+        macros_.define(name, std::move(macro));
+        blank_to(pos);
+    }
+
+    char peek_at(size_t pos) const { return pos < in_.size() ? in_[pos] : '\0'; }
+
+    void expand_use(const std::string &name, size_t start, size_t end)
+    {
+        size_t       line  = line_;
+        const Macro *macro = macros_.find(name);
+        if (!macro) {
+            error("Undefined macro `" + name, line, column(start));
+            blank_to(end);
+            return;
+        }
+
+        std::vector<std::string> args;
+        if (macro->function_like) {
+            size_t open = end;
+            while (open < in_.size() && std::isspace(static_cast<unsigned char>(in_[open]))) {
+                open++;
+            }
+            std::string message;
+            if (open >= in_.size() || in_[open] != '(') {
+                error("Macro `" + name + " expects arguments", line, column(start));
+                blank_to(end);
+                return;
+            }
+            end = open;
+            if (!parse_args(in_, end, args, message)) {
+                error(message, line, column(start));
+                blank_to(in_.size());
+                return;
+            }
+        }
+
+        std::string           text;
+        std::string           message;
+        std::set<std::string> expanding;
+        if (!apply(*macro, name, args, text, expanding, 0, message)) {
+            error(message, line, column(start));
+            blank_to(end);
+            return;
+        }
+        std::replace(text.begin(), text.end(), '\n', ' ');
+
+        output_->line_map.add(line, out_column(), column(start), true);
+        out_ += text;
+
+        // Arguments spanning lines: keep the line breaks after the expansion
+        for (size_t i = pos_; i < end; i++) {
+            if (in_[i] == '\n') {
+                newline(i + 1);
+            }
+        }
+        pos_ = end;
+        output_->line_map.add(line_, out_column(), column(end), false);
+    }
+
+    // Expand the arguments, substitute them, then expand the macros used in the result.
+    // expanding holds the macros being expanded around this one, but not the macro itself:
+    // like in C, an argument may use the macro it is passed to (`ID(`ID(z))).
+    bool apply(
+        const Macro                    &macro,
+        const std::string              &name,
+        const std::vector<std::string> &args,
+        std::string                    &text,
+        std::set<std::string>          &expanding,
+        size_t                          depth,
+        std::string                    &message)
+    {
+        if (depth >= MAX_EXPANSION_DEPTH) {
+            message = "Macro expansion too deep in `" + name;
+            return false;
+        }
+        bool no_args = macro.params.empty() && args.size() == 1 && args[0].empty();
+        if (macro.function_like && args.size() != macro.params.size() && !no_args) {
+            message = "Macro `" + name + " expects " + std::to_string(macro.params.size())
+                      + " argument(s), got " + std::to_string(args.size());
+            return false;
+        }
+
+        std::vector<std::string> expanded_args(args.size());
+        for (size_t i = 0; i < args.size(); i++) {
+            if (!expand(args[i], name, expanded_args[i], expanding, depth, message)) {
+                return false;
+            }
+        }
+
+        expanding.insert(name);
+        bool ok = expand(substitute(macro, expanded_args), name, text, expanding, depth, message);
+        expanding.erase(name);
+        return ok;
+    }
+
+    // Append input to text with the macro references in it expanded
+    bool expand(
+        const std::string     &input,
+        const std::string     &name,
+        std::string           &text,
+        std::set<std::string> &expanding,
+        size_t                 depth,
+        std::string           &message)
+    {
+        for (size_t i = 0; i < input.size();) {
+            if (input[i] == '"') {
+                size_t end = skip_string(input, i);
+                text += input.substr(i, end - i);
+                i = end;
+                continue;
+            }
+            if (input[i] != '`' || i + 1 >= input.size() || !is_ident_start(input[i + 1])) {
+                text += input[i++];
+                continue;
+            }
+
+            size_t       end    = read_ident(input, i + 1);
+            std::string  nested = input.substr(i + 1, end - i - 1);
+            const Macro *inner  = macros_.find(nested);
+            if (!inner) {
+                message = "Undefined macro `" + nested + " in expansion of `" + name;
+                return false;
+            }
+            if (expanding.count(nested)) {
+                message = "Recursive expansion of macro `" + nested;
+                return false;
+            }
+
+            std::vector<std::string> inner_args;
+            if (inner->function_like) {
+                size_t open = end;
+                while (open < input.size() && input[open] == ' ') {
+                    open++;
+                }
+                if (open >= input.size() || input[open] != '(') {
+                    message = "Macro `" + nested + " expects arguments";
+                    return false;
+                }
+                end = open;
+                if (!parse_args(input, end, inner_args, message)) {
+                    return false;
+                }
+            }
+
+            if (!apply(*inner, nested, inner_args, text, expanding, depth + 1, message)) {
+                return false;
+            }
+            i = end;
+        }
+        return true;
+    }
+
+    const std::string    &in_;
+    MacroTable           &macros_;
+    const IncludeHandler &on_include_;
+    Output               *output_ = nullptr;
+
+    std::string         out_;
+    size_t              pos_            = 0;
+    size_t              line_           = 1;
+    size_t              line_start_     = 0; // Input index of the current line
+    size_t              out_line_start_ = 0;
+    std::vector<Branch> branches_;
+};
+
+} // namespace
+
+void LineMap::add(size_t line, size_t output, size_t source, bool expanded)
+{
+    lines_[line].push_back({output, source, expanded});
+}
+
+size_t LineMap::source_column(size_t line, size_t column) const
+{
+    auto it = lines_.find(line);
+    if (it == lines_.end()) {
+        return column;
+    }
+
+    const Segment *segment = nullptr;
+    for (const auto &candidate : it->second) {
+        if (candidate.output <= column) {
+            segment = &candidate;
+        }
+    }
+    if (!segment) {
+        return column;
+    }
+    return segment->expanded ? segment->source : segment->source + (column - segment->output);
+}
+
+Output run(std::string &content, MacroTable &macros, const IncludeHandler &on_include)
+{
+    Output    output;
+    Processor processor(content, macros, on_include);
+    content = processor.run(output);
+    return output;
+}
+
+} // namespace preprocess
+} // namespace systemrdl
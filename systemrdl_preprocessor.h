@@ -0,0 +1,110 @@
+#pragma once
+
+#include "systemrdl_api.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Verilog-style preprocessor run ahead of the lexer
+ *
+ * Supports `define (object- and function-like, with `\` line continuation and
+ * `` token pasting), `undef, `ifdef, `ifndef, `elsif, `else, `endif, `include
+ * and macro uses. The buffer is rewritten in place: directives and inactive
+ * branches become blanks and expansions are spliced in on one line, so line
+ * numbers never move. Columns that shift after an expansion are recorded in a
+ * LineMap to report diagnostics at their source position.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::preprocess::MacroTable macros;
+ * macros.define("WIDTH", "32");
+ *
+ * auto output = systemrdl::preprocess::run(content, macros);
+ * ```
+ */
+namespace preprocess {
+
+struct Macro
+{
+    bool                     function_like = false;
+    std::vector<std::string> params;
+    std::string              body; // Continuation lines joined with spaces
+};
+
+/**
+ * @brief Macros visible at a point of the input, carried across included files
+ */
+class MacroTable
+{
+public:
+    void define(const std::string &name, std::string body) { macros_[name] = {false, {}, body}; }
+    void define(const std::string &name, Macro macro) { macros_[name] = std::move(macro); }
+    void undef(const std::string &name) { macros_.erase(name); }
+
+    const Macro *find(const std::string &name) const
+    {
+        auto it = macros_.find(name);
+        return it != macros_.end() ? &it->second : nullptr;
+    }
+
+    bool   empty() const { return macros_.empty(); }
+    size_t size() const { return macros_.size(); }
+
+private:
+    std::map<std::string, Macro> macros_;
+};
+
+/**
+ * @brief Maps columns of the preprocessed text back to the source
+ *
+ * Only lines containing an expansion have entries; other columns are unchanged.
+ */
+class LineMap
+{
+public:
+    // From output column `output` on, columns follow the source from `source`;
+    // with expanded = true the span maps to `source` as a whole
+    void add(size_t line, size_t output, size_t source, bool expanded);
+
+    size_t source_column(size_t line, size_t column) const;
+
+    bool empty() const { return lines_.empty(); }
+
+private:
+    struct Segment
+    {
+        size_t output;
+        size_t source;
+        bool   expanded;
+    };
+
+    std::map<size_t, std::vector<Segment>> lines_;
+};
+
+// Called for an active `include directive, with the quoted path and its 1-based line
+using IncludeHandler = std::function<void(const std::string &path, size_t line)>;
+
+struct Output
+{
+    LineMap                 line_map;
+    std::vector<Diagnostic> diagnostics; // Code "preprocessor", without file name
+};
+
+/**
+ * @brief Preprocess a buffer in place
+ *
+ * Directives inside comments and string literals are left alone. Includes are
+ * not expanded into the buffer; on_include is called where each one appears,
+ * so macros it defines apply to the rest of the buffer.
+ */
+Output run(std::string &content, MacroTable &macros, const IncludeHandler &on_include = {});
+
+} // namespace preprocess
+
+} // namespace systemrdl
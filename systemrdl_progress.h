@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace systemrdl {
+
+/**
+ * @brief Cancellation flag for long-running elaborations
+ *
+ * Copies share the same flag, so a token handed to the elaborator can be
+ * cancelled from another thread (e.g. a request handler or signal watcher).
+ *
+ * @example
+ * ```cpp
+ * systemrdl::ElaborateOptions options;
+ * std::thread watchdog([token = options.cancel_token] {
+ *     std::this_thread::sleep_for(std::chrono::seconds(30));
+ *     token.cancel();
+ * });
+ * auto result = systemrdl::file::elaborate("design.rdl", options);
+ * ```
+ */
+class CancellationToken
+{
+public:
+    CancellationToken()
+        : flag_(std::make_shared<std::atomic<bool>>(false))
+    {}
+
+    void cancel() const { flag_->store(true, std::memory_order_relaxed); }
+    void reset() const { flag_->store(false, std::memory_order_relaxed); }
+    bool is_cancelled() const { return flag_->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+/**
+ * @brief Snapshot passed to elaboration progress callbacks
+ */
+struct ElaborationProgress
+{
+    size_t                    nodes_elaborated = 0;
+    std::string               current_path; // Instance currently being elaborated
+    std::chrono::milliseconds elapsed{0};
+};
+
+} // namespace systemrdl
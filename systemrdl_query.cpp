@@ -0,0 +1,526 @@
+#include "systemrdl_query.h"
+
+#include "systemrdl_trace.h"
+#include "systemrdl_version.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+namespace systemrdl {
+
+namespace {
+
+const char QUERY_INDEX_MAGIC[8] = {'S', 'R', 'D', 'L', 'Q', 'I', 'X', '\0'};
+
+// Columns are stored little-endian; on such hosts they are copied as a whole
+bool little_endian_host()
+{
+    const uint16_t probe = 1;
+    unsigned char  first = 0;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Little-endian encoder for the index file
+class Writer
+{
+public:
+    void u8(uint8_t value) { buffer_ += static_cast<char>(value); }
+
+    void u32(uint32_t value)
+    {
+        for (int i = 0; i < 4; i++) {
+            buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void u64(uint64_t value)
+    {
+        for (int i = 0; i < 8; i++) {
+            buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+
+    void str(const std::string &value)
+    {
+        u32(static_cast<uint32_t>(value.size()));
+        buffer_ += value;
+    }
+
+    void raw(const char *data, size_t size) { buffer_.append(data, size); }
+
+    template <typename T> void column(const std::vector<T> &values)
+    {
+        if (little_endian_host() || sizeof(T) == 1) {
+            raw(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+            return;
+        }
+        buffer_.reserve(buffer_.size() + values.size() * sizeof(T));
+        for (const T value : values) {
+            if (sizeof(T) == 1) {
+                u8(static_cast<uint8_t>(value));
+            } else if (sizeof(T) == 4) {
+                u32(static_cast<uint32_t>(value));
+            } else {
+                u64(static_cast<uint64_t>(value));
+            }
+        }
+    }
+
+    const std::string &data() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+// Bounds-checked decoder; throws std::runtime_error on truncated input
+class Reader
+{
+public:
+    explicit Reader(const std::string &data)
+        : data_(data)
+    {}
+
+    uint8_t u8()
+    {
+        need(1);
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint32_t u32()
+    {
+        need(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data_[pos_++])) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t u64()
+    {
+        need(8);
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_++])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string str()
+    {
+        uint32_t size = u32();
+        need(size);
+        std::string value = data_.substr(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    bool bytes_equal(const char *expected, size_t size)
+    {
+        need(size);
+        bool equal = std::memcmp(data_.data() + pos_, expected, size) == 0;
+        pos_ += size;
+        return equal;
+    }
+
+    template <typename T> void column(std::vector<T> &values, size_t count)
+    {
+        if (count > (data_.size() - pos_) / sizeof(T)) {
+            throw std::runtime_error("truncated query index file");
+        }
+        values.resize(count);
+        if (little_endian_host() || sizeof(T) == 1) {
+            std::memcpy(values.data(), data_.data() + pos_, count * sizeof(T));
+            pos_ += count * sizeof(T);
+            return;
+        }
+        for (auto &value : values) {
+            if (sizeof(T) == 1) {
+                value = static_cast<T>(u8());
+            } else if (sizeof(T) == 4) {
+                value = static_cast<T>(u32());
+            } else {
+                value = static_cast<T>(u64());
+            }
+        }
+    }
+
+private:
+    void need(size_t size) const
+    {
+        if (size > data_.size() - pos_) {
+            throw std::runtime_error("truncated query index file");
+        }
+    }
+
+    const std::string &data_;
+    size_t             pos_ = 0;
+};
+
+// '*' matches any run of characters, '?' one character; everything else literally
+bool glob_match(std::string_view pattern, std::string_view text)
+{
+    size_t p    = 0;
+    size_t t    = 0;
+    size_t star = std::string_view::npos;
+    size_t mark = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            p++;
+            t++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = t;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            t = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+// A pattern without '[' also matches the elements of an array: "pcie*" matches "pcie[1]"
+bool name_matches(std::string_view pattern, std::string_view name)
+{
+    if (glob_match(pattern, name)) {
+        return true;
+    }
+    size_t bracket = name.find('[');
+    return bracket != std::string_view::npos && pattern.find('[') == std::string_view::npos
+           && glob_match(pattern, name.substr(0, bracket));
+}
+
+bool is_literal(std::string_view pattern)
+{
+    return pattern.find_first_of("*?") == std::string_view::npos;
+}
+
+} // namespace
+
+QueryIndex::QueryIndex(const FlatModel &flat)
+{
+    trace::Span span("build_query_index", "query");
+
+    const uint32_t rows = static_cast<uint32_t>(flat.size());
+    address_            = flat.address();
+    size_               = flat.size_column();
+    width_              = flat.width();
+    lsb_                = flat.lsb();
+    msb_                = flat.msb();
+    parent_             = flat.parent();
+    kind_               = flat.kind();
+
+    // Sorted name table; the flat model numbers names in first-seen order
+    const auto           &flat_names = flat.names();
+    std::vector<uint32_t> order(flat_names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&flat_names](uint32_t a, uint32_t b) {
+        return flat_names[a] < flat_names[b];
+    });
+    std::vector<uint32_t> renumber(flat_names.size());
+    names_.reserve(flat_names.size());
+    for (uint32_t id = 0; id < order.size(); id++) {
+        renumber[order[id]] = id;
+        names_.push_back(flat_names[order[id]]);
+    }
+    name_.resize(rows);
+    for (uint32_t row = 0; row < rows; row++) {
+        name_[row] = renumber[flat.name()[row]];
+    }
+
+    // Preorder: a subtree ends where the last subtree of its children ends
+    end_.resize(rows);
+    for (uint32_t row = 0; row < rows; row++) {
+        end_[row] = row + 1;
+    }
+    for (uint32_t row = rows; row-- > 1;) {
+        end_[parent_[row]] = std::max(end_[parent_[row]], end_[row]);
+    }
+
+    // Rows of each name, in row order
+    name_offsets_.assign(names_.size() + 1, 0);
+    for (uint32_t row = 0; row < rows; row++) {
+        name_offsets_[name_[row] + 1]++;
+    }
+    std::partial_sum(name_offsets_.begin(), name_offsets_.end(), name_offsets_.begin());
+    name_rows_.resize(rows);
+    std::vector<uint32_t> next(name_offsets_.begin(), name_offsets_.end() - 1);
+    for (uint32_t row = 0; row < rows; row++) {
+        name_rows_[next[name_[row]]++] = row;
+    }
+
+    // Registers, and memories that do not declare registers of their own
+    for (uint32_t row = 0; row < rows; row++) {
+        bool decodes = kind_[row] == FlatModel::REG;
+        if (kind_[row] == FlatModel::MEM) {
+            decodes = std::none_of(
+                kind_.begin() + row + 1, kind_.begin() + end_[row], [](Kind kind) {
+                    return kind == FlatModel::REG;
+                });
+        }
+        if (decodes && size_[row] > 0) {
+            decode_rows_.push_back(row);
+        }
+    }
+    std::stable_sort(decode_rows_.begin(), decode_rows_.end(), [this](uint32_t a, uint32_t b) {
+        return address_[a] < address_[b];
+    });
+    decode_address_.reserve(decode_rows_.size());
+    for (uint32_t row : decode_rows_) {
+        decode_address_.push_back(address_[row]);
+    }
+
+    if (span.active()) {
+        span.add_arg("rows", std::to_string(rows));
+        span.add_arg("names", std::to_string(names_.size()));
+    }
+}
+
+bool QueryIndex::save(const std::string &path, std::string *error) const
+{
+    Writer writer;
+    writer.raw(QUERY_INDEX_MAGIC, sizeof(QUERY_INDEX_MAGIC));
+    writer.u32(FORMAT_VERSION);
+    writer.str(get_version());
+    writer.u32(static_cast<uint32_t>(size()));
+    writer.u32(static_cast<uint32_t>(names_.size()));
+    writer.u32(static_cast<uint32_t>(decode_rows_.size()));
+    for (const auto &name : names_) {
+        writer.str(name);
+    }
+    writer.column(address_);
+    writer.column(size_);
+    writer.column(width_);
+    writer.column(lsb_);
+    writer.column(msb_);
+    writer.column(parent_);
+    writer.column(end_);
+    writer.column(name_);
+    writer.column(kind_);
+    writer.column(name_offsets_);
+    writer.column(name_rows_);
+    writer.column(decode_rows_);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot write query index file: " + path;
+        }
+        return false;
+    }
+    file.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+    return static_cast<bool>(file);
+}
+
+std::unique_ptr<QueryIndex> QueryIndex::load(const std::string &path, std::string *error)
+{
+    trace::Span span("load_query_index", "query");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) {
+            *error = "Cannot open query index file: " + path;
+        }
+        return nullptr;
+    }
+    file.seekg(0, std::ios::end);
+    std::string data(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(&data[0], static_cast<std::streamsize>(data.size()));
+
+    auto index = std::make_unique<QueryIndex>();
+    try {
+        Reader reader(data);
+        if (!reader.bytes_equal(QUERY_INDEX_MAGIC, sizeof(QUERY_INDEX_MAGIC))) {
+            throw std::runtime_error("not a SystemRDL query index");
+        }
+        uint32_t version = reader.u32();
+        if (version != FORMAT_VERSION) {
+            throw std::runtime_error(
+                "unsupported query index format version " + std::to_string(version)
+                + " (expected " + std::to_string(FORMAT_VERSION) + ")");
+        }
+        reader.str(); // Toolkit version that wrote the file, informational only
+
+        const uint32_t rows    = reader.u32();
+        const uint32_t names   = reader.u32();
+        const uint32_t decodes = reader.u32();
+        index->names_.reserve(names);
+        for (uint32_t i = 0; i < names; i++) {
+            index->names_.push_back(reader.str());
+        }
+        reader.column(index->address_, rows);
+        reader.column(index->size_, rows);
+        reader.column(index->width_, rows);
+        reader.column(index->lsb_, rows);
+        reader.column(index->msb_, rows);
+        reader.column(index->parent_, rows);
+        reader.column(index->end_, rows);
+        reader.column(index->name_, rows);
+        reader.column(index->kind_, rows);
+        reader.column(index->name_offsets_, size_t(names) + 1);
+        reader.column(index->name_rows_, rows);
+        reader.column(index->decode_rows_, decodes);
+
+        // Every row reference must stay inside the tables, so queries need no checks
+        for (uint32_t row = 0; row < rows; row++) {
+            const uint32_t parent = index->parent_[row];
+            if ((row == 0 ? parent != NONE : parent >= row) || index->end_[row] <= row
+                || index->end_[row] > rows || index->name_[row] >= names
+                || index->kind_[row] >= FlatModel::KIND_COUNT || index->name_rows_[row] >= rows) {
+                throw std::runtime_error(
+                    "corrupt query index file (row " + std::to_string(row) + ")");
+            }
+        }
+        if (!std::is_sorted(index->name_offsets_.begin(), index->name_offsets_.end())
+            || index->name_offsets_.front() != 0 || index->name_offsets_.back() != rows) {
+            throw std::runtime_error("corrupt query index file (name table)");
+        }
+        for (uint32_t row : index->decode_rows_) {
+            if (row >= rows) {
+                throw std::runtime_error("corrupt query index file (decode table)");
+            }
+            index->decode_address_.push_back(index->address_[row]);
+        }
+    } catch (const std::exception &e) {
+        if (error) {
+            *error = path + ": " + e.what();
+        }
+        return nullptr;
+    }
+
+    if (span.active()) {
+        span.add_arg("rows", std::to_string(index->size()));
+    }
+    return index;
+}
+
+std::string QueryIndex::path(uint32_t row) const
+{
+    std::vector<uint32_t> chain;
+    for (uint32_t up = row; up != NONE; up = parent_[up]) {
+        chain.push_back(up);
+    }
+    std::string result;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!result.empty()) {
+            result += '.';
+        }
+        result += names_[name_[*it]];
+    }
+    return result;
+}
+
+std::pair<uint32_t, uint32_t> QueryIndex::prefix_range(std::string_view prefix) const
+{
+    auto first = std::lower_bound(
+        names_.begin(), names_.end(), prefix, [](const std::string &name, std::string_view key) {
+            return std::string_view(name) < key;
+        });
+    auto last = std::partition_point(first, names_.end(), [prefix](const std::string &name) {
+        return std::string_view(name).substr(0, prefix.size()) == prefix;
+    });
+    return {
+        static_cast<uint32_t>(first - names_.begin()),
+        static_cast<uint32_t>(last - names_.begin())};
+}
+
+void QueryIndex::rows_of(
+    uint32_t name, uint32_t begin, uint32_t end, std::vector<uint32_t> &rows) const
+{
+    auto first = name_rows_.begin() + name_offsets_[name];
+    auto last  = name_rows_.begin() + name_offsets_[name + 1];
+    for (auto it = std::lower_bound(first, last, begin); it != last && *it < end; ++it) {
+        rows.push_back(*it);
+    }
+}
+
+std::vector<uint32_t> QueryIndex::find(std::string_view pattern, uint32_t scope) const
+{
+    const uint32_t begin = scope == NONE ? 0 : scope + 1;
+    const uint32_t end   = scope == NONE ? static_cast<uint32_t>(size()) : end_[scope];
+
+    std::vector<uint32_t> rows;
+    size_t                matched = 0;
+    if (is_literal(pattern)) {
+        auto exact = prefix_range(pattern);
+        if (exact.first < exact.second && names_[exact.first] == pattern) {
+            rows_of(exact.first, begin, end, rows);
+            matched++;
+        }
+        if (pattern.find('[') == std::string_view::npos) {
+            auto elements = prefix_range(std::string(pattern) + "[");
+            for (uint32_t name = elements.first; name < elements.second; name++) {
+                rows_of(name, begin, end, rows);
+                matched++;
+            }
+        }
+    } else {
+        // Only the names sharing the literal prefix of the pattern can match
+        auto range = prefix_range(pattern.substr(0, pattern.find_first_of("*?")));
+        for (uint32_t name = range.first; name < range.second; name++) {
+            if (name_matches(pattern, names_[name])) {
+                rows_of(name, begin, end, rows);
+                matched++;
+            }
+        }
+    }
+    if (matched > 1) {
+        std::sort(rows.begin(), rows.end());
+    }
+    return rows;
+}
+
+std::vector<uint32_t> QueryIndex::find_path(std::string_view path) const
+{
+    size_t                dot  = path.find('.');
+    std::vector<uint32_t> rows = find(path.substr(0, dot));
+    while (dot != std::string_view::npos && !rows.empty()) {
+        path.remove_prefix(dot + 1);
+        dot                      = path.find('.');
+        std::string_view segment = path.substr(0, dot);
+
+        std::vector<uint32_t> children;
+        for (uint32_t row : rows) {
+            if (is_literal(segment)) {
+                for (uint32_t child : find(segment, row)) {
+                    if (parent_[child] == row) {
+                        children.push_back(child);
+                    }
+                }
+            } else {
+                for (uint32_t child = row + 1; child < end_[row]; child = end_[child]) {
+                    if (name_matches(segment, names_[name_[child]])) {
+                        children.push_back(child);
+                    }
+                }
+            }
+        }
+        rows.swap(children);
+    }
+
+    // A name matching at nested levels yields interleaved subtrees
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    return rows;
+}
+
+uint32_t QueryIndex::decode(Address address) const
+{
+    auto it = std::upper_bound(decode_address_.begin(), decode_address_.end(), address);
+    if (it == decode_address_.begin()) {
+        return NONE;
+    }
+    const uint32_t row = decode_rows_[(it - decode_address_.begin()) - 1];
+    return address - address_[row] < size_[row] ? row : NONE;
+}
+
+} // namespace systemrdl
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "systemrdl_flat.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Prebuilt name, path and address index of an elaborated model
+ *
+ * Built once from a model and saved to a file, the index answers name, path
+ * and address queries without parsing or elaborating anything:
+ *
+ * - Names are stored once, sorted, each with the rows carrying it. The sorted
+ *   table is a flattened prefix trie: every prefix is a contiguous range of
+ *   names, found by binary search. A pattern with a literal prefix only
+ *   matches names inside that range; a leading '*' scans the distinct names,
+ *   not the rows.
+ * - Rows are in preorder and each row records where its subtree ends, so the
+ *   model tree itself is the path trie: a subtree is a contiguous row range,
+ *   and "under pcie" is a range check on the rows of each matched name.
+ * - The decode table lists the registers and the memories without registers
+ *   sorted by address; an address is decoded by binary search.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::QueryIndex(*model).save("soc.rdlqx");
+ *
+ * auto index = systemrdl::QueryIndex::load("soc.rdlqx");
+ * for (uint32_t scope : index->find_path("pcie*")) {
+ *     for (uint32_t row : index->find("*_INT_STATUS", scope)) {
+ *         std::cout << index->path(row) << std::endl;
+ *     }
+ * }
+ * uint32_t reg = index->decode(0x40021000);
+ * ```
+ */
+class QueryIndex
+{
+public:
+    // Bumped whenever the file layout changes; other versions are rejected by load()
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t NONE           = FlatModel::NONE;
+
+    using Kind = FlatModel::Kind;
+
+    QueryIndex() = default;
+    explicit QueryIndex(const FlatModel &flat);
+    explicit QueryIndex(const ElaboratedNode &root)
+        : QueryIndex(FlatModel(root))
+    {}
+
+    static std::unique_ptr<QueryIndex> load(const std::string &path, std::string *error = nullptr);
+
+    bool save(const std::string &path, std::string *error = nullptr) const;
+
+    size_t size() const { return kind_.size(); }
+
+    // Row attributes; width, lsb and msb as in FlatModel
+    Kind               kind(uint32_t row) const { return kind_[row]; }
+    Address            address(uint32_t row) const { return address_[row]; }
+    Size               size_of(uint32_t row) const { return size_[row]; }
+    uint32_t           width(uint32_t row) const { return width_[row]; }
+    uint32_t           lsb(uint32_t row) const { return lsb_[row]; }
+    uint32_t           msb(uint32_t row) const { return msb_[row]; }
+    uint32_t           parent(uint32_t row) const { return parent_[row]; }
+    const std::string &name(uint32_t row) const { return names_[name_[row]]; }
+
+    // One past the last row of the subtree of row
+    uint32_t subtree_end(uint32_t row) const { return end_[row]; }
+
+    // Dotted instance path of a row, e.g. "soc.pcie[1].MSI_INT_STATUS"
+    std::string path(uint32_t row) const;
+
+    /**
+     * @brief Rows whose instance name matches a glob pattern, in row order
+     *
+     * '*' matches any run of characters and '?' one character. Array
+     * elements are named like "EP_INT_STATUS[2]"; a pattern without '['
+     * matches every element. With a scope row only the rows strictly inside
+     * its subtree are returned.
+     */
+    std::vector<uint32_t> find(std::string_view pattern, uint32_t scope = NONE) const;
+
+    /**
+     * @brief Rows at a dotted path whose segments are glob patterns
+     *
+     * The path may start at any level: "pcie*.CTRL" matches soc.pcie[0].CTRL
+     * and soc.pcie[1].CTRL, and a path starting at the root matches only there.
+     */
+    std::vector<uint32_t> find_path(std::string_view path) const;
+
+    // Register (or memory without registers) whose address range contains address, else NONE
+    uint32_t decode(Address address) const;
+
+private:
+    // Range of sorted names starting with prefix
+    std::pair<uint32_t, uint32_t> prefix_range(std::string_view prefix) const;
+
+    // Rows of a name inside [begin, end), appended in row order
+    void rows_of(uint32_t name, uint32_t begin, uint32_t end, std::vector<uint32_t> &rows) const;
+
+    std::vector<Address>  address_;
+    std::vector<Size>     size_;
+    std::vector<uint32_t> width_;
+    std::vector<uint32_t> lsb_;
+    std::vector<uint32_t> msb_;
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> end_;
+    std::vector<uint32_t> name_;
+    std::vector<Kind>     kind_;
+
+    // Sorted names; the rows of names_[i] are name_rows_[name_offsets_[i], name_offsets_[i + 1])
+    std::vector<std::string> names_;
+    std::vector<uint32_t>    name_offsets_;
+    std::vector<uint32_t>    name_rows_;
+
+    // Decode table: rows and their start addresses, sorted by address
+    std::vector<uint32_t> decode_rows_;
+    std::vector<Address>  decode_address_;
+};
+
+} // namespace systemrdl
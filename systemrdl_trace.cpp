@@ -0,0 +1,263 @@
+#include "systemrdl_trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace systemrdl {
+namespace trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{false};
+} // namespace detail
+
+namespace {
+
+struct Event
+{
+    const char                                       *name;
+    const char                                       *category;
+    int64_t                                           start_ns;
+    int64_t                                           duration_ns;
+    std::vector<std::pair<const char *, std::string>> args;
+};
+
+// Events belong to the recording started with the generation they carry. Only the
+// owning thread clears its buffer, when it records into a newer generation.
+struct ThreadBuffer
+{
+    uint32_t           tid        = 0;
+    uint64_t           generation = 0;
+    std::thread::id    thread_id;
+    std::vector<Event> events;
+};
+
+// Owns every per-thread buffer. Buffers outlive their threads so spans from
+// short-lived worker threads are still available when the trace is written.
+struct Registry
+{
+    std::mutex                                 mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::thread::id                            main_thread;
+    std::atomic<uint64_t>                      generation{0}; // Bumped by every start()
+};
+
+// Buffers holding events of the current recording
+bool is_current(const Registry &reg, const ThreadBuffer &buffer)
+{
+    return buffer.generation == reg.generation.load(std::memory_order_acquire);
+}
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+const std::chrono::steady_clock::time_point &epoch()
+{
+    static const auto instance = std::chrono::steady_clock::now();
+    return instance;
+}
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - epoch())
+        .count();
+}
+
+ThreadBuffer &local_buffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        Registry                   &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer      = reg.buffers.back().get();
+        buffer->tid       = static_cast<uint32_t>(reg.buffers.size());
+        buffer->thread_id = std::this_thread::get_id();
+    }
+    return *buffer;
+}
+
+void write_json_string(std::ostream &out, const char *text)
+{
+    out << '"';
+    for (const char *p = text; *p != '\0'; ++p) {
+        const char c = *p;
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+// Trace-event timestamps are microseconds; keep sub-microsecond precision
+void write_micros(std::ostream &out, int64_t ns)
+{
+    out << (ns / 1000) << '.';
+    const int64_t frac = ns % 1000;
+    if (frac < 100) {
+        out << '0';
+    }
+    if (frac < 10) {
+        out << '0';
+    }
+    out << frac;
+}
+
+} // namespace
+
+void start()
+{
+    // Other threads' buffers are not touched: their events go stale and each thread drops
+    // them itself when it next records
+    Registry &reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.main_thread = std::this_thread::get_id();
+        reg.generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+    epoch();
+    detail::g_enabled.store(true, std::memory_order_release);
+}
+
+void stop()
+{
+    detail::g_enabled.store(false, std::memory_order_release);
+}
+
+size_t event_count()
+{
+    Registry                   &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t                      count = 0;
+    for (const auto &buffer : reg.buffers) {
+        if (is_current(reg, *buffer)) {
+            count += buffer->events.size();
+        }
+    }
+    return count;
+}
+
+void write(std::ostream &output)
+{
+    Registry                   &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto &buffer : reg.buffers) {
+        if (buffer->events.empty() || !is_current(reg, *buffer)) {
+            continue;
+        }
+        output << (first ? "\n" : ",\n");
+        first = false;
+        output << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+               << ",\"args\":{\"name\":\""
+               << (buffer->thread_id == reg.main_thread ? "main" : "worker") << "-" << buffer->tid
+               << "\"}}";
+
+        for (const auto &event : buffer->events) {
+            output << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"name\":";
+            write_json_string(output, event.name);
+            output << ",\"cat\":";
+            write_json_string(output, event.category);
+            output << ",\"ts\":";
+            write_micros(output, event.start_ns);
+            output << ",\"dur\":";
+            write_micros(output, event.duration_ns);
+            if (!event.args.empty()) {
+                output << ",\"args\":{";
+                for (size_t i = 0; i < event.args.size(); ++i) {
+                    if (i > 0) {
+                        output << ',';
+                    }
+                    write_json_string(output, event.args[i].first);
+                    output << ':';
+                    write_json_string(output, event.args[i].second.c_str());
+                }
+                output << '}';
+            }
+            output << '}';
+        }
+    }
+    output << "\n]}\n";
+}
+
+bool write_file(const std::string &filename)
+{
+    std::ofstream output(filename);
+    if (!output.is_open()) {
+        return false;
+    }
+    write(output);
+    return static_cast<bool>(output);
+}
+
+Session::Session(std::string filename)
+    : filename_(std::move(filename))
+{
+    if (!filename_.empty()) {
+        start();
+    }
+}
+
+Session::~Session()
+{
+    finish();
+}
+
+bool Session::finish()
+{
+    if (filename_.empty() || finished_) {
+        return true;
+    }
+    finished_ = true;
+    stop();
+    return write_file(filename_);
+}
+
+void Span::begin(const char *name, const char *category)
+{
+    name_     = name;
+    category_ = category;
+    start_ns_ = now_ns();
+}
+
+void Span::end()
+{
+    const int64_t  end_ns     = now_ns();
+    ThreadBuffer  &buffer     = local_buffer();
+    const uint64_t generation = registry().generation.load(std::memory_order_acquire);
+    if (buffer.generation != generation) {
+        buffer.events.clear();
+        buffer.generation = generation;
+    }
+    buffer.events.push_back(
+        Event{name_, category_, start_ns_, end_ns - start_ns_, std::move(args_)});
+}
+
+} // namespace trace
+} // namespace systemrdl
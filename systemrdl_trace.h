@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace systemrdl {
+
+/**
+ * @brief Pipeline profiling in Chrome/Perfetto trace-event format
+ *
+ * Spans are recorded into per-thread buffers. Each thread appends only to its
+ * own buffer, so recording takes no locks; the global registry is touched once
+ * per thread when its buffer is created. The resulting file can be opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @example
+ * ```cpp
+ * systemrdl::trace::start();
+ * auto result = systemrdl::file::elaborate("design.rdl");
+ * systemrdl::trace::stop();
+ * systemrdl::trace::write_file("trace.json");
+ * ```
+ */
+namespace trace {
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+} // namespace detail
+
+/**
+ * @brief Check whether span recording is active (cheap, safe to call from hot paths)
+ */
+inline bool enabled()
+{
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Discard previously recorded spans and start recording
+ *
+ * Spans of the previous recording are dropped by each thread the next time it
+ * records, so start() never touches a buffer another thread is appending to.
+ */
+void start();
+
+/**
+ * @brief Stop recording; recorded spans are kept until the next start()
+ */
+void stop();
+
+/**
+ * @brief Number of spans recorded across all threads
+ *
+ * Only meaningful once recording threads are idle (e.g. after stop()).
+ */
+size_t event_count();
+
+/**
+ * @brief Write recorded spans as a Chrome trace-event JSON document
+ *
+ * Must be called once recording threads are idle (e.g. after stop()).
+ */
+void write(std::ostream &output);
+
+/**
+ * @brief Write recorded spans to a file
+ * @return true on success, false if the file cannot be written
+ */
+bool write_file(const std::string &filename);
+
+/**
+ * @brief Records a trace for the lifetime of the object and writes it to a file
+ *
+ * Intended for command line tools: the trace is written on every exit path.
+ * An empty filename disables tracing entirely.
+ */
+class Session
+{
+public:
+    explicit Session(std::string filename);
+    ~Session();
+
+    Session(const Session &)            = delete;
+    Session &operator=(const Session &) = delete;
+
+    /**
+     * @brief Stop recording and write the trace file now
+     * @return true if the file was written (or tracing is disabled)
+     */
+    bool finish();
+
+    const std::string &filename() const { return filename_; }
+
+private:
+    std::string filename_;
+    bool        finished_ = false;
+};
+
+/**
+ * @brief RAII span covering the lifetime of the object
+ *
+ * Name and category must be string literals (or otherwise outlive the trace).
+ * Arguments are only worth computing when active() returns true. Passing
+ * record = false turns the span into a no-op, for call sites that only want
+ * to trace some of their invocations.
+ */
+class Span
+{
+public:
+    Span(const char *name, const char *category, bool record = true)
+        : active_(record && enabled())
+    {
+        if (active_) {
+            begin(name, category);
+        }
+    }
+
+    ~Span()
+    {
+        if (active_) {
+            end();
+        }
+    }
+
+    Span(const Span &)            = delete;
+    Span &operator=(const Span &) = delete;
+
+    bool active() const { return active_; }
+
+    void add_arg(const char *key, std::string value)
+    {
+        if (active_) {
+            args_.emplace_back(key, std::move(value));
+        }
+    }
+
+private:
+    void begin(const char *name, const char *category);
+    void end();
+
+    bool                                             active_;
+    const char                                      *name_     = nullptr;
+    const char                                      *category_ = nullptr;
+    int64_t                                          start_ns_ = 0;
+    std::vector<std::pair<const char *, std::string>> args_;
+};
+
+} // namespace trace
+
+} // namespace systemrdl
@@ -0,0 +1,147 @@
+// Unit test of the FlatModel columns on a hand-built tree; no RDL is parsed
+#include "systemrdl_flat.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace systemrdl;
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(condition)                                                                          \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": EXPECT(" #condition ") failed"          \
+                      << std::endl;                                                                \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (0)
+
+template <typename Node>
+Node *add_node(ElaboratedNode &parent, const std::string &name, Address address, Size size)
+{
+    auto node              = std::make_unique<Node>();
+    node->inst_name        = name;
+    node->absolute_address = address;
+    node->size             = size;
+    Node *raw              = node.get();
+    parent.add_child(std::move(node));
+    return raw;
+}
+
+ElaboratedField *add_field(ElaboratedReg &reg, const std::string &name, size_t msb, size_t lsb)
+{
+    auto field   = add_node<ElaboratedField>(reg, name, reg.absolute_address, 0);
+    field->msb   = msb;
+    field->lsb   = lsb;
+    field->width = msb - lsb + 1;
+    return field;
+}
+
+// Row r's subtree is the rows that have r as an ancestor
+bool in_subtree(const FlatModel &flat, uint32_t row, uint32_t root)
+{
+    for (uint32_t up = row; up != FlatModel::NONE; up = flat.parent()[up]) {
+        if (up == root) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    // top
+    //   blk  (regfile @ 0x100)
+    //     ctrl (reg @ 0x100): en[0:0], mode[3:1]
+    //   ctrl (reg @ 0x0): en[0:0]
+    //   buf  (mem @ 0x1000)
+    ElaboratedAddrmap top;
+    top.inst_name = "top";
+    top.size      = 0x2000;
+
+    auto blk      = add_node<ElaboratedRegfile>(top, "blk", 0x100, 4);
+    auto blk_ctrl = add_node<ElaboratedReg>(*blk, "ctrl", 0x100, 4);
+    auto blk_en   = add_field(*blk_ctrl, "en", 0, 0);
+    auto blk_mode = add_field(*blk_ctrl, "mode", 3, 1);
+    auto ctrl     = add_node<ElaboratedReg>(top, "ctrl", 0x0, 4);
+    auto ctrl_en  = add_field(*ctrl, "en", 0, 0);
+    auto buf      = add_node<ElaboratedMem>(top, "buf", 0x1000, 0x1000);
+
+    blk_en->sw_access     = ElaboratedField::R;
+    blk_mode->reset_value = 5;
+    ctrl_en->sw_access    = ElaboratedField::W;
+    buf->data_width       = 64;
+
+    FlatModel flat(top);
+
+    // Rows are the nodes in preorder
+    EXPECT(flat.size() == 8);
+    const std::vector<FlatModel::Kind> kinds = {
+        FlatModel::ADDRMAP,
+        FlatModel::REGFILE,
+        FlatModel::REG,
+        FlatModel::FIELD,
+        FlatModel::FIELD,
+        FlatModel::REG,
+        FlatModel::FIELD,
+        FlatModel::MEM};
+    EXPECT(flat.kind() == kinds);
+    EXPECT((flat.address()
+            == std::vector<Address>{0x0, 0x100, 0x100, 0x100, 0x100, 0x0, 0x0, 0x1000}));
+
+    // Parent column: the root has none, every other row points at an earlier row
+    const uint32_t NONE = FlatModel::NONE;
+    EXPECT((flat.parent() == std::vector<uint32_t>{NONE, 0, 1, 2, 2, 0, 5, 0}));
+
+    // Subtrees are contiguous row ranges starting at their root
+    for (uint32_t root = 0; root < flat.size(); root++) {
+        uint32_t end = root + 1;
+        while (end < flat.size() && in_subtree(flat, end, root)) {
+            end++;
+        }
+        for (uint32_t row = end; row < flat.size(); row++) {
+            EXPECT(!in_subtree(flat, row, root));
+        }
+    }
+    EXPECT(in_subtree(flat, 4, 1) && !in_subtree(flat, 5, 1));
+    EXPECT(in_subtree(flat, 6, 5) && !in_subtree(flat, 7, 5));
+
+    // Name column: repeated instance names share one entry of the name table
+    EXPECT(flat.names().size() == 6);
+    EXPECT(flat.name()[2] == flat.name()[5]);
+    EXPECT(flat.name()[3] == flat.name()[6]);
+    EXPECT(flat.name_of(4) == "mode");
+    EXPECT(flat.name_of(7) == "buf");
+    EXPECT(flat.path(4) == "top.blk.ctrl.mode");
+    EXPECT(flat.path(6, "/") == "top/ctrl/en");
+    EXPECT(flat.path(0) == "top");
+
+    // Per-kind columns
+    EXPECT(flat.lsb()[4] == 1 && flat.msb()[4] == 3 && flat.width()[4] == 3);
+    EXPECT(flat.reset()[4] == 5);
+    EXPECT(flat.width()[2] == 32 && flat.width()[7] == 64);
+    EXPECT(flat.sw()[3] == ElaboratedField::R && flat.sw()[6] == ElaboratedField::W);
+    EXPECT(flat.sw()[2] == ElaboratedField::NA);
+
+    // Scans
+    EXPECT((flat.select(FlatModel::REG) == std::vector<uint32_t>{2, 5}));
+    EXPECT((flat.sorted_by_address(flat.select(FlatModel::REG)) == std::vector<uint32_t>{5, 2}));
+    EXPECT((flat.select_address_range(FlatModel::FIELD, 0x100, 0x1000)
+            == std::vector<uint32_t>{3, 4}));
+    EXPECT(flat.count(FlatModel::FIELD) == 3);
+    EXPECT(flat.width_histogram(FlatModel::FIELD)[1] == 2);
+
+    if (failures > 0) {
+        std::cerr << failures << " FlatModel check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[OK] FlatModel columns" << std::endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Lazy elaboration must lay out a design exactly like eager elaboration, including instances
+// placed after a deferred register file
+#include "SystemRDLLexer.h"
+#include "SystemRDLParser.h"
+#include "antlr4-runtime.h"
+#include "elaborator.h"
+
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace antlr4;
+using namespace systemrdl;
+
+namespace {
+
+const char *const DESIGN = R"(
+reg reg_t {
+    field { sw = rw; } data[31:0] = 0;
+};
+
+regfile regfile_t {
+    reg_t r0 @ 0x0;
+    reg_t r1 @ 0x8;
+    reg_t r2 @ 0x10;
+};
+
+regfile outer_t {
+    regfile_t inner @ 0x20;
+};
+
+addrmap top {
+    regfile_t rf @ 0x100;
+    reg_t     after;
+    outer_t   outer;
+    reg_t     last;
+    regfile_t rf_arr[2] @ 0x200 += 0x20;
+    reg_t     tail;
+};
+)";
+
+using Row = std::tuple<std::string, Address, Size>;
+
+void collect(ElaboratedNode &node, std::vector<Row> &rows)
+{
+    rows.emplace_back(node.get_hierarchical_path(), node.absolute_address, node.size);
+    for (auto &child : node.children) {
+        collect(*child, rows);
+    }
+}
+
+void materialize_subtree(LazyElaboratedModel &model, ElaboratedNode &node)
+{
+    model.materialize(&node);
+    for (auto &child : node.children) {
+        materialize_subtree(model, *child);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    ANTLRInputStream  input(DESIGN);
+    SystemRDLLexer    lexer(&input);
+    CommonTokenStream tokens(&lexer);
+    SystemRDLParser   parser(&tokens);
+    auto              tree = parser.root();
+
+    SystemRDLElaborator eager;
+    auto                eager_root = eager.elaborate(tree);
+    if (!eager_root || eager.has_errors()) {
+        std::cerr << "Eager elaboration failed" << std::endl;
+        return 1;
+    }
+
+    LazyElaboratedModel lazy;
+    if (!lazy.open(tree)) {
+        std::cerr << "Lazy elaboration failed" << std::endl;
+        return 1;
+    }
+
+    // Array elements do not move their siblings and stay deferred until they are needed
+    int failures = 0;
+    for (auto &child : lazy.root()->children) {
+        if (child->inst_name == "rf_arr[0]" && lazy.is_materialized(child.get())) {
+            std::cerr << "top.rf_arr[0] was not deferred" << std::endl;
+            failures++;
+        }
+    }
+    materialize_subtree(lazy, *lazy.root());
+    for (const auto &error : lazy.get_errors()) {
+        std::cerr << "Lazy: " << error.message << std::endl;
+    }
+
+    std::vector<Row> eager_rows;
+    std::vector<Row> lazy_rows;
+    collect(*eager_root, eager_rows);
+    collect(*lazy.root(), lazy_rows);
+
+    failures += lazy.get_errors().empty() ? 0 : 1;
+    if (eager_rows.size() != lazy_rows.size()) {
+        std::cerr << eager_rows.size() << " eager nodes, " << lazy_rows.size() << " lazy nodes"
+                  << std::endl;
+        failures++;
+    }
+    for (size_t i = 0; i < eager_rows.size() && i < lazy_rows.size(); i++) {
+        if (eager_rows[i] != lazy_rows[i]) {
+            std::cerr << std::hex << std::get<0>(eager_rows[i]) << " @ 0x"
+                      << std::get<1>(eager_rows[i]) << " size 0x" << std::get<2>(eager_rows[i])
+                      << " eagerly, " << std::get<0>(lazy_rows[i]) << " @ 0x"
+                      << std::get<1>(lazy_rows[i]) << " size 0x" << std::get<2>(lazy_rows[i])
+                      << " lazily" << std::dec << std::endl;
+            failures++;
+        }
+    }
+
+    // The register after the 0x14-byte register file follows its real end
+    for (const auto &row : eager_rows) {
+        if (std::get<0>(row) == "top.after" && std::get<1>(row) != 0x114) {
+            std::cerr << "top.after is not at 0x114" << std::endl;
+            failures++;
+        }
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " lazy layout check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[OK] Lazy layout matches eager layout (" << eager_rows.size() << " nodes)"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Streaming elaboration must apply dynamic assignments of enclosing bodies to registers before
+// they are released, giving the sink the registers eager elaboration produces
+#include "SystemRDLLexer.h"
+#include "SystemRDLParser.h"
+#include "antlr4-runtime.h"
+#include "elaborator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace antlr4;
+using namespace systemrdl;
+
+namespace {
+
+const char *const DESIGN = R"(
+reg ctrl_t {
+    field { sw = rw; hw = r; } enable[0:0] = 0;
+    field { sw = rw; hw = r; } mode[3:1] = 0;
+
+    enable->desc = "Block enable";
+};
+
+regfile chan_t {
+    ctrl_t ctrl   @ 0x0;
+    ctrl_t status @ 0x4;
+
+    // Register file body, overridden by the address map body for ctrl.enable
+    ctrl.enable->reset = 0;
+    status->desc       = "Channel status";
+};
+
+regfile group_t {
+    chan_t chan[2] @ 0x0 += 0x10;
+    chan[1].status.mode->reset = 3;
+};
+
+addrmap top {
+    chan_t  chan[4] @ 0x0 += 0x10;
+    group_t group   @ 0x100;
+    ctrl_t  top_ctrl @ 0x200;
+
+    chan.ctrl.enable->reset       = 1;
+    chan[2].status.mode->reset    = 5;
+    chan[3].ctrl->desc            = "Last channel control";
+    group.chan[0].ctrl->desc      = "Nested channel control";
+    group.chan.status.enable->sw  = r;
+
+    late.mode->sw = r;
+    ctrl_t late @ 0x204;
+
+    top_ctrl.enable->desc = "Top-level enable";
+    group->desc           = "Channel group";
+};
+)";
+
+// One line per register and field: path, reset and properties by name
+std::string describe(ElaboratedNode &node)
+{
+    std::map<std::string, std::string> properties;
+    for (const auto &[name, value] : node.properties) {
+        properties[name] = value.type == PropertyValue::INTEGER ? std::to_string(value.int_val)
+                           : value.type == PropertyValue::BOOLEAN
+                               ? std::string(value.bool_val ? "true" : "false")
+                               : value.string_val;
+    }
+    std::string line = node.get_hierarchical_path();
+    if (auto reg = dynamic_cast<ElaboratedReg *>(&node)) {
+        line += " reset=" + reg->register_reset_hex;
+    }
+    for (const auto &[name, value] : properties) {
+        line += " " + name + "=" + value;
+    }
+    return line;
+}
+
+void describe_register(ElaboratedReg &reg, std::vector<std::string> &lines)
+{
+    lines.push_back(describe(reg));
+    for (auto &field : reg.children) {
+        lines.push_back(describe(*field));
+    }
+}
+
+class RegisterSink : public ElaboratedNodeVisitor
+{
+public:
+    std::vector<std::string> lines;
+
+    void visit(ElaboratedAddrmap &) override {}
+    void visit(ElaboratedRegfile &) override {}
+    void visit(ElaboratedReg &node) override { describe_register(node, lines); }
+    void visit(ElaboratedField &) override {}
+    void visit(ElaboratedMem &) override {}
+};
+
+void collect(ElaboratedNode &node, std::vector<std::string> &lines)
+{
+    if (auto reg = dynamic_cast<ElaboratedReg *>(&node)) {
+        describe_register(*reg, lines);
+        return;
+    }
+    for (auto &child : node.children) {
+        collect(*child, lines);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    ANTLRInputStream  input(DESIGN);
+    SystemRDLLexer    lexer(&input);
+    CommonTokenStream tokens(&lexer);
+    SystemRDLParser   parser(&tokens);
+    auto              tree = parser.root();
+
+    SystemRDLElaborator eager;
+    auto                eager_root = eager.elaborate(tree);
+    if (!eager_root || eager.has_errors()) {
+        std::cerr << "Eager elaboration failed" << std::endl;
+        return 1;
+    }
+
+    RegisterSink                 sink;
+    SystemRDLElaborator::Options options;
+    options.stream_sink = &sink;
+    SystemRDLElaborator streaming;
+    streaming.set_options(options);
+    auto streamed_root = streaming.elaborate(tree);
+    for (const auto &error : streaming.get_errors()) {
+        std::cerr << "Streaming: " << error.message << std::endl;
+    }
+    if (!streamed_root || streaming.has_errors()) {
+        std::cerr << "Streaming elaboration failed" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> eager_lines;
+    collect(*eager_root, eager_lines);
+    std::sort(eager_lines.begin(), eager_lines.end());
+    std::sort(sink.lines.begin(), sink.lines.end());
+
+    int failures = 0;
+    for (const auto &line : eager_lines) {
+        if (!std::binary_search(sink.lines.begin(), sink.lines.end(), line)) {
+            std::cerr << "Eager only:     " << line << std::endl;
+            failures++;
+        }
+    }
+    for (const auto &line : sink.lines) {
+        if (!std::binary_search(eager_lines.begin(), eager_lines.end(), line)) {
+            std::cerr << "Streaming only: " << line << std::endl;
+            failures++;
+        }
+    }
+
+    // The enclosing address map body wins over the register file body
+    const std::string overridden = "top.chan[0].ctrl.enable";
+    bool              found      = false;
+    for (const auto &line : sink.lines) {
+        if (line.compare(0, overridden.size() + 1, overridden + " ") == 0) {
+            found = true;
+            if (line.find(" reset=1") == std::string::npos) {
+                std::cerr << overridden << " does not have reset 1: " << line << std::endl;
+                failures++;
+            }
+        }
+    }
+    if (!found) {
+        std::cerr << overridden << " was not streamed" << std::endl;
+        failures++;
+    }
+
+    if (failures > 0) {
+        std::cerr << failures << " streamed register(s) differ" << std::endl;
+        return 1;
+    }
+    std::cout << "[OK] Streamed registers match eager elaboration (" << eager_lines.size()
+              << " registers and fields)" << std::endl;
+    return 0;
+}